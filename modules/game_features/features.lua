@@ -5,6 +5,7 @@ controller:registerEvents(g_game, {
         -- g_game.enableFeature(GameNegativeOffset)
         -- g_game.enableFeature(GameWingsAurasEffectsShader)
         -- g_game.enableFeature(GameAllowCustomBotScripts)
+        -- g_game.enableFeature(GamePacketCompression) -- servers reading the flag after the login challenge
 
         g_game.enableFeature(GameFormatCreatureName)
 
@@ -218,6 +218,7 @@ GameAllowPreWalk = 122
 GamePlayerFamiliars = 123
 GameLatencyAdaptiveCamera = 124
 GameMapCache = 125
+GamePacketCompression = 126
 
 TextColors = {
     red = '#f55e5e',    -- '#c83200'
@@ -334,7 +335,9 @@ PathFindFlags = {
     AllowNullTiles = 1,
     AllowCreatures = 2,
     AllowNonPathable = 4,
-    AllowNonWalkable = 8
+    AllowNonWalkable = 8,
+    IgnoreCreatures = 16,
+    JumpPoints = 32
 }
 
 VipState = {
@@ -26,8 +26,10 @@ const std::optional<BanInfo> IOBan::getAccountBanInfo(uint32_t accountId)
 		g_databaseTasks.addTask(fmt::format(
 		    "INSERT INTO `account_ban_history` (`account_id`, `reason`, `banned_at`, `expired_at`, `banned_by`) VALUES ({:d}, {:s}, {:d}, {:d}, {:d})",
 		    accountId, db.escapeString(result->getString("reason")), result->getNumber<time_t>("banned_at"), expiresAt,
-		    result->getNumber<uint32_t>("banned_by")));
-		g_databaseTasks.addTask(fmt::format("DELETE FROM `account_bans` WHERE `account_id` = {:d}", accountId));
+		    result->getNumber<uint32_t>("banned_by")),
+		    nullptr, false, getDatabaseOrderKey(DATABASE_ORDER_ACCOUNT, accountId));
+		g_databaseTasks.addTask(fmt::format("DELETE FROM `account_bans` WHERE `account_id` = {:d}", accountId), nullptr,
+		                        false, getDatabaseOrderKey(DATABASE_ORDER_ACCOUNT, accountId));
 		return std::nullopt;
 	}
 
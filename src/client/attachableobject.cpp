@@ -50,6 +50,7 @@ void AttachableObject::attachEffect(const AttachedEffectPtr& obj)
         return;
 
     onStartAttachEffect(obj);
+    onLiveChange();
 
     if (obj->isHidedOwner())
         ++m_ownerHidden;
@@ -178,6 +179,7 @@ void AttachableObject::attachParticleEffect(const std::string& name)
         return;
 
     getData()->attachedParticles.emplace_back(effect);
+    onLiveChange();
 }
 
 void AttachableObject::clearAttachedParticlesEffect()
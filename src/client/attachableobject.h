@@ -46,6 +46,8 @@ public:
     AttachedEffectPtr getAttachedEffectById(uint16_t id);
 
     virtual void onStartAttachEffect(const AttachedEffectPtr& /*effect*/) {};
+    // it started to change from one frame to the next by itself, the map views draw it again every frame
+    virtual void onLiveChange() {}
     virtual void onDispatcherAttachEffect(const AttachedEffectPtr& /*effect*/) {};
     virtual void onStartDetachEffect(const AttachedEffectPtr& /*effect*/) {};
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "clientchecks.h"
+#include "mapviewcheck.h"
+#include "pathfindcheck.h"
+#include "walkcheck.h"
+
+#include <framework/graphics/atlaspackercheck.h>
+#include <framework/graphics/drawpoolbenchmark.h>
+#include <framework/graphics/drawpoolcheck.h>
+#include <framework/graphics/particlebenchmark.h>
+#include <framework/graphics/particlemanager.h>
+#include <framework/ui/uistylebenchmark.h>
+
+namespace
+{
+    using Arguments = std::vector<std::string>;
+
+    struct Check
+    {
+        std::string_view name;
+        std::string_view usage;
+        size_t arguments;
+        bool (*run)(const Arguments& args);
+    };
+
+    int toInt(const std::string& value) { return stdext::unsafe_cast<int>(value); }
+
+    const std::array<Check, 8> checks{ {
+        { "particle-benchmark", "<particles file> <effect> <steps>", 3, [](const Arguments& args) {
+            return g_particles.importParticle(args[0]) && ParticleBenchmark().run(args[1], toInt(args[2]));
+        } },
+        { "drawpool-benchmark", "<frames>", 1, [](const Arguments& args) { return DrawPoolBenchmark().run(toInt(args[0])); } },
+        { "drawpool-check", "", 0, [](const Arguments&) { return DrawPoolCheck().run(); } },
+        { "uistyle-benchmark", "<flips>", 1, [](const Arguments& args) { return UIStyleBenchmark().run(toInt(args[0])); } },
+        { "walk-check", "<creatures> <seconds>", 2, [](const Arguments& args) { return WalkCheck().run(toInt(args[0]), toInt(args[1])); } },
+        { "atlaspacker-check", "<operations>", 1, [](const Arguments& args) { return AtlasPackerCheck().run(toInt(args[0])); } },
+        { "pathfind-check", "<grids> <seed>", 2, [](const Arguments& args) { return PathFindCheck().run(toInt(args[0]), toInt(args[1])); } },
+        { "mapview-check", "<frames> <seed>", 2, [](const Arguments& args) { return MapViewCheck().run(toInt(args[0]), toInt(args[1])); } },
+    } };
+
+    auto findCheckArgument(const std::vector<std::string>& args) { return std::find(args.begin(), args.end(), "--check"); }
+}
+
+bool ClientChecks::requested(const std::vector<std::string>& args) { return findCheckArgument(args) != args.end(); }
+
+int ClientChecks::run(const std::vector<std::string>& args)
+{
+    const auto it = findCheckArgument(args);
+    const std::string_view name = std::distance(it, args.end()) >= 2 ? std::string_view(*(it + 1)) : std::string_view();
+
+    const auto check = std::ranges::find(checks, name, &Check::name);
+    if (check == checks.end()) {
+        g_logger.error("Unknown check '{}', the checks are:", name);
+        for (const auto& [checkName, usage, arguments, run] : checks)
+            g_logger.error("  --check {} {}", checkName, usage);
+        return 2;
+    }
+
+    const Arguments checkArgs(it + 2, args.end());
+    if (checkArgs.size() < check->arguments) {
+        g_logger.error("Usage: --check {} {}", check->name, check->usage);
+        return 2;
+    }
+
+    return check->run(checkArgs) ? 0 : 1;
+}
@@ -560,6 +560,7 @@ namespace Otc
         GamePlayerFamiliars = 123,
         GameLatencyAdaptiveCamera = 124,
         GameMapCache = 125,
+        GamePacketCompression = 126,
         LastGameFeature
     };
 
@@ -590,7 +591,8 @@ namespace Otc
         PathFindAllowCreatures = 2,
         PathFindAllowNonPathable = 4,
         PathFindAllowNonWalkable = 8,
-        PathFindIgnoreCreatures = 16
+        PathFindIgnoreCreatures = 16,
+        PathFindJumpPoints = 32
     };
 
     enum AutomapFlags : uint8_t
@@ -404,6 +404,9 @@ void Creature::walk(const Position& oldPos, const Position& newPos)
         m_walkFinishAnimEvent = nullptr;
     }
 
+    // the walk animation takes over from the static one
+    m_staticWalking = false;
+
     // starts updating walk
     nextWalkUpdate();
 }
@@ -643,22 +646,13 @@ void Creature::updateWalkingTile()
 
 void Creature::nextWalkUpdate()
 {
-    // remove any previous scheduled walk updates
-    if (m_walkUpdateEvent)
-        m_walkUpdateEvent->cancel();
-
     // do the update
     updateWalk();
     onWalking();
 
-    if (!m_walking) return;
-
-    auto action = [self = static_self_cast<Creature>()] {
-        self->m_walkUpdateEvent = nullptr;
-        self->nextWalkUpdate();
-    };
-
-    m_walkUpdateEvent = isCameraFollowing() ? g_dispatcher.addEvent(action) : g_dispatcher.scheduleEvent(action, m_stepCache.walkDuration);
+    // the next ones are done by the map, with every other walking creature
+    if (m_walking)
+        g_map.scheduleWalkUpdate(static_self_cast<Creature>());
 }
 
 void Creature::updateWalk()
@@ -689,11 +683,8 @@ void Creature::updateWalk()
 
 void Creature::terminateWalk()
 {
-    // remove any scheduled walk update
-    if (m_walkUpdateEvent) {
-        m_walkUpdateEvent->cancel();
-        m_walkUpdateEvent = nullptr;
-    }
+    // the map stops updating it on its next pass
+    m_staticWalking = false;
 
     // now the walk has ended, do any scheduled turn
     if (m_walkTurnDirection != Otc::InvalidDirection) {
@@ -954,8 +945,6 @@ uint16_t Creature::getStepDuration(const bool ignoreDiagonal, const Otc::Directi
 
         m_stepCache.duration = stepDuration;
 
-        m_stepCache.walkDuration = std::min<int>(stepDuration / g_gameConfig.getSpriteSize(), DrawPool::FPS60);
-
         m_stepCache.diagonalDuration = stepDuration *
             (g_game.getClientVersion() > 810 || g_gameConfig.isForcingNewWalkingFormula()
                 ? (isPlayer() ? g_gameConfig.getPlayerDiagonalWalkSpeed() : g_gameConfig.getCreatureDiagonalWalkSpeed())
@@ -1135,27 +1124,19 @@ void Creature::onStartDetachEffect(const AttachedEffectPtr& effect) {
 }
 
 void Creature::setStaticWalking(const uint16_t v) {
-    if (!canDraw())
+    // stopping it needs no drawing
+    if (v > 0 && !canDraw())
         return;
 
-    if (m_walkUpdateEvent) {
-        m_walkUpdateEvent->cancel();
-        m_walkUpdateEvent = nullptr;
-    }
-
     m_walkingAnimationSpeed = v;
+    m_staticWalking = v > 0;
 
-    if (v == 0) {
+    if (!m_staticWalking) {
         m_walkAnimationPhase = 0;
         return;
     }
 
-    m_walkUpdateEvent = g_dispatcher.cycleEvent([self = static_self_cast<Creature>()] {
-        self->updateWalkAnimation();
-        if (self.use_count() == 1) {
-            self->m_walkUpdateEvent->cancel();
-        }
-    }, std::min<int>(v / g_gameConfig.getSpriteSize(), DrawPool::FPS60));
+    g_map.scheduleWalkUpdate(static_self_cast<Creature>());
 }
 
 void Creature::setWidgetInformation(const UIWidgetPtr& info) {
@@ -207,6 +207,11 @@ protected:
     void onDeath();
     void onPositionChange(const Position& newPos, const Position& oldPos) override;
 
+    friend class Map;
+#ifdef CLIENT_CHECKS
+    friend class WalkCheck;
+#endif
+
     bool m_walking{ false };
 
     Point m_walkOffset;
@@ -231,7 +236,6 @@ private:
         uint16_t groundSpeed{ 0 };
 
         uint16_t duration{ 0 };
-        uint16_t walkDuration{ 0 };
         uint16_t diagonalDuration{ 0 };
 
         uint16_t getDuration(const Otc::Direction dir) const { return Position::isDiagonal(dir) ? diagonalDuration : duration; }
@@ -248,7 +252,6 @@ private:
     TexturePtr m_iconTexture;
     TexturePtr m_typingIconTexture;
 
-    EventPtr m_walkUpdateEvent;
     ScheduledEventPtr m_walkFinishAnimEvent;
     ScheduledEventPtr m_outfitColorUpdateEvent;
 
@@ -327,6 +330,10 @@ private:
     bool m_typing{ false };
     bool m_isCovered{ false };
 
+    // in the walk updates of the map, and playing the walk animation without walking
+    bool m_walkUpdateScheduled{ false };
+    bool m_staticWalking{ false };
+
     StaticTextPtr m_text;
 };
 
@@ -580,6 +580,7 @@ protected:
 
     friend class ProtocolGame;
     friend class Map;
+    friend class ReplayBenchmark;
 
 public:
     // login related
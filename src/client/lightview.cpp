@@ -27,6 +27,26 @@
 #include <framework/core/eventdispatcher.h>
 #include <framework/graphics/drawpoolmanager.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIGHTVIEW_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // channels of Color::from8bit in the 0-255 range
+    constexpr auto LIGHT_COLORS = [] {
+        std::array<std::array<float, 3>, 256> colors{};
+        for (int color = 1; color < 216; ++color) {
+            colors[color] = { static_cast<float>(color / 36 % 6 * 51), static_cast<float>(color / 6 % 6 * 51), static_cast<float>(color % 6 * 51) };
+        }
+        return colors;
+    }();
+
+    // below this many tile/light pairs the shade is not worth splitting across threads
+    constexpr size_t MIN_PARALLEL_SHADE_WORK = 4096;
+}
+
 LightView::LightView(const Size& size) : m_pool(g_drawPool.get(DrawPoolType::LIGHT)) {
     g_mainDispatcher.addEvent([this, size] {
         m_texture = std::make_shared<Texture>(size);
@@ -48,6 +68,7 @@ void LightView::resize(const Size& size, const uint16_t tileSize) {
     m_lightData.lights.clear();
 
     m_pixels.resize(size.area() * 4);
+    m_shade.resize(size.area() * 3);
 
     if (m_texture)
         m_texture->setupSize(m_mapSize);
@@ -82,7 +103,7 @@ void LightView::resetShade(const Point& pos)
 {
     const size_t index = (pos.y / m_tileSize) * m_mapSize.width() + (pos.x / m_tileSize);
     if (index >= m_lightData.tiles.size()) return;
-    m_lightData.tiles[index] = m_lightData.lights.size();
+    m_lightData.tiles[index] = static_cast<int32_t>(m_lightData.lights.size());
 }
 
 void LightView::draw(const Rect& dest, const Rect& src)
@@ -135,53 +156,147 @@ void LightView::updateCoords(const Rect& dest, const Rect& src) {
 
 void LightView::updatePixels()
 {
-    const auto lightSize = m_lightData.lights.size();
-    const auto mapWidth = m_mapSize.width();
-    const auto mapHeight = m_mapSize.height();
-    const auto tileCenterOffset = m_tileSize / 2;
-    const auto invTileSize = 1.0f / m_tileSize;
-
-    auto* pixelData = m_pixels.data();
-
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            const auto centerX = x * m_tileSize + tileCenterOffset;
-            const auto centerY = y * m_tileSize + tileCenterOffset;
-            const auto index = y * mapWidth + x;
+    const int mapWidth = m_mapSize.width();
+    const int mapHeight = m_mapSize.height();
+    const float tileSize = m_tileSize;
+    const float tileCenterOffset = m_tileSize / 2;
+
+    // a light reaches at most intensity tiles away, so only its bounding box is shaded
+    m_sources.clear();
+    size_t work = 0;
+    for (int32_t i = 0, size = m_lightData.lights.size(); i < size; ++i) {
+        const auto& light = m_lightData.lights[i];
+        if (light.color == 0 || light.color >= 216)
+            continue;
+
+        const float radius = light.intensity * tileSize;
+        const int left = std::max<int>(0, std::ceil((light.pos.x - radius - tileCenterOffset) / tileSize));
+        const int right = std::min<int>(mapWidth - 1, std::floor((light.pos.x + radius - tileCenterOffset) / tileSize));
+        const int top = std::max<int>(0, std::ceil((light.pos.y - radius - tileCenterOffset) / tileSize));
+        const int bottom = std::min<int>(mapHeight - 1, std::floor((light.pos.y + radius - tileCenterOffset) / tileSize));
+        if (left > right || top > bottom)
+            continue;
+
+        m_sources.push_back({ static_cast<float>(light.pos.x), static_cast<float>(light.pos.y), static_cast<float>(light.intensity), radius * radius,
+                            LIGHT_COLORS[light.color][0], LIGHT_COLORS[light.color][1], LIGHT_COLORS[light.color][2], i, left, top, right, bottom });
+        work += static_cast<size_t>(right - left + 1) * (bottom - top + 1);
+    }
 
-            auto r = m_globalLightColor.r();
-            auto g = m_globalLightColor.g();
-            auto b = m_globalLightColor.b();
+    static const int numThreads = g_asyncDispatcher.get_thread_count();
+    if (numThreads > 1 && mapHeight > numThreads && work >= MIN_PARALLEL_SHADE_WORK) {
+        static BS::multi_future<void> tasks;
+        tasks.clear();
+
+        // rows are independent, each band of rows is shaded by a single thread
+        const int rowsPerThread = (mapHeight + numThreads - 1) / numThreads;
+        for (int row = rowsPerThread; row < mapHeight; row += rowsPerThread) {
+            const int lastRow = std::min<int>(row + rowsPerThread, mapHeight);
+            tasks.emplace_back(g_asyncDispatcher.submit_task([=, this] {
+                shadeRows(row, lastRow);
+            }));
+        }
 
-            for (auto i = m_lightData.tiles[index]; i < lightSize; ++i) {
-                const auto& light = m_lightData.lights[i];
+        shadeRows(0, rowsPerThread);
+        tasks.wait();
+    } else {
+        shadeRows(0, mapHeight);
+    }
+}
 
-                const auto dx = centerX - light.pos.x;
-                const auto dy = centerY - light.pos.y;
-                const auto distanceSq = dx * dx + dy * dy;
+void LightView::shadeRows(const int firstRow, const int lastRow)
+{
+    const int mapWidth = m_mapSize.width();
+    const size_t area = m_mapSize.area();
+    const float tileSize = m_tileSize;
+    const float tileCenterOffset = m_tileSize / 2;
+    const float invTileSize = 1.0f / m_tileSize;
+
+    float* red = m_shade.data();
+    float* green = red + area;
+    float* blue = green + area;
+    const int32_t* tiles = m_lightData.tiles.data();
+
+    const size_t first = static_cast<size_t>(firstRow) * mapWidth;
+    const size_t last = static_cast<size_t>(lastRow) * mapWidth;
+    std::fill(red + first, red + last, m_globalLightColor.r());
+    std::fill(green + first, green + last, m_globalLightColor.g());
+    std::fill(blue + first, blue + last, m_globalLightColor.b());
+
+    for (const auto& light : m_sources) {
+        const int top = std::max<int>(light.top, firstRow);
+        const int bottom = std::min<int>(light.bottom, lastRow - 1);
+
+        for (int y = top; y <= bottom; ++y) {
+            const float dy = y * tileSize + tileCenterOffset - light.y;
+            const float dySq = dy * dy;
+            const size_t row = static_cast<size_t>(y) * mapWidth;
+
+            int x = light.left;
+#ifdef LIGHTVIEW_SSE2
+            const __m128 lightX = _mm_set1_ps(light.x);
+            const __m128 rowDistanceSq = _mm_set1_ps(dySq);
+            const __m128 radiusSq = _mm_set1_ps(light.radiusSq);
+            const __m128 intensity = _mm_set1_ps(light.intensity);
+            const __m128 invTile = _mm_set1_ps(invTileSize);
+            const __m128 falloff = _mm_set1_ps(0.2f);
+            const __m128 minIntensity = _mm_set1_ps(0.01f);
+            const __m128 one = _mm_set1_ps(1.f);
+            const __m128 lightR = _mm_set1_ps(light.r);
+            const __m128 lightG = _mm_set1_ps(light.g);
+            const __m128 lightB = _mm_set1_ps(light.b);
+            const __m128i lightIndex = _mm_set1_epi32(light.index);
+            const __m128 step = _mm_set1_ps(tileSize * 4);
+
+            const float centerX = x * tileSize + tileCenterOffset;
+            __m128 center = _mm_setr_ps(centerX, centerX + tileSize, centerX + tileSize * 2, centerX + tileSize * 3);
+
+            for (; x + 3 <= light.right; x += 4, center = _mm_add_ps(center, step)) {
+                const __m128 dx = _mm_sub_ps(center, lightX);
+                const __m128 distanceSq = _mm_add_ps(_mm_mul_ps(dx, dx), rowDistanceSq);
+                const __m128 distanceNorm = _mm_mul_ps(_mm_sqrt_ps(distanceSq), invTile);
+                __m128 value = _mm_mul_ps(_mm_sub_ps(intensity, distanceNorm), falloff);
+
+                // tiles whose shade was reset after this light was added stay untouched
+                const __m128i shaded = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tiles + row + x)), lightIndex);
+                const __m128 mask = _mm_andnot_ps(_mm_castsi128_ps(shaded), _mm_and_ps(_mm_cmple_ps(distanceSq, radiusSq), _mm_cmpge_ps(value, minIntensity)));
+                value = _mm_and_ps(mask, _mm_min_ps(value, one));
+
+                float* r = red + row + x;
+                float* g = green + row + x;
+                float* b = blue + row + x;
+                _mm_storeu_ps(r, _mm_max_ps(_mm_loadu_ps(r), _mm_mul_ps(lightR, value)));
+                _mm_storeu_ps(g, _mm_max_ps(_mm_loadu_ps(g), _mm_mul_ps(lightG, value)));
+                _mm_storeu_ps(b, _mm_max_ps(_mm_loadu_ps(b), _mm_mul_ps(lightB, value)));
+            }
+#endif
+            for (; x <= light.right; ++x) {
+                const size_t index = row + x;
+                if (tiles[index] > light.index)
+                    continue;
 
-                const auto lightRadiusSq = (light.intensity * m_tileSize) * (light.intensity * m_tileSize);
-                if (distanceSq > lightRadiusSq) continue;
+                const float dx = x * tileSize + tileCenterOffset - light.x;
+                const float distanceSq = dx * dx + dySq;
+                if (distanceSq > light.radiusSq)
+                    continue;
 
-                const auto distanceNorm = std::sqrt(distanceSq) * invTileSize;
-                float intensity = (-distanceNorm + light.intensity) * 0.2f;
-                if (intensity < 0.01f) continue;
+                float intensity = (light.intensity - std::sqrt(distanceSq) * invTileSize) * 0.2f;
+                if (intensity < 0.01f)
+                    continue;
 
                 intensity = std::min<float>(intensity, 1.0f);
-
-                const auto& lightColor = Color::from8bit(light.color) * intensity;
-
-                r = std::max<int>(r, lightColor.r());
-                g = std::max<int>(g, lightColor.g());
-                b = std::max<int>(b, lightColor.b());
+                red[index] = std::max<float>(red[index], light.r * intensity);
+                green[index] = std::max<float>(green[index], light.g * intensity);
+                blue[index] = std::max<float>(blue[index], light.b * intensity);
             }
-
-            const auto colorIndex = index * 4;
-
-            pixelData[colorIndex] = r;
-            pixelData[colorIndex + 1] = g;
-            pixelData[colorIndex + 2] = b;
-            pixelData[colorIndex + 3] = 255;
         }
     }
-}
\ No newline at end of file
+
+    auto* pixelData = m_pixels.data();
+    for (size_t index = first; index < last; ++index) {
+        const auto colorIndex = index * 4;
+        pixelData[colorIndex] = static_cast<uint8_t>(red[index]);
+        pixelData[colorIndex + 1] = static_cast<uint8_t>(green[index]);
+        pixelData[colorIndex + 2] = static_cast<uint8_t>(blue[index]);
+        pixelData[colorIndex + 3] = 255;
+    }
+}
@@ -61,12 +61,25 @@ private:
 
     struct LightData
     {
-        std::vector<size_t> tiles;
+        // index of the first light drawn over each tile
+        std::vector<int32_t> tiles;
         std::vector<TileLight> lights;
     };
 
+    // light ready for the shade kernel, bounds are in tiles and inclusive
+    struct LightSource
+    {
+        float x, y;
+        float intensity;
+        float radiusSq;
+        float r, g, b;
+        int32_t index;
+        int left, top, right, bottom;
+    };
+
     void updateCoords(const Rect& dest, const Rect& src);
     void updatePixels();
+    void shadeRows(int firstRow, int lastRow);
 
     bool m_isDark{ false };
 
@@ -80,5 +93,7 @@ private:
     CoordsBuffer m_coords;
     TexturePtr m_texture;
     LightData m_lightData;
+    std::vector<LightSource> m_sources;
+    std::vector<float> m_shade; // planar red, green and blue per tile
     std::vector<uint8_t> m_pixels;
 };
@@ -127,6 +127,9 @@ void Client::registerLuaFunctions()
     g_lua.registerSingletonClass("g_spriteAppearances");
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSpriteToFile", &SpriteAppearances::saveSpriteToFile, &g_spriteAppearances);
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSheetToFileBySprite", &SpriteAppearances::saveSheetToFileBySprite, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "setMaxLoadedSheets", &SpriteAppearances::setMaxLoadedSheets, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getMaxLoadedSheets", &SpriteAppearances::getMaxLoadedSheets, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getLoadedSheetsCount", &SpriteAppearances::getLoadedSheetsCount, &g_spriteAppearances);
 
     g_lua.registerSingletonClass("g_map");
     g_lua.bindSingletonFunction("g_map", "isLookPossible", &Map::isLookPossible, &g_map);
@@ -424,6 +427,8 @@ void Client::registerLuaFunctions()
     g_lua.registerClass<ProtocolGame, Protocol>();
     g_lua.bindClassStaticFunction<ProtocolGame>("create", [] { return std::make_shared<ProtocolGame>(); });
     g_lua.bindClassMemberFunction<ProtocolGame>("sendExtendedOpcode", &ProtocolGame::sendExtendedOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("setLuaOpcode", &ProtocolGame::setLuaOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isLuaOpcode", &ProtocolGame::isLuaOpcode);
 
     g_lua.registerClass<Container>();
     g_lua.bindClassMemberFunction<Container>("getItem", &Container::getItem);
@@ -35,7 +35,6 @@
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/graphicalapplication.h>
 #include <framework/ui/uiwidget.h>
-#include <queue>
 
 #ifdef FRAMEWORK_EDITOR
 #include "houses.h"
@@ -46,6 +45,81 @@ const static TilePtr m_nulltile;
 
 Map g_map;
 
+namespace
+{
+    // the longest straight line findPath crosses without adding a node, so open areas are not scanned end to end
+    constexpr int MAX_JUMP_STEPS = 64;
+
+    // the open list of a path search, a binary heap on storage that is kept between searches
+    template<typename T, typename Less>
+    class PathHeap
+    {
+    public:
+        explicit PathHeap(std::vector<T>& storage) : m_items(storage) { m_items.clear(); }
+
+        bool empty() const { return m_items.empty(); }
+        const T& top() const { return m_items.front(); }
+
+        void push(const T& item)
+        {
+            m_items.push_back(item);
+            std::push_heap(m_items.begin(), m_items.end(), Less());
+        }
+
+        void pop()
+        {
+            std::pop_heap(m_items.begin(), m_items.end(), Less());
+            m_items.pop_back();
+        }
+
+    private:
+        std::vector<T>& m_items;
+    };
+}
+
+PathGrid& PathGrid::threadGrid()
+{
+    // searches run on the main thread and on the async dispatcher
+    static thread_local PathGrid grid;
+    return grid;
+}
+
+void PathGrid::begin()
+{
+    // forget areas searched long ago, and start over once the generations run out
+    if (m_chunks.size() > MAX_CHUNKS || ++m_generation == 0) {
+        m_chunks.clear();
+        m_chunkCache.fill({});
+        m_generation = 1;
+    }
+}
+
+PathGrid::Cell& PathGrid::get(const Position& pos)
+{
+    // a search looks around the last few tiles, so the chunks near them are kept at hand
+    const uint32_t chunkX = pos.x / CHUNK_SIZE;
+    const uint32_t chunkY = pos.y / CHUNK_SIZE;
+    const uint64_t key = static_cast<uint64_t>(chunkX) << 32 | chunkY;
+
+    auto& cached = m_chunkCache[(chunkX % 4) * 4 + chunkY % 4];
+    if (!cached.chunk || cached.key != key) {
+        auto& chunk = m_chunks[key];
+        if (!chunk)
+            chunk = std::make_unique<Chunk>();
+        cached = { key, chunk.get() };
+    }
+
+    auto& cell = (*cached.chunk)[(pos.y % CHUNK_SIZE) * CHUNK_SIZE + pos.x % CHUNK_SIZE];
+    if (cell.generation != m_generation) {
+        cell.generation = m_generation;
+        cell.state = NodeUnknown;
+        cell.evaluated = false;
+        cell.jumps = {};
+        cell.diagonalStep = -1;
+    }
+    return cell;
+}
+
 void Map::init()
 {
     g_window.addKeyListener([this](const InputEvent& inputEvent) {
@@ -64,6 +138,10 @@ void Map::init()
 void Map::terminate()
 {
     clean();
+
+    for (const auto& creature : m_walkUpdates)
+        creature->m_walkUpdateScheduled = false;
+    m_walkUpdates.clear();
 }
 
 void Map::addMapView(const MapViewPtr& mapView) { m_mapViews.push_back(mapView); }
@@ -106,6 +184,15 @@ void Map::notificateTileUpdate(const Position& pos, const ThingPtr& thing, const
     }
 }
 
+void Map::notificateTileLive(const Position& pos) const
+{
+    if (!pos.isMapPosition())
+        return;
+
+    for (const auto& mapView : m_mapViews)
+        mapView->onTileLive(pos);
+}
+
 void Map::clean()
 {
     cleanDynamicThings();
@@ -255,6 +342,10 @@ bool Map::removeThing(const ThingPtr& thing)
 
     if (const auto& tile = thing->getTile()) {
         if (tile->removeThing(thing)) {
+            // a creature leaving the map is no longer drawn, its static walk ends and the next walk pass drops it
+            if (thing->isCreature() && thing->static_self_cast<Creature>()->m_staticWalking)
+                thing->static_self_cast<Creature>()->setStaticWalking(0);
+
             notificateTileUpdate(thing->getServerPosition(), thing, Otc::OPERATION_REMOVE);
             return true;
         }
@@ -520,6 +611,46 @@ void Map::removeCreatureById(const uint32_t  id)
         m_knownCreatures.erase(it);
 }
 
+void Map::scheduleWalkUpdate(const CreaturePtr& creature)
+{
+    if (creature->m_walkUpdateScheduled)
+        return;
+
+    creature->m_walkUpdateScheduled = true;
+    m_walkUpdates.emplace_back(creature);
+
+    if (!m_walkUpdateEvent)
+        m_walkUpdateEvent = g_dispatcher.addEvent([this] { updateWalks(); });
+}
+
+void Map::updateWalks()
+{
+    // the event stays set during the pass, creatures starting to walk in it are added to this pass instead of a new event
+    size_t kept = 0;
+    for (size_t i = 0; i < m_walkUpdates.size(); ++i) {
+        // a copy, as the end of a walk can start others and grow the list
+        const auto creature = m_walkUpdates[i];
+
+        if (creature->isWalking()) {
+            creature->updateWalk();
+            creature->onWalking();
+        } else if (creature->m_staticWalking && creature->canDraw()) {
+            creature->updateWalkAnimation();
+        } else {
+            creature->m_walkUpdateScheduled = false;
+            continue;
+        }
+
+        m_walkUpdates[kept++] = creature;
+    }
+
+    m_walkUpdates.resize(kept);
+
+    m_walkUpdateEvent = nullptr;
+    if (!m_walkUpdates.empty())
+        m_walkUpdateEvent = g_dispatcher.addEvent([this] { updateWalks(); });
+}
+
 void Map::removeUnawareThings()
 {
     // remove creatures from tiles that we are not aware of anymore
@@ -780,20 +911,9 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
 {
     // pathfinding using dijkstra search algorithm
 
-    struct SNode
-    {
-        SNode(const Position& pos) :
-            pos(pos) {}
-        float cost{ 0 };
-        float totalCost{ 0 };
-        Position pos;
-        SNode* prev{ nullptr };
-        Otc::Direction dir{ Otc::InvalidDirection };
-    };
-
     struct LessNode
     {
-        bool operator()(const std::pair<SNode*, float> a, const std::pair<SNode*, float> b) const
+        bool operator()(const std::pair<Node*, float> a, const std::pair<Node*, float> b) const
         {
             return b.second < a.second;
         }
@@ -828,15 +948,184 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
         }
     }
 
-    stdext::map<Position, SNode*, Position::Hasher> nodes;
-    std::priority_queue<std::pair<SNode*, float>, std::vector<std::pair<SNode*, float>>, LessNode> searchList;
+    auto& grid = PathGrid::threadGrid();
+    grid.begin();
+
+    static thread_local std::vector<std::pair<Node*, float>> searchStorage;
+    PathHeap<std::pair<Node*, float>, LessNode> searchList(searchStorage);
+
+    const auto getCell = [&](const Position& pos) -> PathGrid::Cell& {
+        auto& cell = grid.get(pos);
+        if (cell.evaluated)
+            return cell;
+
+        bool wasSeen = false;
+        bool hasCreature = false;
+        bool isNotWalkable = true;
+        bool isNotPathable = true;
+        int speed = 100;
+
+        if (g_map.isAwareOfPosition(pos)) {
+            wasSeen = true;
+            if (const auto& tile = getTile(pos)) {
+                hasCreature = tile->hasCreatures() && (!(flags & Otc::PathFindIgnoreCreatures));
+                isNotWalkable = !tile->isWalkable(flags & Otc::PathFindIgnoreCreatures);
+                isNotPathable = !tile->isPathable();
+                speed = tile->getGroundSpeed();
+            }
+        } else {
+            const auto& mtile = g_minimap.getTile(pos);
+            wasSeen = mtile.hasFlag(MinimapTileWasSeen);
+            isNotWalkable = mtile.hasFlag(MinimapTileNotWalkable);
+            isNotPathable = mtile.hasFlag(MinimapTileNotPathable);
+            if (isNotWalkable || isNotPathable)
+                wasSeen = true;
+            speed = mtile.getSpeed();
+        }
+
+        bool passable = true;
+        if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+            passable = false;
+        else if (wasSeen) {
+            if (pos != goalPos) {
+                if (!(flags & Otc::PathFindAllowCreatures) && hasCreature)
+                    passable = false;
+                if (!(flags & Otc::PathFindAllowNonPathable) && isNotPathable)
+                    passable = false;
+            }
+            if (!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
+                passable = false;
+        }
+
+        cell.evaluated = true;
+        cell.passable = passable;
+        cell.speed = speed;
+        return cell;
+    };
+
+    // jump point search (Harabor and Grastien) over straight steps, as a diagonal one costs more than going around its corner.
+    // lines of tiles with the same speed are crossed without adding nodes, up to where the path may turn
+    static constexpr std::array<std::pair<int, int>, 4> lineSteps{ { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } } };
+
+    const auto isOpen = [&](const Position& pos) {
+        return pos.x >= 0 && pos.y >= 0 && getCell(pos).passable;
+    };
+
+    const auto isPlain = [&](const Position& pos, const int speed) {
+        if (pos == goalPos || pos.x < 0 || pos.y < 0)
+            return false;
+
+        const auto& cell = getCell(pos);
+        return cell.passable && cell.speed == speed;
+    };
+
+    // a diagonal step is only shorter than going around a blocked or slower corner
+    const auto hasDiagonalStep = [&](const Position& pos, const int speed) {
+        auto& cell = getCell(pos);
+        if (cell.diagonalStep < 0) {
+            cell.diagonalStep = 0;
+            for (const int i : { -1, 1 }) {
+                for (const int j : { -1, 1 }) {
+                    const Position diagonalPos = pos.translated(i, j);
+                    if (isOpen(diagonalPos) && (!isPlain(diagonalPos, speed) ||
+                                                (!isPlain(pos.translated(i, 0), speed) && !isPlain(pos.translated(0, j), speed))))
+                        cell.diagonalStep = 1;
+                }
+            }
+        }
+        return cell.diagonalStep == 1;
+    };
+
+    // follows a line from a tile with its speed, returns 1 + the steps to where the path may turn, or -(the steps to where it is blocked).
+    // the result of each tile is kept, as horizontal lines follow the vertical ones from every tile they cross
+    const auto jumpLine = [&](const auto& self, const Position& from, const int line) -> int {
+        const auto [dx, dy] = lineSteps[line];
+        const int speed = getCell(from).speed;
+
+        const auto isTurn = [&](const Position& pos) {
+            if (hasDiagonalStep(pos, speed))
+                return true;
+
+            if (dx == 0) {
+                // a side tile that could not be reached from the previous row first
+                for (const int i : { -1, 1 }) {
+                    const Position sidePos = pos.translated(i, 0);
+                    if (isOpen(sidePos) && (!isPlain(sidePos, speed) || !isPlain(sidePos.translated(0, -dy), speed)))
+                        return true;
+                }
+                return false;
+            }
+
+            // horizontal lines turn vertical anywhere, so they stop wherever a vertical one would
+            for (const int verticalLine : { 0, 2 }) {
+                const Position nextPos = pos.translated(0, lineSteps[verticalLine].second);
+                if (isOpen(nextPos) && (!isPlain(nextPos, speed) || self(self, nextPos, verticalLine) > 0))
+                    return true;
+            }
+            return false;
+        };
+
+        Position pos = from;
+        int steps = 0;
+        int result;
+        while (true) {
+            if (const int jump = getCell(pos).jumps[line]) {
+                result = jump > 0 ? steps + jump : jump - steps;
+                break;
+            }
+
+            if (steps == MAX_JUMP_STEPS || isTurn(pos)) {
+                result = steps + 1;
+                break;
+            }
+
+            const Position nextPos = pos.translated(dx, dy);
+            if (!isOpen(nextPos)) {
+                result = -(steps + 1);
+                break;
+            }
+
+            if (!isPlain(nextPos, speed)) {
+                result = steps + 2;
+                break;
+            }
+
+            pos = nextPos;
+            ++steps;
+        }
+
+        pos = from;
+        for (int i = 0; i <= steps; ++i, pos.translate(dx, dy))
+            getCell(pos).jumps[line] = result > 0 ? result - i : result + i;
 
-    auto* currentNode = new SNode(startPos);
-    currentNode->pos = startPos;
-    nodes[startPos] = currentNode;
-    SNode* foundNode = nullptr;
+        return result;
+    };
+
+    // the tile where the path may turn, in a straight line from pos
+    const auto jump = [&](const Position& pos, const int dx, const int dy) -> std::optional<Position> {
+        const Position nextPos = pos.translated(dx, dy);
+        if (nextPos == goalPos)
+            return nextPos;
+
+        const int line = dy < 0 ? 0 : dx > 0 ? 1 : dy > 0 ? 2 : 3;
+        const int result = jumpLine(jumpLine, nextPos, line);
+        if (result <= 0)
+            return std::nullopt;
+
+        return nextPos.translated(dx * (result - 1), dy * (result - 1));
+    };
+
+    const bool jumpPoints = flags & Otc::PathFindJumpPoints;
+
+    auto& startCell = grid.get(startPos);
+    startCell.state = PathGrid::NodeOpen;
+    startCell.node = { .cost = 0, .totalCost = 0, .pos = startPos, .prev = nullptr, .distance = 0, .unseen = 0 };
+
+    int nodeCount = 1;
+    Node* currentNode = &startCell.node;
+    Node* foundNode = nullptr;
     while (currentNode) {
-        if (static_cast<int>(nodes.size()) > maxComplexity) {
+        if (nodeCount > maxComplexity) {
             result = Otc::PathFindResultTooFar;
             break;
         }
@@ -854,76 +1143,42 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
                 if (i == 0 && j == 0)
                     continue;
 
-                bool wasSeen = false;
-                bool hasCreature = false;
-                bool isNotWalkable = true;
-                bool isNotPathable = true;
-                int speed = 100;
-
                 Position neighborPos = currentNode->pos.translated(i, j);
                 if (neighborPos.x < 0 || neighborPos.y < 0) continue;
-                if (g_map.isAwareOfPosition(neighborPos)) {
-                    wasSeen = true;
-                    if (const auto& tile = getTile(neighborPos)) {
-                        hasCreature = tile->hasCreatures() && (!(flags & Otc::PathFindIgnoreCreatures));
-                        isNotWalkable = !tile->isWalkable(flags & Otc::PathFindIgnoreCreatures);
-                        isNotPathable = !tile->isPathable();
-                        speed = tile->getGroundSpeed();
-                    }
-                } else {
-                    const auto& mtile = g_minimap.getTile(neighborPos);
-                    wasSeen = mtile.hasFlag(MinimapTileWasSeen);
-                    isNotWalkable = mtile.hasFlag(MinimapTileNotWalkable);
-                    isNotPathable = mtile.hasFlag(MinimapTileNotPathable);
-                    if (isNotWalkable || isNotPathable)
-                        wasSeen = true;
-                    speed = mtile.getSpeed();
-                }
-
-                float walkFactor = 0;
-                if (neighborPos != goalPos) {
-                    if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
-                        continue;
-                    if (wasSeen) {
-                        if (!(flags & Otc::PathFindAllowCreatures) && hasCreature)
-                            continue;
-                        if (!(flags & Otc::PathFindAllowNonPathable) && isNotPathable)
-                            continue;
-                        if (!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
-                            continue;
-                    }
-                } else {
-                    if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
-                        continue;
-                    if (wasSeen) {
-                        if (!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
-                            continue;
-                    }
-                }
 
-                const Otc::Direction walkDir = currentNode->pos.getDirectionFromPosition(neighborPos);
-                if (walkDir >= Otc::NorthEast)
-                    walkFactor += 3.0f;
-                else
-                    walkFactor += 1.0f;
+                const auto& neighbor = getCell(neighborPos);
+                if (!neighbor.passable)
+                    continue;
 
-                const float cost = currentNode->cost + (speed * walkFactor) / 100.0f;
+                const float walkFactor = i != 0 && j != 0 ? 3.0f : 1.0f;
+                float cost = currentNode->cost + (neighbor.speed * walkFactor) / 100.0f;
 
-                SNode* neighborNode;
-                if (!nodes.contains(neighborPos)) {
-                    neighborNode = new SNode(neighborPos);
-                    nodes[neighborPos] = neighborNode;
-                } else {
-                    neighborNode = nodes[neighborPos];
-                    if (neighborNode->cost <= cost)
+                if (jumpPoints && (i == 0 || j == 0)) {
+                    const auto jumpPos = jump(currentNode->pos, i, j);
+                    if (!jumpPos)
                         continue;
+
+                    // the tiles up to the jump point have the speed of the first one
+                    if (*jumpPos != neighborPos) {
+                        const int steps = std::abs(jumpPos->x - neighborPos.x) + std::abs(jumpPos->y - neighborPos.y);
+                        cost += ((steps - 1) * neighbor.speed + getCell(*jumpPos).speed) / 100.0f;
+                        neighborPos = *jumpPos;
+                    }
                 }
 
+                auto& neighborCell = grid.get(neighborPos);
+                if (neighborCell.state != PathGrid::NodeOpen) {
+                    neighborCell.state = PathGrid::NodeOpen;
+                    neighborCell.node.pos = neighborPos;
+                    ++nodeCount;
+                } else if (neighborCell.node.cost <= cost)
+                    continue;
+
+                Node* neighborNode = &neighborCell.node;
                 neighborNode->prev = currentNode;
                 neighborNode->cost = cost;
                 neighborNode->totalCost = neighborNode->cost + neighborPos.distance(goalPos);
-                neighborNode->dir = walkDir;
-                searchList.emplace(neighborNode, neighborNode->totalCost);
+                searchList.push({ neighborNode, neighborNode->totalCost });
             }
         }
 
@@ -935,19 +1190,16 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
     }
 
     if (foundNode) {
-        currentNode = foundNode;
-        while (currentNode) {
-            dirs.push_back(currentNode->dir);
-            currentNode = currentNode->prev;
+        for (const Node* node = foundNode; node->prev; node = node->prev) {
+            // jump points are a straight line away from the previous node
+            const Position& prevPos = node->prev->pos;
+            const int steps = std::max(std::abs(node->pos.x - prevPos.x), std::abs(node->pos.y - prevPos.y));
+            dirs.insert(dirs.end(), steps, prevPos.getDirectionFromPosition(node->pos));
         }
-        dirs.pop_back();
         std::ranges::reverse(dirs);
         result = Otc::PathFindResultOk;
     }
 
-    for (const auto& it : nodes)
-        delete it.second;
-
     return ret;
 }
 
@@ -957,7 +1209,7 @@ void Map::resetLastCamera() const
         mapView->resetLastCamera();
 }
 
-PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>
+PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::vector<Node>>
                                     & visibleNodes)
 {
     auto ret = std::make_shared<PathFindResult>();
@@ -994,17 +1246,26 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
         }
     };
 
-    stdext::map<Position, Node*, Position::Hasher> nodes;
-    std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
+    auto& grid = PathGrid::threadGrid();
+    grid.begin();
+
+    static thread_local std::vector<Node*> searchStorage;
+    PathHeap<Node*, LessNode> searchList(searchStorage);
 
     if (visibleNodes) {
-        for (auto& node : *visibleNodes)
-            nodes.emplace(node->pos, node);
+        for (const auto& node : *visibleNodes) {
+            auto& cell = grid.get(node.pos);
+            if (cell.state == PathGrid::NodeUnknown) {
+                cell.state = PathGrid::NodeOpen;
+                cell.node = node;
+            }
+        }
     }
 
-    const auto& initNode = new Node{ .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 };
-    nodes[start] = initNode;
-    searchList.push(initNode);
+    auto& initCell = grid.get(start);
+    initCell.state = PathGrid::NodeOpen;
+    initCell.node = { .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 };
+    searchList.push(&initCell.node);
 
     int limit = 50000;
     const float distance = start.distance(goal);
@@ -1025,8 +1286,8 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
                     continue;
                 Position neighbor = node->pos.translated(i, j);
                 if (neighbor.x < 0 || neighbor.y < 0) continue;
-                auto it = nodes.find(neighbor);
-                if (it == nodes.end()) {
+                auto& cell = grid.get(neighbor);
+                if (cell.state == PathGrid::NodeUnknown) {
                     const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
                     const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
                     const bool isNotWalkable = tile.hasFlag(MinimapTileNotWalkable);
@@ -1034,31 +1295,32 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
                     const bool isEmpty = tile.hasFlag(MinimapTileEmpty);
                     float speed = tile.getSpeed();
                     if ((isNotWalkable || isNotPathable || isEmpty) && neighbor != goal) {
-                        it = nodes.emplace(neighbor, nullptr).first;
+                        cell.state = PathGrid::NodeBlocked;
                     } else {
                         if (!wasSeen)
                             speed = 2000;
-                        it = nodes.emplace(neighbor, new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev =
-                                               node,
-                                               .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 }).first;
+                        cell.state = PathGrid::NodeOpen;
+                        cell.node = { .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev = node,
+                                      .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 };
                     }
                 }
-                if (!it->second) // no way
+                if (cell.state == PathGrid::NodeBlocked) // no way
                     continue;
 
-                if (it->second->unseen > 50)
+                Node* neighborNode = &cell.node;
+                if (neighborNode->unseen > 50)
                     continue;
 
                 const float diagonal = ((i == 0 || j == 0) ? 1.0f : 3.0f);
-                float cost = it->second->cost * diagonal;
-                cost += diagonal * (50.0f * std::max<float>(5.0f, it->second->pos.distance(goal))); // heuristic
-                if (node->totalCost + cost + 50 < it->second->totalCost) {
-                    it->second->totalCost = node->totalCost + cost;
-                    it->second->prev = node;
-                    if (it->second->unseen)
-                        it->second->unseen = node->unseen + 1;
-                    it->second->distance = node->distance + 1;
-                    searchList.push(it->second);
+                float cost = neighborNode->cost * diagonal;
+                cost += diagonal * (50.0f * std::max<float>(5.0f, neighborNode->pos.distance(goal))); // heuristic
+                if (node->totalCost + cost + 50 < neighborNode->totalCost) {
+                    neighborNode->totalCost = node->totalCost + cost;
+                    neighborNode->prev = node;
+                    if (neighborNode->unseen)
+                        neighborNode->unseen = node->unseen + 1;
+                    neighborNode->distance = node->distance + 1;
+                    searchList.push(neighborNode);
                 }
             }
         }
@@ -1078,32 +1340,26 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
     }
     ret->complexity = 50000 - limit;
 
-    for (const auto& node : nodes) {
-        delete node.second;
-    }
-
     return ret;
 }
 
 void Map::findPathAsync(const Position& start, const Position& goal, const std::function<void(PathFindResult_ptr)>&
                         callback)
 {
-    const auto visibleNodes = std::make_shared<std::list<Node*>>();
-    for (const auto& tile : getTiles(start.z)) {
+    const auto& tiles = getTiles(start.z);
+    const auto visibleNodes = std::make_shared<std::vector<Node>>();
+    visibleNodes->reserve(tiles.size());
+    for (const auto& tile : tiles) {
         if (tile->getPosition() == start)
             continue;
         const bool isNotWalkable = !tile->isWalkable(false);
         const bool isNotPathable = !tile->isPathable();
         const float speed = tile->getGroundSpeed();
         if ((isNotWalkable || isNotPathable) && tile->getPosition() != goal) {
-            visibleNodes->push_back(new Node{ .cost = speed, .totalCost = 0, .pos = tile->getPosition(), .prev = nullptr, .distance =
-                0,
-                .unseen = 0
-            });
+            visibleNodes->push_back({ .cost = speed, .totalCost = 0, .pos = tile->getPosition(), .prev = nullptr, .distance = 0, .unseen = 0 });
         } else {
-            visibleNodes->push_back(new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = tile->getPosition(), .prev =
-                nullptr, .distance = 0, .unseen = 0
-            });
+            visibleNodes->push_back({ .cost = speed, .totalCost = 10000000.0f, .pos = tile->getPosition(), .prev = nullptr,
+                                      .distance = 0, .unseen = 0 });
         }
     }
 
@@ -1303,12 +1559,17 @@ std::map<std::string, std::tuple<int, int, int, std::string>> Map::findEveryPath
     }
 
     std::map<std::string, std::tuple<int, int, int, std::string>> ret;
-    std::unordered_map<Position, Node*, Position::Hasher> nodes;
-    std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
 
-    Node* initNode = new Node{ 1, 0, start, nullptr, 0, 0 };
-    nodes[start] = initNode;
-    searchList.push(initNode);
+    auto& grid = PathGrid::threadGrid();
+    grid.begin();
+
+    static thread_local std::vector<Node*> searchStorage;
+    PathHeap<Node*, LessNode> searchList(searchStorage);
+
+    auto& initCell = grid.get(start);
+    initCell.state = PathGrid::NodeOpen;
+    initCell.node = { 1, 0, start, nullptr, 0, 0 };
+    searchList.push(&initCell.node);
 
     while (!searchList.empty()) {
         Node* node = searchList.top();
@@ -1331,8 +1592,8 @@ std::map<std::string, std::tuple<int, int, int, std::string>> Map::findEveryPath
                     continue;
                 Position neighbor = node->pos.translated(i, j);
                 if (neighbor.x < 0 || neighbor.y < 0) continue;
-                auto it = nodes.find(neighbor);
-                if (it == nodes.end()) {
+                auto& cell = grid.get(neighbor);
+                if (cell.state == PathGrid::NodeUnknown) {
                     bool wasSeen = false;
                     bool hasCreature = false;
                     bool isNotWalkable = true;
@@ -1363,44 +1624,41 @@ std::map<std::string, std::tuple<int, int, int, std::string>> Map::findEveryPath
                     if ((!wasSeen && !allowUnseen) || (hasStairs && !ignoreStairs && neighbor != destPos) ||
                         (isNotPathable && !ignoreNonPathable && neighbor != destPos) || (isNotWalkable && !ignoreNonWalkable) ||
                         hasReachedMaxDistance) {
-                        it = nodes.emplace(neighbor, nullptr).first;
+                        cell.state = PathGrid::NodeBlocked;
                     } else if ((hasCreature && !ignoreCreatures)) {
-                        it = nodes.emplace(neighbor, nullptr).first;
+                        cell.state = PathGrid::NodeBlocked;
                         if (ignoreLastCreature) {
                             ret[neighbor.toString()] = std::make_tuple(node->totalCost + 100, node->distance + 1,
                                                                        node->pos.getDirectionFromPosition(neighbor),
                                                                        node->pos.toString());
                         }
                     } else {
-                        it = nodes.emplace(neighbor, new Node{ (float)speed, 10000000.0f, neighbor, node, node->distance + 1, wasSeen ? 0 : 1 }).first;
+                        cell.state = PathGrid::NodeOpen;
+                        cell.node = { (float)speed, 10000000.0f, neighbor, node, node->distance + 1, wasSeen ? 0 : 1 };
                     }
                 }
 
-                if (!it->second) {
+                if (cell.state == PathGrid::NodeBlocked) {
                     continue;
                 }
 
+                Node* neighborNode = &cell.node;
                 float diagonal = ((i == 0 || j == 0) ? 1.0f : 3.0f);
-                float cost = it->second->cost * diagonal;
+                float cost = neighborNode->cost * diagonal;
                 if (ignoreCost)
                     cost = 1;
-                if (node->totalCost + cost < it->second->totalCost) {
-                    it->second->totalCost = node->totalCost + cost;
-                    it->second->prev = node;
-                    if (it->second->unseen)
-                        it->second->unseen = node->unseen + 1;
-                    it->second->distance = node->distance + 1;
-                    searchList.push(it->second);
+                if (node->totalCost + cost < neighborNode->totalCost) {
+                    neighborNode->totalCost = node->totalCost + cost;
+                    neighborNode->prev = node;
+                    if (neighborNode->unseen)
+                        neighborNode->unseen = node->unseen + 1;
+                    neighborNode->distance = node->distance + 1;
+                    searchList.push(neighborNode);
                 }
             }
         }
     }
 
-    for (auto& node : nodes) {
-        if (node.second)
-            delete node.second;
-    }
-
     return ret;
 }
 
@@ -146,6 +146,55 @@ struct Node
     int unseen;
 };
 
+// The nodes of a path search by position, in chunks that are kept between the searches of a thread.
+// Each search stamps the cells it touches with its own generation, so nothing is cleared in between.
+class PathGrid
+{
+public:
+    enum NodeState : uint8_t
+    {
+        NodeUnknown,
+        NodeBlocked,
+        NodeOpen
+    };
+
+    struct Cell
+    {
+        Node node;
+        uint32_t generation{ 0 };
+        NodeState state{ NodeUnknown };
+        // the tile checks of findPath, done once per search
+        bool evaluated{ false };
+        bool passable{ false };
+        int speed{ 0 };
+        // the straight lines of jump point search from this tile, up, right, down and left
+        std::array<int32_t, 4> jumps{};
+        int8_t diagonalStep{ -1 };
+    };
+
+    static PathGrid& threadGrid();
+
+    // starts a new search, every cell is unknown again
+    void begin();
+    Cell& get(const Position& pos);
+
+private:
+    static constexpr int CHUNK_SIZE = 16;
+    static constexpr size_t MAX_CHUNKS = 256;
+
+    using Chunk = std::array<Cell, CHUNK_SIZE* CHUNK_SIZE>;
+
+    struct CachedChunk
+    {
+        uint64_t key{ 0 };
+        Chunk* chunk{ nullptr };
+    };
+
+    stdext::map<uint64_t, std::unique_ptr<Chunk>> m_chunks;
+    std::array<CachedChunk, 16> m_chunkCache;
+    uint32_t m_generation{ 0 };
+};
+
 //@bindsingleton g_map
 class Map
 {
@@ -158,6 +207,7 @@ public:
     MapViewPtr getMapView(const size_t i) { return i < m_mapViews.size() ? m_mapViews[i] : nullptr; }
 
     void notificateTileUpdate(const Position& pos, const ThingPtr& thing, Otc::Operation operation);
+    void notificateTileLive(const Position& pos) const;
     void notificateCameraMove(const Point& offset) const;
     void notificateKeyRelease(const InputEvent& inputEvent) const;
 
@@ -289,7 +339,7 @@ public:
 
     std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> findPath(const Position& start, const Position& goal,
                                                                           int maxComplexity, int flags = 0);
-    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>& visibleNodes);
+    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::vector<Node>>& visibleNodes);
     void findPathAsync(const Position& start, const Position& goal,
                        const std::function<void(PathFindResult_ptr)>& callback);
 
@@ -304,6 +354,9 @@ public:
 
     const auto& getCreatures() const { return m_knownCreatures; }
 
+    // the walking creatures are all updated in one pass on each poll, instead of an event for each of them
+    void scheduleWalkUpdate(const CreaturePtr& creature);
+
 private:
     struct FloorData
     {
@@ -312,6 +365,7 @@ private:
     };
 
     void removeUnawareThings();
+    void updateWalks();
 
     uint16_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
 
@@ -323,6 +377,10 @@ private:
 
     std::unordered_map<uint32_t, CreaturePtr> m_knownCreatures;
 
+    // the walking creatures and those walking in place, which the map holds until they stop or can no longer be drawn
+    std::vector<CreaturePtr> m_walkUpdates;
+    EventPtr m_walkUpdateEvent;
+
     std::unordered_map<UIWidgetPtr, AttachableObjectPtr> m_attachedObjectWidgetMap;
 
 #ifdef FRAMEWORK_EDITOR
@@ -348,6 +406,10 @@ private:
     AwareRange m_awareRange;
 
     bool m_floatingEffect{ true };
+
+#ifdef CLIENT_CHECKS
+    friend class WalkCheck;
+#endif
 };
 
 extern Map g_map;
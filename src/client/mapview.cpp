@@ -27,6 +27,7 @@
 #include "creature.h"
 #include "game.h"
 #include "lightview.h"
+#include "localplayer.h"
 #include "map.h"
 #include "missile.h"
 #include "statictext.h"
@@ -43,6 +44,14 @@
 
 #include <algorithm>
 
+namespace
+{
+    // how far the drawing of a tile reaches out of its cell: up and left for the things bigger than a tile,
+    // the elevation and the creatures redrawn over corpses, down and right for the creatures walking out of it
+    constexpr int TILE_REACH_BEFORE = 4;
+    constexpr int TILE_REACH_AFTER = 1;
+}
+
 MapView::MapView() : m_lightView(std::make_unique<LightView>(Size())), m_pool(g_drawPool.get(DrawPoolType::MAP))
 {
     m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
@@ -123,9 +132,32 @@ void MapView::preLoad() {
 
 void MapView::drawFloor()
 {
-    const auto& cameraPosition = m_posInfo.camera;
+    Position crosshairPosition;
+    if (m_posInfo.rect.contains(g_window.getMousePosition() * g_window.getDisplayDensity())) {
+        if (m_crosshairTexture && m_mousePosition.isValid())
+            crosshairPosition = m_mousePosition;
+    } else if (m_lastHighlightTile) {
+        m_mousePosition = {}; // Invalidate mousePosition
+        destroyHighlightTile();
+    }
 
-    const uint32_t flags = Otc::DrawThings;
+    if (crosshairPosition != m_lastCrosshairPosition) {
+        markDirty(m_lastCrosshairPosition);
+        markDirty(crosshairPosition);
+        m_lastCrosshairPosition = crosshairPosition;
+    }
+
+    const bool fullRepaint = updateDirtyRegions();
+    if (!fullRepaint) {
+        g_drawPool.setPartialRepaint();
+        if (m_dirtyRects.empty())
+            return;
+
+        // what was drawn in these regions is cleared first, as the whole framebuffer is on a full repaint
+        for (const auto& cells : m_dirtyRects)
+            g_drawPool.addFilledRect(getCellsRect(cells), Color::black);
+        g_drawPool.flush();
+    }
 
     for (int_fast8_t z = m_floorMax; z >= m_floorMin; --z) {
         const float fadeLevel = getFadeLevel(z);
@@ -133,52 +165,218 @@ void MapView::drawFloor()
         if (fadeLevel < .99f)
             g_drawPool.setOpacity(fadeLevel);
 
-        Position _camera = cameraPosition;
-        const bool alwaysTransparent = m_floorViewMode == ALWAYS_WITH_TRANSPARENCY && z < m_cachedFirstVisibleFloor && _camera.coveredUp(cameraPosition.z - z);
+        if (fullRepaint)
+            drawFloor(z, {});
+        else {
+            for (const auto& cells : m_dirtyRects) {
+                g_drawPool.setClipRect(getCellsRect(cells));
+                drawFloor(z, cells);
+                g_drawPool.resetClipRect();
+            }
+        }
 
-        const auto& map = m_floors[z].cachedVisibleTiles;
+        if (canFloorFade())
+            g_drawPool.resetOpacity();
 
-        for (const auto& tile : map.tiles) {
-            uint32_t tileFlags = flags;
+        g_drawPool.flush();
+    }
 
-            if (!m_drawViewportEdge && !tile->canRender(tileFlags, cameraPosition, m_viewport))
-                continue;
+    if (crosshairPosition.isValid()) {
+        const auto& crosshairRect = Rect(transformPositionTo2D(crosshairPosition), m_tileSize, m_tileSize);
+        if (fullRepaint)
+            g_drawPool.addTexturedRect(crosshairRect, m_crosshairTexture);
+        else {
+            for (const auto& cells : m_dirtyRects) {
+                if (!cells.contains(getCell(crosshairPosition)))
+                    continue;
 
-            if (alwaysTransparent) {
-                const bool inRange = tile->getPosition().isInRange(_camera, g_gameConfig.getTileTransparentFloorViewRange(), g_gameConfig.getTileTransparentFloorViewRange(), true);
-                g_drawPool.setOpacity(inRange ? .16 : .7);
+                g_drawPool.setClipRect(getCellsRect(cells));
+                g_drawPool.addTexturedRect(crosshairRect, m_crosshairTexture);
+                g_drawPool.resetClipRect();
             }
+        }
+    }
+}
 
-            tile->draw(transformPositionTo2D(tile->getPosition()), tileFlags);
+void MapView::drawFloor(const int_fast8_t z, const Rect& cells)
+{
+    const auto& cameraPosition = m_posInfo.camera;
 
-            if (alwaysTransparent)
-                g_drawPool.resetOpacity();
-        }
+    const uint32_t flags = Otc::DrawThings;
 
-        for (const auto& missile : g_map.getFloorMissiles(z))
-            missile->draw(transformPositionTo2D(missile->getPosition()), true);
+    Position _camera = cameraPosition;
+    const bool alwaysTransparent = m_floorViewMode == ALWAYS_WITH_TRANSPARENCY && z < m_cachedFirstVisibleFloor && _camera.coveredUp(cameraPosition.z - z);
+
+    // the tiles that can draw over the cells, an invalid rect is all of them
+    Rect reach;
+    if (cells.isValid())
+        reach = Rect(cells.topLeft() - Point(TILE_REACH_AFTER), cells.bottomRight() + Point(TILE_REACH_BEFORE));
+
+    const auto& map = m_floors[z].cachedVisibleTiles;
+
+    for (const auto& tile : map.tiles) {
+        uint32_t tileFlags = flags;
 
-        if (m_shadowFloorIntensity > 0 && z == cameraPosition.z + 1) {
-            g_drawPool.setOpacity(m_shadowFloorIntensity, true);
-            g_drawPool.addFilledRect(m_rectDimension, Color::black, m_shadowConductor);
+        if (reach.isValid() && !reach.contains(getCell(tile->getPosition())))
+            continue;
+
+        if (!m_drawViewportEdge && !tile->canRender(tileFlags, cameraPosition, m_viewport))
+            continue;
+
+        if (alwaysTransparent) {
+            const bool inRange = tile->getPosition().isInRange(_camera, g_gameConfig.getTileTransparentFloorViewRange(), g_gameConfig.getTileTransparentFloorViewRange(), true);
+            g_drawPool.setOpacity(inRange ? .16 : .7);
         }
 
-        if (canFloorFade())
+        tile->draw(transformPositionTo2D(tile->getPosition()), tileFlags);
+
+        if (alwaysTransparent)
             g_drawPool.resetOpacity();
+    }
 
-        g_drawPool.flush();
+    for (const auto& missile : g_map.getFloorMissiles(z))
+        missile->draw(transformPositionTo2D(missile->getPosition()), true);
+
+    if (m_shadowFloorIntensity > 0 && z == cameraPosition.z + 1) {
+        g_drawPool.setOpacity(m_shadowFloorIntensity, true);
+        g_drawPool.addFilledRect(m_rectDimension, Color::black, m_shadowConductor);
     }
+}
 
-    if (m_posInfo.rect.contains(g_window.getMousePosition() * g_window.getDisplayDensity())) {
-        if (m_crosshairTexture && m_mousePosition.isValid()) {
-            const auto& point = transformPositionTo2D(m_mousePosition);
-            const auto& crosshairRect = Rect(point, m_tileSize, m_tileSize);
-            g_drawPool.addTexturedRect(crosshairRect, m_crosshairTexture);
+Point MapView::getCell(const Position& pos) const
+{
+    const auto& camera = m_posInfo.camera;
+    return {
+        m_virtualCenterOffset.x + (pos.x - camera.x) - (camera.z - pos.z),
+        m_virtualCenterOffset.y + (pos.y - camera.y) - (camera.z - pos.z)
+    };
+}
+
+void MapView::markCells(std::vector<bool>& cells, const Position& from, const Position& to) const
+{
+    const int width = m_drawDimension.width();
+    const int height = m_drawDimension.height();
+    if (!from.isValid() || !to.isValid() || cells.size() != static_cast<size_t>(width * height))
+        return;
+
+    const auto& a = getCell(from);
+    const auto& b = getCell(to);
+
+    const int left = std::max<int>(std::min(a.x, b.x) - TILE_REACH_BEFORE, 0);
+    const int top = std::max<int>(std::min(a.y, b.y) - TILE_REACH_BEFORE, 0);
+    const int right = std::min<int>(std::max(a.x, b.x) + TILE_REACH_AFTER, width - 1);
+    const int bottom = std::min<int>(std::max(a.y, b.y) + TILE_REACH_AFTER, height - 1);
+
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x)
+            cells[y * width + x] = true;
+    }
+}
+
+void MapView::markDirty(const Position& pos)
+{
+    std::scoped_lock l(m_dirtyMutex);
+    markCells(m_dirtyCells, pos, pos);
+}
+
+bool MapView::updateDirtyRegions()
+{
+    const auto& cameraPosition = m_posInfo.camera;
+    const size_t cellCount = m_drawDimension.area();
+
+    bool fullRepaint = m_fullRepaint.exchange(false) || cameraPosition != m_lastDrawnCamera || !(m_viewport == m_lastDrawnViewport);
+    m_lastDrawnCamera = cameraPosition;
+    m_lastDrawnViewport = m_viewport;
+
+    // the opacity of a fading floor changes every frame
+    for (int_fast8_t z = m_floorMax; z >= m_floorMin && !fullRepaint; --z) {
+        const float fadeLevel = getFadeLevel(z);
+        fullRepaint = fadeLevel > 0.f && fadeLevel < 1.f;
+    }
+
+    std::scoped_lock l(m_dirtyMutex);
+
+    if (m_dirtyCells.size() != cellCount) {
+        m_dirtyCells.assign(cellCount, false);
+        m_liveCells.assign(cellCount, false);
+        fullRepaint = true;
+    }
+
+    // the cells of the tiles that changed by themselves last frame are drawn again, for what they left behind
+    for (size_t i = 0; i < cellCount; ++i) {
+        if (m_liveCells[i]) {
+            m_dirtyCells[i] = true;
+            m_liveCells[i] = false;
         }
-    } else if (m_lastHighlightTile) {
-        m_mousePosition = {}; // Invalidate mousePosition
-        destroyHighlightTile();
     }
+
+    // the tiles that became live since the last frame join the list of their floor
+    for (const auto& pos : m_newLiveTiles) {
+        if (pos.z < m_floorMin || pos.z > m_floorMax)
+            continue;
+
+        const auto& tile = g_map.getTile(pos);
+        auto& liveTiles = m_floors[pos.z].cachedVisibleTiles.liveTiles;
+        if (tile && std::ranges::find(liveTiles, tile) == liveTiles.end())
+            liveTiles.emplace_back(tile);
+    }
+    m_newLiveTiles.clear();
+
+    // the local player is drawn on the tile it is going to
+    if (const auto& localPlayer = g_game.getLocalPlayer())
+        markCells(m_liveCells, localPlayer->getPosition(), localPlayer->getPosition());
+
+    for (int_fast8_t z = m_floorMax; z >= m_floorMin; --z) {
+        if (getFadeLevel(z) == 0.f) break;
+
+        // the tiles that are no longer live nor animated leave the list until they are updated again
+        std::erase_if(m_floors[z].cachedVisibleTiles.liveTiles, [this](const TilePtr& tile) {
+            const bool animated = tile->updateAnimationPhases();
+            if (tile->isLive())
+                markCells(m_liveCells, tile->getPosition(), tile->getPosition());
+            else if (animated)
+                markCells(m_dirtyCells, tile->getPosition(), tile->getPosition());
+
+            return !tile->isLive() && !tile->hasAnimatedItems();
+        });
+
+        for (const auto& missile : g_map.getFloorMissiles(z))
+            markCells(m_liveCells, missile->getPosition(), missile->getDestination());
+    }
+
+    m_dirtyRects.clear();
+
+    if (fullRepaint) {
+        std::fill(m_dirtyCells.begin(), m_dirtyCells.end(), false);
+        return true;
+    }
+
+    // runs of dirty cells on each row, joined with the run of the same columns on the row above
+    const int width = m_drawDimension.width();
+    const int height = m_drawDimension.height();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const auto i = y * width + x;
+            if (!m_dirtyCells[i] && !m_liveCells[i])
+                continue;
+
+            const int left = x;
+            while (x + 1 < width && (m_dirtyCells[i + x + 1 - left] || m_liveCells[i + x + 1 - left]))
+                ++x;
+
+            const auto it = std::ranges::find_if(m_dirtyRects, [&](const Rect& r) {
+                return r.left() == left && r.right() == x && r.bottom() == y - 1;
+            });
+
+            if (it != m_dirtyRects.end())
+                it->setBottom(y);
+            else
+                m_dirtyRects.emplace_back(left, y, x - left + 1, 1);
+        }
+    }
+
+    std::fill(m_dirtyCells.begin(), m_dirtyCells.end(), false);
+    return false;
 }
 
 void MapView::drawLights() {
@@ -368,6 +566,8 @@ void MapView::updateVisibleTiles()
 
                         if (addTile) {
                             floor.tiles.emplace_back(tile);
+                            if (tile->isLive() || tile->hasAnimatedItems())
+                                floor.liveTiles.emplace_back(tile);
                             tile->onAddInMapView();
                         }
 
@@ -416,6 +616,7 @@ void MapView::updateVisibleTiles()
                 auto& floorThread = m_floorThreads[i][fi];
                 floor.cachedVisibleTiles.tiles.insert(floor.cachedVisibleTiles.tiles.end(), std::make_move_iterator(floorThread.cachedVisibleTiles.tiles.begin()), std::make_move_iterator(floorThread.cachedVisibleTiles.tiles.end()));
                 floor.cachedVisibleTiles.shades.insert(floor.cachedVisibleTiles.shades.end(), std::make_move_iterator(floorThread.cachedVisibleTiles.shades.begin()), std::make_move_iterator(floorThread.cachedVisibleTiles.shades.end()));
+                floor.cachedVisibleTiles.liveTiles.insert(floor.cachedVisibleTiles.liveTiles.end(), std::make_move_iterator(floorThread.cachedVisibleTiles.liveTiles.begin()), std::make_move_iterator(floorThread.cachedVisibleTiles.liveTiles.end()));
             }
         }
     } else {
@@ -493,6 +694,7 @@ void MapView::updateGeometry(const Size& visibleDimension)
 
     g_mainDispatcher.addEvent([this, bufferSize] {
         m_pool->getFrameBuffer()->resize(bufferSize);
+        m_fullRepaint = true;
     });
 
     const uint8_t left = std::min<uint8_t>(g_map.getAwareRange().left, (m_drawDimension.width() / 2) - 1);
@@ -540,14 +742,27 @@ void MapView::onTileUpdate(const Position& pos, const ThingPtr& thing, const Otc
     if (thing && thing->isOpaque() && op == Otc::OPERATION_REMOVE)
         m_resetCoveredCache = true;
 
+    markDirty(pos);
+
+    // what was added may be live or animated, the list of its floor drops it again when it is not
+    if (op == Otc::OPERATION_ADD)
+        onTileLive(pos);
+
     if (op == Otc::OPERATION_CLEAN) {
         if (m_lastHighlightTile && m_lastHighlightTile->getPosition() == pos)
             m_lastHighlightTile = nullptr;
 
-        requestUpdateVisibleTiles();
+        // only the tile changed, the visible tiles are cached again but the map is not drawn again as a whole
+        m_updateVisibleTiles = true;
     }
 }
 
+void MapView::onTileLive(const Position& pos)
+{
+    std::scoped_lock l(m_dirtyMutex);
+    m_newLiveTiles.emplace_back(pos);
+}
+
 void MapView::onFadeInFinished()
 {
     requestUpdateVisibleTiles();
@@ -945,6 +1160,7 @@ std::vector<CreaturePtr> MapView::getSpectators(const bool multiFloor)
 void MapView::setCrosshairTexture(const std::string& texturePath)
 {
     m_crosshairTexture = texturePath.empty() ? nullptr : g_textures.getTexture(texturePath);
+    markDirty(m_lastCrosshairPosition);
 }
 
 void MapView::updateHighlightTile(const Position& mousePos) {
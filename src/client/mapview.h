@@ -123,7 +123,7 @@ public:
     void setMinimumAmbientLight(const float intensity) { m_minimumAmbientLight = intensity; updateLight(); }
     float getMinimumAmbientLight() const { return m_minimumAmbientLight; }
 
-    void setShadowFloorIntensity(const float intensity) { m_shadowFloorIntensity = intensity; updateLight(); }
+    void setShadowFloorIntensity(const float intensity) { m_shadowFloorIntensity = intensity; m_fullRepaint = true; updateLight(); }
     float getShadowFloorIntensity() const { return m_shadowFloorIntensity; }
 
     void setDrawNames(const bool enable) { m_drawNames = enable; }
@@ -192,6 +192,7 @@ protected:
     void onGlobalLightChange(const Light& light);
     void onFloorChange(uint8_t floor, uint8_t previousFloor);
     void onTileUpdate(const Position& pos, const ThingPtr& thing, Otc::Operation operation);
+    void onTileLive(const Position& pos);
     void onMapCenterChange(const Position& newPos, const Position& oldPos);
     void onCameraMove(const Point& offset);
     void onFadeInFinished();
@@ -200,6 +201,9 @@ protected:
     friend class UIMap;
     friend class Tile;
     friend class LightView;
+#ifdef CLIENT_CHECKS
+    friend class MapViewCheck;
+#endif
 
 private:
     enum class FadeType
@@ -211,7 +215,9 @@ private:
     {
         std::vector<TilePtr> shades;
         std::vector<TilePtr> tiles;
-        void clear() { shades.clear(); tiles.clear(); }
+        // the visible tiles that are live or have animated items, drawn again without being updated
+        std::vector<TilePtr> liveTiles;
+        void clear() { shades.clear(); tiles.clear(); liveTiles.clear(); }
     };
 
     struct FloorData
@@ -236,7 +242,7 @@ private:
     void updateVisibleTiles();
     void updateRect(const Rect& rect);
     void updateViewport(const Otc::Direction dir = Otc::InvalidDirection) { m_viewport = m_viewPortDirection[dir]; }
-    void requestUpdateVisibleTiles() { m_updateVisibleTiles = true; }
+    void requestUpdateVisibleTiles() { m_updateVisibleTiles = true; m_fullRepaint = true; }
     void requestUpdateMapPosInfo() { m_updateMapPosInfo = true; }
 
     void registerEvents();
@@ -245,8 +251,16 @@ private:
     uint8_t calcLastVisibleFloor() const;
 
     void drawFloor();
+    void drawFloor(int_fast8_t z, const Rect& cells);
     void drawLights();
 
+    // the map framebuffer keeps the last frame, only the cells whose tiles changed are drawn again
+    Point getCell(const Position& pos) const;
+    Rect getCellsRect(const Rect& cells) const { return { cells.left() * m_tileSize, cells.top() * m_tileSize, cells.width() * m_tileSize, cells.height() * m_tileSize }; }
+    void markCells(std::vector<bool>& cells, const Position& from, const Position& to) const;
+    void markDirty(const Position& pos);
+    bool updateDirtyRegions();
+
     bool canFloorFade() const { return m_floorViewMode == FADE && m_floorFading; }
 
     float getFadeLevel(const uint8_t z) const
@@ -299,9 +313,12 @@ private:
     Position m_lastCameraPosition;
     Position m_mousePosition;
     Position m_shaderPosition;
+    Position m_lastCrosshairPosition;
+    Position m_lastDrawnCamera;
 
     std::array<AwareRange, Otc::InvalidDirection + 1> m_viewPortDirection;
     AwareRange m_viewport;
+    AwareRange m_lastDrawnViewport;
 
     bool m_limitVisibleDimension{ true };
     bool m_updateVisibleTiles{ true };
@@ -332,6 +349,14 @@ private:
 
     std::vector<TilePtr> m_foregroundTiles;
 
+    // one per cell of the draw dimension, the cells to draw again and those with tiles that may change by themselves
+    std::vector<bool> m_dirtyCells;
+    std::vector<bool> m_liveCells;
+    std::vector<Rect> m_dirtyRects;
+    std::vector<Position> m_newLiveTiles;
+    std::mutex m_dirtyMutex;
+    std::atomic_bool m_fullRepaint{ true };
+
     PainterShaderProgramPtr m_shader;
     PainterShaderProgramPtr m_nextShader;
     LightViewPtr m_lightView;
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "mapviewcheck.h"
+#include "creature.h"
+#include "item.h"
+#include "map.h"
+#include "mapview.h"
+#include "thingtypemanager.h"
+#include "tile.h"
+
+#include <framework/core/clock.h>
+#include <framework/core/eventdispatcher.h>
+
+#include <random>
+
+namespace
+{
+    // the check area is far from any game, the camera stays on its center
+    const Position origin(1000, 1000, 7);
+    constexpr int AREA_WIDTH = 10;
+    constexpr int AREA_HEIGHT = 8;
+
+    constexpr uint16_t GROUND_ID = 1;
+    constexpr uint16_t ANIMATED_ID = 2;
+}
+
+// the checks run without assets, the map gets a plain ground and an item of three animation phases
+void MapViewCheck::installItemTypes()
+{
+    const auto makeType = [](const uint16_t id, const uint64_t flags, const uint8_t animationPhases) {
+        const auto& type = std::make_shared<ThingType>();
+        type->m_null = false;
+        type->m_category = ThingCategoryItem;
+        type->m_id = id;
+        type->m_flags = flags;
+        type->m_animationPhases = animationPhases;
+        type->m_groundSpeed = 150;
+        return type;
+    };
+
+    auto& types = g_things.m_thingTypes[ThingCategoryItem];
+    types.resize(std::max<size_t>(types.size(), ANIMATED_ID + 1), g_things.getNullThingType());
+    types[GROUND_ID] = makeType(GROUND_ID, ThingFlagAttrGround, 1);
+    types[ANIMATED_ID] = makeType(ANIMATED_ID, 0, 3);
+}
+
+// what a full repaint would draw for the tile this frame
+size_t MapViewCheck::getSignature(const TilePtr& tile)
+{
+    size_t hash = 0;
+    for (const auto& thing : tile->getThings()) {
+        stdext::hash_combine(hash, thing.get());
+        stdext::hash_combine(hash, thing->getMarkedColor().rgba());
+        stdext::hash_combine(hash, thing->getHighlightColor().rgba());
+        stdext::hash_combine(hash, thing->getShaderId());
+
+        if (thing->isItem())
+            stdext::hash_combine(hash, thing->static_self_cast<Item>()->calculateAnimationPhase());
+        else if (thing->isCreature()) {
+            const auto& offset = thing->static_self_cast<Creature>()->getWalkOffset();
+            stdext::hash_combine(hash, offset.x);
+            stdext::hash_combine(hash, offset.y);
+        }
+    }
+
+    for (const auto& creature : tile->getWalkingCreatures()) {
+        stdext::hash_combine(hash, creature.get());
+        stdext::hash_combine(hash, creature->getWalkOffset().x);
+        stdext::hash_combine(hash, creature->getWalkOffset().y);
+    }
+
+    stdext::hash_combine(hash, tile->m_fill.rgba());
+
+    // the selection pulses, it looks different on every frame
+    if (tile->isSelected())
+        stdext::hash_combine(hash, g_clock.millis());
+
+    return hash;
+}
+
+bool MapViewCheck::run(const int frames, const int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> xs(-AREA_WIDTH, AREA_WIDTH);
+    std::uniform_int_distribution<int> ys(-AREA_HEIGHT, AREA_HEIGHT);
+    std::uniform_int_distribution<int> actions(0, 9);
+    std::uniform_int_distribution<int> changes(0, 4);
+    std::uniform_int_distribution<int> directions(Otc::North, Otc::West);
+    std::uniform_int_distribution<int> sleeps(1, 20);
+
+    installItemTypes();
+    g_clock.update();
+
+    const auto randomPosition = [&] { return origin.translated(xs(rng), ys(rng)); };
+
+    for (int x = -AREA_WIDTH; x <= AREA_WIDTH; ++x) {
+        for (int y = -AREA_HEIGHT; y <= AREA_HEIGHT; ++y)
+            g_map.addThing(Item::create(GROUND_ID), origin.translated(x, y));
+    }
+
+    const auto& mapView = std::make_shared<MapView>();
+    g_map.addMapView(mapView);
+    mapView->setCameraPosition(origin);
+    // as UIMap does before drawing it, the camera never moves after this
+    mapView->updateRect(mapView->m_rectDimension);
+
+    std::vector<CreaturePtr> creatures;
+    std::vector<ItemPtr> items;
+
+    std::unordered_map<Position, size_t, Position::Hasher> lastSignatures;
+    size_t partialFrames = 0, checkedCells = 0, missedCells = 0, tileChanges = 0;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        // what the protocol would change on the map between two frames
+        for (int i = changes(rng); i > 0; --i, ++tileChanges) {
+            switch (actions(rng)) {
+                case 0: {
+                    const auto& item = Item::create(rng() % 2 ? GROUND_ID : ANIMATED_ID);
+                    g_map.addThing(item, randomPosition());
+                    items.emplace_back(item);
+                    break;
+                }
+                case 1:
+                    if (!items.empty()) {
+                        const auto it = items.begin() + rng() % items.size();
+                        g_map.removeThing(*it);
+                        items.erase(it);
+                    }
+                    break;
+                case 2:
+                    if (creatures.size() < 8) {
+                        const auto& creature = std::make_shared<Creature>();
+                        Outfit outfit;
+                        outfit.setCategory(ThingCategoryCreature);
+                        creature->setOutfit(outfit);
+                        creature->setSpeed(220);
+                        g_map.addThing(creature, randomPosition());
+                        creatures.emplace_back(creature);
+                    }
+                    break;
+                case 3:
+                    if (!creatures.empty()) {
+                        const auto it = creatures.begin() + rng() % creatures.size();
+                        g_map.removeThing(*it);
+                        creatures.erase(it);
+                    }
+                    break;
+                case 4:
+                case 5:
+                    // a step, as ProtocolGame::parseCreatureMove makes it
+                    for (const auto& creature : creatures) {
+                        const auto& to = creature->getPosition().translatedToDirection(static_cast<Otc::Direction>(directions(rng)));
+                        if (creature->isWalking() || !origin.isInRange(to, AREA_WIDTH, AREA_HEIGHT))
+                            continue;
+
+                        g_map.removeThing(creature);
+                        creature->allowAppearWalk();
+                        g_map.addThing(creature, to);
+                    }
+                    break;
+                case 6:
+                    if (const auto& tile = g_map.getTile(randomPosition()))
+                        tile->isSelected() ? tile->unselect() : tile->select();
+                    break;
+                case 7:
+                    if (const auto& tile = g_map.getTile(randomPosition()))
+                        tile->m_fill == Color::alpha ? tile->setFill(Color::red) : tile->resetFill();
+                    break;
+                default:
+                    if (!items.empty()) {
+                        const auto& item = items[rng() % items.size()];
+                        item->setMarked(item->isMarked() ? Color::white : Color::yellow);
+                    }
+                    break;
+            }
+        }
+
+        stdext::millisleep(sleeps(rng));
+        g_clock.update();
+        g_dispatcher.poll();
+
+        // the draw of the frame
+        mapView->preLoad();
+        const bool fullRepaint = mapView->updateDirtyRegions();
+
+        // the full repaint draws every visible tile, the cells it draws differently must be drawn again
+        std::unordered_map<Position, size_t, Position::Hasher> signatures;
+        for (int_fast8_t z = mapView->m_floorMax; z >= mapView->m_floorMin; --z) {
+            for (const auto& tile : mapView->m_floors[z].cachedVisibleTiles.tiles)
+                signatures.emplace(tile->getPosition(), getSignature(tile));
+        }
+
+        std::vector<bool> changedCells(mapView->m_drawDimension.area(), false);
+        for (const auto& [pos, signature] : signatures) {
+            const auto it = lastSignatures.find(pos);
+            if (it == lastSignatures.end() || it->second != signature)
+                mapView->markCells(changedCells, pos, pos);
+        }
+        for (const auto& [pos, signature] : lastSignatures) {
+            if (!signatures.contains(pos))
+                mapView->markCells(changedCells, pos, pos);
+        }
+        lastSignatures = std::move(signatures);
+
+        if (fullRepaint)
+            continue;
+
+        ++partialFrames;
+        const int width = mapView->m_drawDimension.width();
+        for (size_t i = 0; i < changedCells.size(); ++i) {
+            if (!changedCells[i])
+                continue;
+
+            const Point cell(i % width, i / width);
+            ++checkedCells;
+            if (std::ranges::none_of(mapView->m_dirtyRects, [&](const Rect& cells) { return cells.contains(cell); }))
+                ++missedCells;
+        }
+    }
+
+    g_map.removeMapView(mapView);
+    g_map.clean();
+
+    std::cout << fmt::format("{} frames, {} partial, {} tile changes\n", frames, partialFrames, tileChanges);
+    std::cout << fmt::format("{} changed cells checked against the dirty regions, {} not drawn again\n", checkedCells, missedCells);
+    return partialFrames > 0 && missedCells == 0;
+}
@@ -130,6 +130,10 @@ private:
     uint32_t getBlockIndex(const Position& pos) { return ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE); }
     std::vector<std::unordered_map<uint32_t, MinimapBlock_ptr>> m_tileBlocks;
     std::mutex m_lock;
+
+#ifdef CLIENT_CHECKS
+    friend class PathFindCheck;
+#endif
 };
 
 extern Minimap g_minimap;
@@ -45,6 +45,7 @@ void Missile::draw(const Point& dest, const bool drawThings, const LightViewPtr&
 void Missile::setPath(const Position& fromPosition, const Position& toPosition)
 {
     m_position = fromPosition;
+    m_destination = toPosition;
     m_delta = Point(toPosition.x - fromPosition.x, toPosition.y - fromPosition.y);
 
     const float deltaLength = m_delta.length();
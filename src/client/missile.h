@@ -42,12 +42,15 @@ public:
     void setDirection(Otc::Direction dir);
     auto getDirection() { return m_direction; }
 
+    const Position& getDestination() const { return m_destination; }
+
 protected:
     ThingType* getThingType() const override;
 
 private:
     Timer m_animationTimer;
     Point m_delta;
+    Position m_destination;
 
     float m_duration{ 0.f };
 
@@ -0,0 +1,596 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "pathfindcheck.h"
+#include "map.h"
+#include "minimap.h"
+#include "tile.h"
+
+#include <queue>
+#include <random>
+
+namespace
+{
+    // the check area is far from any game, so findPath only reads the minimap there
+    const Position origin(1000, 1000, 7);
+    constexpr int MAX_AREA_SIZE = 70;
+
+    // the search Map::findPath ran before the shared search grid, on minimap tiles
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> findReferencePath(const Position& startPos, const Position& goalPos, const int maxComplexity, const int flags)
+    {
+        struct SNode
+        {
+            SNode(const Position& pos) :
+                pos(pos) {}
+            float cost{ 0 };
+            float totalCost{ 0 };
+            Position pos;
+            SNode* prev{ nullptr };
+            Otc::Direction dir{ Otc::InvalidDirection };
+        };
+
+        struct LessNode
+        {
+            bool operator()(const std::pair<SNode*, float> a, const std::pair<SNode*, float> b) const
+            {
+                return b.second < a.second;
+            }
+        };
+
+        std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> ret;
+        std::vector<Otc::Direction>& dirs = std::get<0>(ret);
+        Otc::PathFindResult& result = std::get<1>(ret);
+
+        result = Otc::PathFindResultNoWay;
+
+        if (startPos == goalPos) {
+            result = Otc::PathFindResultSamePosition;
+            return ret;
+        }
+
+        if (startPos.z != goalPos.z) {
+            result = Otc::PathFindResultImpossible;
+            return ret;
+        }
+
+        if (g_minimap.getTile(goalPos).hasFlag(MinimapTileNotWalkable))
+            return ret;
+
+        stdext::map<Position, SNode*, Position::Hasher> nodes;
+        std::priority_queue<std::pair<SNode*, float>, std::vector<std::pair<SNode*, float>>, LessNode> searchList;
+
+        auto* currentNode = new SNode(startPos);
+        nodes[startPos] = currentNode;
+        SNode* foundNode = nullptr;
+        while (currentNode) {
+            if (static_cast<int>(nodes.size()) > maxComplexity) {
+                result = Otc::PathFindResultTooFar;
+                break;
+            }
+
+            if (currentNode->pos == goalPos && (!foundNode || currentNode->cost < foundNode->cost))
+                foundNode = currentNode;
+
+            if (foundNode && currentNode->totalCost >= foundNode->cost)
+                break;
+
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    if (i == 0 && j == 0)
+                        continue;
+
+                    const Position neighborPos = currentNode->pos.translated(i, j);
+                    if (neighborPos.x < 0 || neighborPos.y < 0) continue;
+
+                    const auto& mtile = g_minimap.getTile(neighborPos);
+                    const bool isNotWalkable = mtile.hasFlag(MinimapTileNotWalkable);
+                    const bool isNotPathable = mtile.hasFlag(MinimapTileNotPathable);
+                    const bool wasSeen = mtile.hasFlag(MinimapTileWasSeen) || isNotWalkable || isNotPathable;
+
+                    if (!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+                        continue;
+                    if (wasSeen) {
+                        if (neighborPos != goalPos && !(flags & Otc::PathFindAllowNonPathable) && isNotPathable)
+                            continue;
+                        if (!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
+                            continue;
+                    }
+
+                    const Otc::Direction walkDir = currentNode->pos.getDirectionFromPosition(neighborPos);
+                    const float walkFactor = walkDir >= Otc::NorthEast ? 3.0f : 1.0f;
+                    const float cost = currentNode->cost + (mtile.getSpeed() * walkFactor) / 100.0f;
+
+                    SNode* neighborNode;
+                    if (!nodes.contains(neighborPos)) {
+                        neighborNode = new SNode(neighborPos);
+                        nodes[neighborPos] = neighborNode;
+                    } else {
+                        neighborNode = nodes[neighborPos];
+                        if (neighborNode->cost <= cost)
+                            continue;
+                    }
+
+                    neighborNode->prev = currentNode;
+                    neighborNode->cost = cost;
+                    neighborNode->totalCost = neighborNode->cost + neighborPos.distance(goalPos);
+                    neighborNode->dir = walkDir;
+                    searchList.emplace(neighborNode, neighborNode->totalCost);
+                }
+            }
+
+            if (!searchList.empty()) {
+                currentNode = searchList.top().first;
+                searchList.pop();
+            } else
+                currentNode = nullptr;
+        }
+
+        if (foundNode) {
+            for (currentNode = foundNode; currentNode; currentNode = currentNode->prev)
+                dirs.push_back(currentNode->dir);
+            dirs.pop_back();
+            std::ranges::reverse(dirs);
+            result = Otc::PathFindResultOk;
+        }
+
+        for (const auto& it : nodes)
+            delete it.second;
+
+        return ret;
+    }
+
+    // the search Map::newFindPath ran before the shared search grid, with the visible nodes copied as findPathAsync gives them
+    PathFindResult findReferenceNewPath(const Position& start, const Position& goal, const std::vector<Node>& visibleNodes)
+    {
+        PathFindResult ret;
+        ret.start = start;
+        ret.destination = goal;
+
+        if (start == goal) {
+            ret.status = Otc::PathFindResultSamePosition;
+            return ret;
+        }
+
+        if (goal.z != start.z)
+            return ret;
+
+        if (g_map.isAwareOfPosition(goal)) {
+            const auto& goalTile = g_map.getTile(goal);
+            if (!goalTile || !goalTile->isWalkable())
+                return ret;
+        } else if (g_minimap.getTile(goal).hasFlag(MinimapTileNotWalkable))
+            return ret;
+
+        struct LessNode
+        {
+            bool operator()(const Node* a, const Node* b) const
+            {
+                return b->totalCost < a->totalCost;
+            }
+        };
+
+        stdext::map<Position, Node*, Position::Hasher> nodes;
+        std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
+
+        for (const auto& node : visibleNodes)
+            nodes.emplace(node.pos, new Node(node));
+
+        const auto& initNode = new Node{ .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 };
+        delete nodes[start];
+        nodes[start] = initNode;
+        searchList.push(initNode);
+
+        int limit = 50000;
+        const float distance = start.distance(goal);
+
+        const Node* dstNode = nullptr;
+        while (!searchList.empty() && --limit) {
+            Node* node = searchList.top();
+            searchList.pop();
+            if (node->pos == goal) {
+                dstNode = node;
+                break;
+            }
+            if (node->pos.distance(goal) > distance + 10000)
+                continue;
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    if (i == 0 && j == 0)
+                        continue;
+                    Position neighbor = node->pos.translated(i, j);
+                    if (neighbor.x < 0 || neighbor.y < 0) continue;
+                    auto it = nodes.find(neighbor);
+                    if (it == nodes.end()) {
+                        const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
+                        const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
+                        const bool isNotWalkable = tile.hasFlag(MinimapTileNotWalkable);
+                        const bool isNotPathable = tile.hasFlag(MinimapTileNotPathable);
+                        const bool isEmpty = tile.hasFlag(MinimapTileEmpty);
+                        float speed = tile.getSpeed();
+                        if ((isNotWalkable || isNotPathable || isEmpty) && neighbor != goal) {
+                            it = nodes.emplace(neighbor, nullptr).first;
+                        } else {
+                            if (!wasSeen)
+                                speed = 2000;
+                            it = nodes.emplace(neighbor, new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev = node,
+                                                                   .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 }).first;
+                        }
+                    }
+                    if (!it->second) // no way
+                        continue;
+
+                    if (it->second->unseen > 50)
+                        continue;
+
+                    const float diagonal = ((i == 0 || j == 0) ? 1.0f : 3.0f);
+                    float cost = it->second->cost * diagonal;
+                    cost += diagonal * (50.0f * std::max<float>(5.0f, it->second->pos.distance(goal))); // heuristic
+                    if (node->totalCost + cost + 50 < it->second->totalCost) {
+                        it->second->totalCost = node->totalCost + cost;
+                        it->second->prev = node;
+                        if (it->second->unseen)
+                            it->second->unseen = node->unseen + 1;
+                        it->second->distance = node->distance + 1;
+                        searchList.push(it->second);
+                    }
+                }
+            }
+        }
+
+        if (dstNode) {
+            while (dstNode && dstNode->prev) {
+                if (dstNode->unseen)
+                    ret.path.clear();
+                else
+                    ret.path.push_back(dstNode->prev->pos.getDirectionFromPosition(dstNode->pos));
+                dstNode = dstNode->prev;
+            }
+            std::reverse(ret.path.begin(), ret.path.end());
+            ret.status = Otc::PathFindResultOk;
+        }
+        ret.complexity = 50000 - limit;
+
+        for (const auto& node : nodes)
+            delete node.second;
+
+        return ret;
+    }
+
+    // the search Map::findEveryPath ran before the shared search grid
+    std::map<std::string, std::tuple<int, int, int, std::string>> findReferenceEveryPath(const Position& start, int maxDistance, const std::map<std::string, std::string>& params)
+    {
+        struct LessNode
+        {
+            bool operator()(Node* a, Node* b) const
+            {
+                return b->totalCost < a->totalCost;
+            }
+        };
+
+        const auto isSet = [&params](const std::string& name) {
+            const auto it = params.find(name);
+            return it != params.end() && it->second != "0" && it->second != "";
+        };
+        const bool ignoreLastCreature = isSet("ignoreLastCreature");
+        const bool ignoreCreatures = isSet("ignoreCreatures");
+        const bool ignoreNonPathable = isSet("ignoreNonPathable");
+        const bool ignoreNonWalkable = isSet("ignoreNonWalkable");
+        const bool ignoreStairs = isSet("ignoreStairs");
+        const bool ignoreCost = isSet("ignoreCost");
+        const bool allowUnseen = isSet("allowUnseen");
+        const bool allowOnlyVisibleTiles = isSet("allowOnlyVisibleTiles");
+        const bool hasMargin = params.contains("marginMin") || params.contains("marginMax");
+
+        Position destPos;
+        if (const auto it = params.find("destination"); it != params.end()) {
+            const auto& pos = stdext::split<int32_t>(it->second, ",");
+            if (pos.size() == 3)
+                destPos = Position(pos[0], pos[1], pos[2]);
+        }
+
+        Position maxDistanceFromPos;
+        int maxDistanceFrom = 0;
+        if (const auto it = params.find("maxDistanceFrom"); it != params.end()) {
+            const auto& pos = stdext::split<int32_t>(it->second, ",");
+            if (pos.size() == 4) {
+                maxDistanceFromPos = Position(pos[0], pos[1], pos[2]);
+                maxDistanceFrom = pos[3];
+            }
+        }
+
+        std::map<std::string, std::tuple<int, int, int, std::string>> ret;
+        std::unordered_map<Position, Node*, Position::Hasher> nodes;
+        std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
+
+        Node* initNode = new Node{ 1, 0, start, nullptr, 0, 0 };
+        nodes[start] = initNode;
+        searchList.push(initNode);
+
+        while (!searchList.empty()) {
+            Node* node = searchList.top();
+            searchList.pop();
+            ret[node->pos.toString()] = std::make_tuple(node->totalCost, node->distance,
+                                                        node->prev ? node->prev->pos.getDirectionFromPosition(node->pos) : -1,
+                                                        node->prev ? node->prev->pos.toString() : "");
+            if (node->pos == destPos) {
+                if (hasMargin)
+                    maxDistance = std::min<int>(node->distance + 4, maxDistance);
+                else
+                    break;
+            }
+            if (node->distance >= maxDistance)
+                continue;
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    if (i == 0 && j == 0)
+                        continue;
+                    Position neighbor = node->pos.translated(i, j);
+                    if (neighbor.x < 0 || neighbor.y < 0) continue;
+                    auto it = nodes.find(neighbor);
+                    if (it == nodes.end()) {
+                        bool wasSeen = false;
+                        bool hasCreature = false;
+                        bool isNotWalkable = true;
+                        bool isNotPathable = true;
+                        int mapColor = 0;
+                        int speed = 1000;
+                        if (g_map.isAwareOfPosition(neighbor)) {
+                            if (const TilePtr& tile = g_map.getTile(neighbor)) {
+                                wasSeen = true;
+                                hasCreature = tile->hasBlockingCreature();
+                                isNotWalkable = !tile->isWalkable(true);
+                                isNotPathable = !tile->isPathable();
+                                mapColor = tile->getMinimapColorByte();
+                                speed = tile->getGroundSpeed();
+                            }
+                        } else if (!allowOnlyVisibleTiles) {
+                            const MinimapTile& mtile = g_minimap.getTile(neighbor);
+                            wasSeen = mtile.hasFlag(MinimapTileWasSeen);
+                            isNotWalkable = mtile.hasFlag(MinimapTileNotWalkable);
+                            isNotPathable = mtile.hasFlag(MinimapTileNotPathable);
+                            mapColor = mtile.color;
+                            if (isNotWalkable || isNotPathable)
+                                wasSeen = true;
+                            speed = mtile.getSpeed();
+                        }
+                        const bool hasStairs = isNotPathable && mapColor >= 210 && mapColor <= 213;
+                        const bool hasReachedMaxDistance = maxDistanceFrom && maxDistanceFromPos.isValid() && maxDistanceFromPos.distance(neighbor) > maxDistanceFrom;
+                        if ((!wasSeen && !allowUnseen) || (hasStairs && !ignoreStairs && neighbor != destPos) ||
+                            (isNotPathable && !ignoreNonPathable && neighbor != destPos) || (isNotWalkable && !ignoreNonWalkable) ||
+                            hasReachedMaxDistance) {
+                            it = nodes.emplace(neighbor, nullptr).first;
+                        } else if (hasCreature && !ignoreCreatures) {
+                            it = nodes.emplace(neighbor, nullptr).first;
+                            if (ignoreLastCreature) {
+                                ret[neighbor.toString()] = std::make_tuple(node->totalCost + 100, node->distance + 1,
+                                                                           node->pos.getDirectionFromPosition(neighbor),
+                                                                           node->pos.toString());
+                            }
+                        } else {
+                            it = nodes.emplace(neighbor, new Node{ static_cast<float>(speed), 10000000.0f, neighbor, node, node->distance + 1, wasSeen ? 0 : 1 }).first;
+                        }
+                    }
+
+                    if (!it->second)
+                        continue;
+
+                    const float diagonal = ((i == 0 || j == 0) ? 1.0f : 3.0f);
+                    float cost = it->second->cost * diagonal;
+                    if (ignoreCost)
+                        cost = 1;
+                    if (node->totalCost + cost < it->second->totalCost) {
+                        it->second->totalCost = node->totalCost + cost;
+                        it->second->prev = node;
+                        if (it->second->unseen)
+                            it->second->unseen = node->unseen + 1;
+                        it->second->distance = node->distance + 1;
+                        searchList.push(it->second);
+                    }
+                }
+            }
+        }
+
+        for (const auto& node : nodes)
+            delete node.second;
+
+        return ret;
+    }
+
+    // the cost findPath gives a path, or -1 when it does not lead to the goal
+    float getPathCost(Position pos, const std::vector<Otc::Direction>& dirs, const Position& goalPos)
+    {
+        float cost = 0;
+        for (const auto dir : dirs) {
+            pos = pos.translatedToDirection(dir);
+            cost += g_minimap.getTile(pos).getSpeed() * (dir >= Otc::NorthEast ? 3.0f : 1.0f) / 100.0f;
+        }
+        return pos == goalPos ? cost : -1;
+    }
+}
+
+void PathFindCheck::setTile(const Position& pos, const MinimapTile& tile)
+{
+    g_minimap.getBlock(pos).updateTile(pos.x, pos.y, tile);
+}
+
+bool PathFindCheck::run(const int grids, const int seed)
+{
+    if (g_map.isAwareOfPosition(origin)) {
+        g_logger.error("Path find check: the check area is on the map of a game");
+        return false;
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> sizes(10, MAX_AREA_SIZE - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    int found = 0, tooFar = 0, mismatches = 0, jumpPointMismatches = 0, newPathMismatches = 0, everyPathMismatches = 0;
+    ticks_t referenceTime = 0, plainTime = 0, jumpPointTime = 0, referenceNewTime = 0, newTime = 0, referenceEveryTime = 0, everyTime = 0;
+
+    for (int grid = 0; grid < grids; ++grid) {
+        // open areas, mixed ground speeds, a few slow tiles or rooms with walls, all closed by a border
+        const int width = sizes(rng), height = sizes(rng);
+        const int mode = percent(rng) % 4;
+        const int density = percent(rng) % 40;
+
+        for (int y = -1; y <= MAX_AREA_SIZE; ++y) {
+            for (int x = -1; x <= MAX_AREA_SIZE; ++x) {
+                MinimapTile tile;
+                tile.flags = MinimapTileWasSeen;
+                if (x < 0 || y < 0 || x >= width || y >= height || percent(rng) < density)
+                    tile.flags |= MinimapTileNotWalkable;
+                else {
+                    if (mode == 1)
+                        tile.speed = 10 + (percent(rng) % 3) * 5;
+                    else if (mode == 2 && percent(rng) < 10)
+                        tile.speed = 25;
+
+                    // stairs are non pathable tiles of these colors, findEveryPath can ignore them
+                    if (percent(rng) < 3) {
+                        tile.flags |= MinimapTileNotPathable;
+                        if (percent(rng) < 50)
+                            tile.color = 210 + percent(rng) % 4;
+                    } else if (percent(rng) < 3)
+                        tile.flags = 0;
+
+                    if (mode == 3 && (x % 7 == 0 || y % 5 == 0) && percent(rng) % 6)
+                        tile.flags |= MinimapTileNotWalkable;
+                }
+                setTile(origin.translated(x, y), tile);
+            }
+        }
+
+        const Position startPos = origin.translated(percent(rng) % width, percent(rng) % height);
+        const Position goalPos = origin.translated(percent(rng) % width, percent(rng) % height);
+        setTile(startPos, { .flags = MinimapTileWasSeen });
+
+        const int flags = (percent(rng) < 50 ? Otc::PathFindAllowNotSeenTiles : 0) | (percent(rng) < 50 ? Otc::PathFindAllowNonPathable : 0);
+        const int maxComplexity = percent(rng) < 25 ? 50 + percent(rng) * 5 : 100000;
+
+        ticks_t start = stdext::micros();
+        const auto [referenceDirs, referenceResult] = findReferencePath(startPos, goalPos, maxComplexity, flags);
+        referenceTime += stdext::micros() - start;
+
+        start = stdext::micros();
+        const auto [dirs, result] = g_map.findPath(startPos, goalPos, maxComplexity, flags);
+        plainTime += stdext::micros() - start;
+
+        if (dirs != referenceDirs || result != referenceResult) {
+            g_logger.error("Path find check: grid {} from {} to {} with flags {} gives {} steps ({}) instead of {} steps ({})",
+                           grid, startPos.toString(), goalPos.toString(), flags, dirs.size(), static_cast<int>(result), referenceDirs.size(), static_cast<int>(referenceResult));
+            ++mismatches;
+        }
+
+        // findPathAsync gives the tiles of the map, the blocked ones without a cost to go through; the check area has none
+        const auto& visibleNodes = std::make_shared<std::vector<Node>>();
+        for (int i = percent(rng) % 20; i > 0; --i) {
+            const Position pos = origin.translated(percent(rng) % width, percent(rng) % height);
+            if (pos == startPos)
+                continue;
+
+            const bool blocked = pos != goalPos && percent(rng) < 50;
+            visibleNodes->push_back({ .cost = 100, .totalCost = blocked ? 0 : 10000000.0f, .pos = pos, .prev = nullptr, .distance = 0, .unseen = 0 });
+        }
+
+        start = stdext::micros();
+        const auto& referenceNewPath = findReferenceNewPath(startPos, goalPos, *visibleNodes);
+        referenceNewTime += stdext::micros() - start;
+
+        start = stdext::micros();
+        const auto& newPath = g_map.newFindPath(startPos, goalPos, visibleNodes);
+        newTime += stdext::micros() - start;
+
+        if (newPath->status != referenceNewPath.status || newPath->path != referenceNewPath.path || newPath->complexity != referenceNewPath.complexity) {
+            g_logger.error("Path find check: grid {} from {} to {} with newFindPath gives {} steps ({}, complexity {}) instead of {} steps ({}, complexity {})",
+                           grid, startPos.toString(), goalPos.toString(), newPath->path.size(), static_cast<int>(newPath->status), newPath->complexity,
+                           referenceNewPath.path.size(), static_cast<int>(referenceNewPath.status), referenceNewPath.complexity);
+            ++newPathMismatches;
+        }
+
+        std::map<std::string, std::string> params;
+        for (const auto* name : { "ignoreNonPathable", "ignoreNonWalkable", "ignoreStairs", "ignoreCost", "allowUnseen" }) {
+            if (percent(rng) < 30)
+                params[name] = "1";
+        }
+        if (percent(rng) < 50)
+            params["destination"] = fmt::format("{},{},{}", goalPos.x, goalPos.y, goalPos.z);
+        if (percent(rng) < 25)
+            params["marginMin"] = "1";
+        if (percent(rng) < 25)
+            params["maxDistanceFrom"] = fmt::format("{},{},{},{}", startPos.x, startPos.y, startPos.z, 5 + percent(rng) % 20);
+        const int maxDistance = 5 + percent(rng) % 60;
+
+        start = stdext::micros();
+        const auto& referenceEveryPath = findReferenceEveryPath(startPos, maxDistance, params);
+        referenceEveryTime += stdext::micros() - start;
+
+        start = stdext::micros();
+        const auto& everyPath = g_map.findEveryPath(startPos, maxDistance, params);
+        everyTime += stdext::micros() - start;
+
+        if (everyPath != referenceEveryPath) {
+            g_logger.error("Path find check: grid {} from {} up to {} tiles with findEveryPath reaches {} positions instead of {}, or by other steps",
+                           grid, startPos.toString(), maxDistance, everyPath.size(), referenceEveryPath.size());
+            ++everyPathMismatches;
+        }
+
+        if (referenceResult == Otc::PathFindResultTooFar) {
+            ++tooFar;
+            continue;
+        }
+
+        // jump points count the nodes differently, so they search without a limit
+        start = stdext::micros();
+        const auto [jumpDirs, jumpResult] = g_map.findPath(startPos, goalPos, 100000, flags | Otc::PathFindJumpPoints);
+        jumpPointTime += stdext::micros() - start;
+
+        if (jumpResult != referenceResult) {
+            g_logger.error("Path find check: grid {} from {} to {} with jump points gives result {} instead of {}",
+                           grid, startPos.toString(), goalPos.toString(), static_cast<int>(jumpResult), static_cast<int>(referenceResult));
+            ++jumpPointMismatches;
+        } else if (referenceResult == Otc::PathFindResultOk) {
+            ++found;
+            const float referenceCost = getPathCost(startPos, referenceDirs, goalPos);
+            const float jumpCost = getPathCost(startPos, jumpDirs, goalPos);
+            if (jumpCost < 0 || std::abs(jumpCost - referenceCost) > 0.001f) {
+                g_logger.error("Path find check: grid {} from {} to {} with jump points costs {} instead of {}",
+                               grid, startPos.toString(), goalPos.toString(), jumpCost, referenceCost);
+                ++jumpPointMismatches;
+            }
+        }
+    }
+
+    // the check area is empty again
+    for (int y = -1; y <= MAX_AREA_SIZE; ++y) {
+        for (int x = -1; x <= MAX_AREA_SIZE; ++x)
+            setTile(origin.translated(x, y), {});
+    }
+
+    std::cout << fmt::format("{} grids (seed {}), {} paths found, {} too far\n", grids, seed, found, tooFar);
+    std::cout << fmt::format("{} plain searches differ, {} jump point searches differ\n", mismatches, jumpPointMismatches);
+    std::cout << fmt::format("{} newFindPath searches differ, {} findEveryPath searches differ\n", newPathMismatches, everyPathMismatches);
+    std::cout << fmt::format("reference {:.3f} ms, plain {:.3f} ms, jump points {:.3f} ms\n", referenceTime / 1000.0, plainTime / 1000.0, jumpPointTime / 1000.0);
+    std::cout << fmt::format("newFindPath: reference {:.3f} ms, grid {:.3f} ms; findEveryPath: reference {:.3f} ms, grid {:.3f} ms\n",
+                             referenceNewTime / 1000.0, newTime / 1000.0, referenceEveryTime / 1000.0, everyTime / 1000.0);
+    return mismatches == 0 && jumpPointMismatches == 0 && newPathMismatches == 0 && everyPathMismatches == 0;
+}
@@ -27,6 +27,8 @@
 #include <framework/net/packet_player.h>
 #include <framework/net/packet_recorder.h>
 
+std::bitset<256> ProtocolGame::m_luaOpcodes;
+
 void ProtocolGame::login(const std::string_view accountName, const std::string_view accountPassword, const std::string_view host, uint16_t port,
                          const std::string_view characterName, const std::string_view authenticatorToken, const std::string_view sessionKey)
 {
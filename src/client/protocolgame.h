@@ -25,8 +25,17 @@
 #include "creature.h"
 #include "declarations.h"
 #include "protocolcodes.h"
+#include <bitset>
 #include <framework/net/protocol.h>
 
+struct OpcodeParseStats
+{
+    uint64_t count{ 0 };
+    uint64_t nanoseconds{ 0 };
+};
+
+using OpcodeParseStatsArray = std::array<OpcodeParseStats, 256>;
+
 class ProtocolGame final : public Protocol
 {
 public:
@@ -164,6 +173,13 @@ public:
     // otclient only
     void sendChangeMapAwareRange(uint8_t xrange, uint8_t yrange);
 
+    // opcodes handled by lua (ProtocolGame.registerOpcode), the others never leave C++
+    static void setLuaOpcode(const uint8_t opcode, const bool enabled) { m_luaOpcodes.set(opcode, enabled); }
+    static bool isLuaOpcode(const uint8_t opcode) { return m_luaOpcodes.test(opcode); }
+
+    // per opcode parse timings, disabled when null
+    void setParseStats(OpcodeParseStatsArray* stats) { m_parseStats = stats; }
+
 protected:
     void onConnect() override;
     void onRecv(const InputMessagePtr& inputMessage) override;
@@ -171,6 +187,7 @@ protected:
     void onSend() override;
 
     friend class Game;
+    friend class ReplayBenchmark;
 
 public:
     void addPosition(const OutputMessagePtr& msg, const Position& position);
@@ -390,4 +407,7 @@ private:
     std::string m_sessionKey;
     std::string m_characterName;
     LocalPlayerPtr m_localPlayer;
+    OpcodeParseStatsArray* m_parseStats{ nullptr };
+
+    static std::bitset<256> m_luaOpcodes;
 };
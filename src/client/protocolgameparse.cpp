@@ -43,6 +43,7 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
 
     try {
         while (!msg->eof()) {
+            const auto opcodeStart = m_parseStats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
             opcode = msg->getU8();
 
             // must be > so extended will be enabled before GameStart.
@@ -53,13 +54,15 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
                 }
             }
 
-            // try to parse in lua first
-            const int readPos = msg->getReadPos();
-            if (callLuaField<bool>("onOpcode", opcode, msg)) {
-                continue;
+            // try to parse in lua first, only for opcodes registered by modules
+            if (m_luaOpcodes.test(opcode)) {
+                const int readPos = msg->getReadPos();
+                if (callLuaField<bool>("onOpcode", opcode, msg)) {
+                    continue;
+                }
+                // restore read pos
+                msg->setReadPos(readPos);
             }
-            msg->setReadPos(readPos);
-            // restore read pos
 
             switch (opcode) {
                 case Proto::GameServerLoginOrPendingState:
@@ -604,6 +607,12 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
                 default:
                     throw Exception("unhandled opcode {}", opcode);
             }
+
+            if (m_parseStats) {
+                auto& stats = (*m_parseStats)[opcode];
+                ++stats.count;
+                stats.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - opcodeStart).count();
+            }
             prevOpcode = opcode;
         }
     } catch (const stdext::exception& e) {
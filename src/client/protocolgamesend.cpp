@@ -25,6 +25,9 @@
 #include "protocolgame.h"
 #include <framework/util/crypt.h>
 
+// the value servers with packet compression look for after the login challenge
+constexpr uint32_t PACKET_COMPRESSION_MAGIC = 0x5A43FFFF;
+
 void ProtocolGame::onSend() {}
 void ProtocolGame::sendExtendedOpcode(const uint8_t opcode, const std::string& buffer)
 {
@@ -96,6 +99,11 @@ void ProtocolGame::sendLoginPacket(const uint32_t challengeTimestamp, const uint
         msg->addU8(challengeRandom);
     }
 
+    // tells the server this client takes sequenced, possibly compressed packets. the low bytes read as a string
+    // length longer than the rsa block, so the server never takes extended login data or padding for it
+    if (g_game.getFeature(Otc::GamePacketCompression))
+        msg->addU32(PACKET_COMPRESSION_MAGIC);
+
     const auto& extended = callLuaField<std::string>("getLoginExtendedData");
     if (!extended.empty())
         msg->addString(extended);
@@ -117,7 +125,7 @@ void ProtocolGame::sendLoginPacket(const uint32_t challengeTimestamp, const uint
     if (g_game.getFeature(Otc::GameLoginPacketEncryption))
         enableXteaEncryption();
 
-    if (g_game.getFeature(Otc::GameSequencedPackets))
+    if (g_game.getFeature(Otc::GameSequencedPackets) || g_game.getFeature(Otc::GamePacketCompression))
         enabledSequencedPackets();
 }
 
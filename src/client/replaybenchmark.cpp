@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "replaybenchmark.h"
+#include "game.h"
+#include "localplayer.h"
+
+#include <framework/core/eventdispatcher.h>
+#include <framework/net/packet_player.h>
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+#endif
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{ 0 };
+}
+
+#if defined(REPLAY_WRAP_MALLOC)
+// otclient_replay links with --wrap=malloc and a static libstdc++, so operator new reaches these
+// too, the allocator itself is left alone
+extern "C" {
+    void* __real_malloc(size_t size);
+    void* __real_calloc(size_t count, size_t size);
+    void* __real_realloc(void* ptr, size_t size);
+
+    void* __wrap_malloc(const size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        return __real_malloc(size);
+    }
+
+    void* __wrap_calloc(const size_t count, const size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        return __real_calloc(count, size);
+    }
+
+    void* __wrap_realloc(void* ptr, const size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        return __real_realloc(ptr, size);
+    }
+}
+
+constexpr bool ALLOCATIONS_COUNTED = true;
+#elif defined(_MSC_VER) && defined(_DEBUG)
+namespace
+{
+    int countAllocation(const int type, void*, size_t, int, long, const unsigned char*, int)
+    {
+        if (type == _HOOK_ALLOC || type == _HOOK_REALLOC)
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+        return TRUE;
+    }
+}
+
+constexpr bool ALLOCATIONS_COUNTED = true;
+#else
+constexpr bool ALLOCATIONS_COUNTED = false;
+#endif
+
+bool ReplayBenchmark::run(const std::string_view& file)
+{
+    if (g_game.getProtocolVersion() == 0) {
+        g_logger.error("Replay benchmark needs a valid game protocol version.");
+        return false;
+    }
+
+    const auto player = std::make_shared<PacketPlayer>(file);
+    const auto& packets = player->getInputPackets();
+    if (packets.empty()) {
+        g_logger.error("Replay benchmark: no packets found in record '{}'.", file);
+        return false;
+    }
+
+    // same game state as Game::playRecord, without the real time player
+    g_game.resetGameStates();
+    g_game.m_localPlayer = std::make_shared<LocalPlayer>();
+    g_game.m_localPlayer->setName("Player");
+
+    const auto protocol = std::make_shared<ProtocolGame>();
+    protocol->m_localPlayer = g_game.m_localPlayer;
+    protocol->setParseStats(&m_stats);
+    g_game.m_protocolGame = protocol;
+
+    m_stats = {};
+
+#if !defined(REPLAY_WRAP_MALLOC) && defined(_MSC_VER) && defined(_DEBUG)
+    const auto previousHook = _CrtSetAllocHook(countAllocation);
+#endif
+
+    size_t bytes = 0;
+    ticks_t elapsed = 0;
+    uint64_t allocations = 0;
+    for (const auto& [time, packet] : packets) {
+        const uint64_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        const ticks_t start = stdext::micros();
+        protocol->recvPacket(*packet);
+        elapsed += stdext::micros() - start;
+        allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        bytes += packet->size();
+
+        // run what the parser scheduled, outside of the measured time
+        g_dispatcher.poll();
+    }
+
+#if !defined(REPLAY_WRAP_MALLOC) && defined(_MSC_VER) && defined(_DEBUG)
+    _CrtSetAllocHook(previousHook);
+#endif
+
+    protocol->setParseStats(nullptr);
+    g_game.processDisconnect();
+
+    report(packets.size(), bytes, elapsed, allocations);
+    return true;
+}
+
+void ReplayBenchmark::report(const size_t packets, const size_t bytes, const ticks_t elapsedMicros, const uint64_t allocations) const
+{
+    const double seconds = std::max<ticks_t>(elapsedMicros, 1) / 1000000.0;
+
+    std::cout << fmt::format("{} packets ({} bytes) parsed in {:.3f} ms\n", packets, bytes, elapsedMicros / 1000.0);
+    std::cout << fmt::format("{:.0f} packets/s, {:.2f} MB/s\n", packets / seconds, bytes / seconds / (1024 * 1024));
+    if constexpr (ALLOCATIONS_COUNTED)
+        std::cout << fmt::format("{:.2f} allocations/packet\n", static_cast<double>(allocations) / packets);
+
+    std::vector<uint8_t> opcodes;
+    for (size_t opcode = 0; opcode < m_stats.size(); ++opcode) {
+        if (m_stats[opcode].count > 0)
+            opcodes.push_back(static_cast<uint8_t>(opcode));
+    }
+
+    std::ranges::sort(opcodes, [this](const uint8_t a, const uint8_t b) {
+        return m_stats[a].nanoseconds > m_stats[b].nanoseconds;
+    });
+
+    std::cout << "opcode      count    total ms    avg us\n";
+    for (const uint8_t opcode : opcodes) {
+        const auto& stats = m_stats[opcode];
+        std::cout << fmt::format("0x{:02X} {:>12} {:>11.3f} {:>9.2f}\n", opcode, stats.count,
+                                 stats.nanoseconds / 1000000.0, stats.nanoseconds / 1000.0 / stats.count);
+    }
+}
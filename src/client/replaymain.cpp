@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "client.h"
+#include "game.h"
+#include "gameconfig.h"
+#include "replaybenchmark.h"
+#include "thingtypemanager.h"
+
+#include <framework/core/eventdispatcher.h>
+#include <framework/core/graphicalapplication.h>
+#include <framework/core/resourcemanager.h>
+#include <framework/platform/platform.h>
+
+// Entry point of otclient_replay, a console tool that parses a .cam record through ProtocolGame.
+// It sets up the dispatcher, lua and the things without creating the window or the graphics context,
+// and no module is loaded, so the parser callbacks have nothing to call.
+int main(const int argc, const char* argv[])
+{
+    std::vector<std::string> args(argv, argv + argc);
+    if (args.size() < 4) {
+        std::cerr << "usage: otclient_replay <record> <version> <things path>\n";
+        return 1;
+    }
+
+    g_platform.init(args);
+    g_resources.init(args[0].data());
+    if (!g_resources.discoverWorkDir("init.lua")) {
+        g_logger.error("Unable to find work directory.");
+        return 1;
+    }
+
+    // only the framework part of the application init, GraphicalApplication::init opens the window
+    g_app.Application::init(args, new GraphicalApplicationContext(g_gameConfig.getSpriteSize(), nullptr));
+    g_client.init(args);
+
+    const uint16_t version = stdext::unsafe_cast<uint16_t>(args[2]);
+    g_game.setProtocolVersion(version);
+    g_game.setClientVersion(version);
+
+    const bool thingsLoaded = version >= 1281 ? g_things.loadAppearances(args[3]) : g_things.loadDat(args[3]);
+    if (!thingsLoaded) {
+        g_logger.error("Unable to load the things of version {} from '{}'.", version, args[3]);
+        return 1;
+    }
+
+    const bool success = ReplayBenchmark().run(args[1]);
+
+    g_client.terminate();
+    g_dispatcher.shutdown();
+    return success ? 0 : 1;
+}
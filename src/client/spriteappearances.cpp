@@ -32,6 +32,11 @@
 
 #include "lzma.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPRITEAPPEARANCES_SSE2
+#include <emmintrin.h>
+#endif
+
  // warnings related to protobuf
  // https://android.googlesource.com/platform/external/protobuf/+/brillo-m9-dev/vsprojects/readme.txt
 
@@ -39,6 +44,37 @@ using json = nlohmann::json;
 
 SpriteAppearances g_spriteAppearances;
 
+namespace
+{
+    // BGRA to RGBA with the magenta (0xFF00FF) key made fully transparent, in one pass
+    void convertSheetRow(const uint8_t* src, uint8_t* dst)
+    {
+        size_t offset = 0;
+#ifdef SPRITEAPPEARANCES_SSE2
+        const __m128i redBlueMask = _mm_set1_epi32(0x00FF00FF);
+        const __m128i magenta = _mm_set1_epi32(0x00FF00FF);
+        for (; offset + 16 <= SPRITE_SHEET_WIDTH_BYTES; offset += 16) {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+            const __m128i redBlue = _mm_and_si128(pixels, redBlueMask);
+            const __m128i swapped = _mm_or_si128(_mm_andnot_si128(redBlueMask, pixels), _mm_or_si128(_mm_slli_epi32(redBlue, 16), _mm_srli_epi32(redBlue, 16)));
+            const __m128i isMagenta = _mm_cmpeq_epi32(pixels, magenta);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset), _mm_andnot_si128(isMagenta, swapped));
+        }
+#endif
+        for (; offset < SPRITE_SHEET_WIDTH_BYTES; offset += 4) {
+            uint32_t pixel;
+            std::memcpy(&pixel, src + offset, 4);
+            if (pixel == 0xFF00FF) {
+                pixel = 0;
+            } else {
+                const uint32_t redBlue = pixel & 0x00FF00FF;
+                pixel = (pixel & 0xFF00FF00) | (redBlue << 16) | (redBlue >> 16);
+            }
+            std::memcpy(dst + offset, &pixel, 4);
+        }
+    }
+}
+
 void SpriteAppearances::init()
 {
     // in tibia 12.81 there is currently 3482 sheets
@@ -50,15 +86,30 @@ void SpriteAppearances::terminate()
     unload();
 }
 
-bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
+bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet)
 {
-    if (sheet->data)
-        return true;
+    return getSheetData(sheet) != nullptr;
+}
 
-    std::scoped_lock lock(sheet->m_mutex);
+std::shared_ptr<uint8_t[]> SpriteAppearances::getSheetData(const SpriteSheetPtr& sheet)
+{
+    std::shared_ptr<uint8_t[]> data;
+    {
+        std::scoped_lock lock(sheet->m_mutex);
+        if (!sheet->data && !decodeSpriteSheet(*sheet))
+            return nullptr;
 
+        data = sheet->data;
+    }
+
+    touchSheet(*sheet);
+    return data;
+}
+
+bool SpriteAppearances::decodeSpriteSheet(SpriteSheet& sheet) const
+{
     try {
-        const auto& path = fmt::format("{}{}", g_spriteAppearances.getPath(), sheet->file);
+        const auto& path = fmt::format("{}{}", m_path, sheet.file);
         if (!g_resources.fileExists(path))
             return false;
 
@@ -123,65 +174,113 @@ bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
         lzma_end(&stream); // free memory
 
         // pixel data start (bmp header end offset)
-        uint32_t data;
-        std::memcpy(&data, decompressed.get() + 10, sizeof(uint32_t));
-
-        uint8_t* bufferStart = decompressed.get() + data;
-
-        // reverse channels
-        for (uint8_t* itr = bufferStart; itr < bufferStart + BYTES_IN_SPRITE_SHEET; itr += 4) {
-            std::swap(*(itr + 0), *(itr + 2));
+        uint32_t dataOffset;
+        std::memcpy(&dataOffset, decompressed.get() + 10, sizeof(uint32_t));
+        if (dataOffset > LZMA_UNCOMPRESSED_SIZE - BYTES_IN_SPRITE_SHEET) {
+            throw stdext::exception(fmt::format("invalid bmp pixel offset {}", dataOffset));
         }
 
-        // flip vertically
-        for (int y = 0; y < 192; ++y) {
-            uint8_t* itr1 = &bufferStart[y * SPRITE_SHEET_WIDTH_BYTES];
-            uint8_t* itr2 = &bufferStart[(SpriteSheet::SIZE - y - 1) * SPRITE_SHEET_WIDTH_BYTES];
-
-            for (std::size_t x = 0; x < SPRITE_SHEET_WIDTH_BYTES; ++x) {
-                std::swap(*(itr1 + x), *(itr2 + x));
-            }
-        }
+        const auto data = std::make_shared<uint8_t[]>(BYTES_IN_SPRITE_SHEET);
+        const uint8_t* bufferStart = decompressed.get() + dataOffset;
 
-        // fix magenta
-        for (int offset = 0; offset < BYTES_IN_SPRITE_SHEET; offset += 4) {
-            std::memcpy(&data, bufferStart + offset, 4);
-            if (data == 0xFF00FF) {
-                std::memset(bufferStart + offset, 0x00, 4);
-            }
+        // bmp rows are stored bottom up, flip while copying
+        for (int y = 0; y < SpriteSheet::SIZE; ++y) {
+            convertSheetRow(bufferStart + (SpriteSheet::SIZE - y - 1) * SPRITE_SHEET_WIDTH_BYTES, data.get() + y * SPRITE_SHEET_WIDTH_BYTES);
         }
 
-        sheet->data = std::make_unique<uint8_t[]>(LZMA_UNCOMPRESSED_SIZE);
-        std::memcpy(sheet->data.get(), bufferStart, BYTES_IN_SPRITE_SHEET);
-
+        sheet.data = data;
         return true;
     } catch (const std::exception& e) {
-        g_logger.error("Failed to load single sprite sheet '{}': {}", sheet->file, e.what());
+        g_logger.error("Failed to load single sprite sheet '{}': {}", sheet.file, e.what());
         return false;
     }
 }
 
 void SpriteAppearances::unload()
 {
+    {
+        std::scoped_lock lock(m_loadedSheetsMutex);
+        m_loadedSheets.clear();
+    }
+
     m_spritesCount = 0;
     m_sheets.clear();
 }
 
+void SpriteAppearances::addSpriteSheet(const SpriteSheetPtr& sheet)
+{
+    // the catalog is usually already sorted, so this mostly appends
+    const auto it = std::ranges::upper_bound(m_sheets, sheet->firstId, {}, [](const SpriteSheetPtr& s) { return s->firstId; });
+    m_sheets.emplace(it, sheet);
+}
+
+void SpriteAppearances::touchSheet(SpriteSheet& sheet)
+{
+    std::scoped_lock lock(m_loadedSheetsMutex);
+
+    sheet.lastUsage = stdext::millis();
+    if (sheet.cached) {
+        m_loadedSheets.splice(m_loadedSheets.begin(), m_loadedSheets, sheet.lruIterator);
+        return;
+    }
+
+    sheet.lruIterator = m_loadedSheets.insert(m_loadedSheets.begin(), &sheet);
+    sheet.cached = true;
+
+    while (m_loadedSheets.size() > m_maxLoadedSheets)
+        evictSheet(*m_loadedSheets.back());
+}
+
+void SpriteAppearances::evictSheet(SpriteSheet& sheet)
+{
+    // images still being built keep their own reference to the pixels
+    {
+        std::scoped_lock lock(sheet.m_mutex);
+        sheet.data = nullptr;
+    }
+
+    m_loadedSheets.erase(sheet.lruIterator);
+    sheet.cached = false;
+}
+
+void SpriteAppearances::setMaxLoadedSheets(const size_t count)
+{
+    std::scoped_lock lock(m_loadedSheetsMutex);
+
+    m_maxLoadedSheets = std::max<size_t>(count, 1);
+    while (m_loadedSheets.size() > m_maxLoadedSheets)
+        evictSheet(*m_loadedSheets.back());
+}
+
+size_t SpriteAppearances::getLoadedSheetsCount()
+{
+    std::scoped_lock lock(m_loadedSheetsMutex);
+    return m_loadedSheets.size();
+}
+
+void SpriteAppearances::unloadIdleSheets(const ticks_t idleTime)
+{
+    std::scoped_lock lock(m_loadedSheetsMutex);
+
+    const ticks_t now = stdext::millis();
+    while (!m_loadedSheets.empty() && now - m_loadedSheets.back()->lastUsage > idleTime)
+        evictSheet(*m_loadedSheets.back());
+}
+
 SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(const int id, const bool load /* = true */)
 {
     if (id == 0) {
         return nullptr;
     }
 
-    // find sheet
-    const auto sheetIt = std::ranges::find_if(m_sheets, [=](const SpriteSheetPtr& sheet) {
-        return id >= sheet->firstId && id <= sheet->lastId;
-    });
-
-    if (sheetIt == m_sheets.end())
+    // last sheet starting at or before the id
+    auto sheetIt = std::ranges::upper_bound(m_sheets, id, {}, [](const SpriteSheetPtr& sheet) { return sheet->firstId; });
+    if (sheetIt == m_sheets.begin())
         return nullptr;
 
-    const auto& sheet = *sheetIt;
+    const auto& sheet = *--sheetIt;
+    if (id > sheet->lastId)
+        return nullptr;
 
     if (load && !loadSpriteSheet(sheet))
         return nullptr;
@@ -192,11 +291,16 @@ SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(const int id, const bool lo
 ImagePtr SpriteAppearances::getSpriteImage(const int id)
 {
     try {
-        const auto& sheet = getSheetBySpriteId(id);
+        const auto& sheet = getSheetBySpriteId(id, false);
         if (!sheet) {
             return nullptr;
         }
 
+        const auto& sheetData = getSheetData(sheet);
+        if (!sheetData) {
+            return nullptr;
+        }
+
         const Size& size = sheet->getSpriteSize();
 
         const auto& image = std::make_shared<Image>(size);
@@ -210,7 +314,7 @@ ImagePtr SpriteAppearances::getSpriteImage(const int id)
         const int spriteWidthBytes = size.width() * 4;
 
         for (int height = size.height() * spriteRow, offset = 0; height < size.height() + (spriteRow * size.height()); height++, offset++) {
-            std::memcpy(&pixelData[offset * spriteWidthBytes], &sheet->data[(height * SPRITE_SHEET_WIDTH_BYTES) + (spriteColumn * spriteWidthBytes)], spriteWidthBytes);
+            std::memcpy(&pixelData[offset * spriteWidthBytes], &sheetData[(height * SPRITE_SHEET_WIDTH_BYTES) + (spriteColumn * spriteWidthBytes)], spriteWidthBytes);
         }
 
         if (!image->hasTransparentPixel()) {
@@ -240,14 +344,17 @@ void SpriteAppearances::saveSpriteToFile(const int id, const std::string& file)
 
 void SpriteAppearances::saveSheetToFileBySprite(const int id, const std::string& file)
 {
-    if (const auto& sheet = getSheetBySpriteId(id)) {
-        Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
-        image.savePNG(file);
+    if (const auto& sheet = getSheetBySpriteId(id, false)) {
+        saveSheetToFile(sheet, file);
     }
 }
 
 void SpriteAppearances::saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file)
 {
-    Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
+    const auto& data = getSheetData(sheet);
+    if (!data)
+        return;
+
+    Image image({ SpriteSheet::SIZE }, 4, data.get());
     image.savePNG(file);
 }
\ No newline at end of file
@@ -68,8 +68,13 @@ public:
 
     SpriteLayout spriteLayout = SpriteLayout::ONE_BY_ONE;
     std::mutex m_mutex;
-    std::unique_ptr<uint8_t[]> data;
+    std::shared_ptr<uint8_t[]> data;
     std::string file;
+
+    // decoded sheets LRU, guarded by SpriteAppearances
+    std::list<SpriteSheet*>::iterator lruIterator;
+    ticks_t lastUsage{ 0 };
+    bool cached{ false };
 };
 
 //@bindsingleton g_spriteAppearances
@@ -87,20 +92,39 @@ public:
     void setPath(const std::string& path) { m_path = path; }
     std::string getPath() const { return m_path; }
 
-    bool loadSpriteSheet(const SpriteSheetPtr& sheet) const;
+    bool loadSpriteSheet(const SpriteSheetPtr& sheet);
     void saveSheetToFileBySprite(int id, const std::string& file);
     void saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file);
     SpriteSheetPtr getSheetBySpriteId(int id, bool load = true);
 
-    void addSpriteSheet(const SpriteSheetPtr& sheet) { m_sheets.emplace_back(sheet); }
+    // decoded pixels of the sheet, loading it if needed, kept alive while the caller holds them
+    std::shared_ptr<uint8_t[]> getSheetData(const SpriteSheetPtr& sheet);
+
+    void addSpriteSheet(const SpriteSheetPtr& sheet);
+
+    // every decoded sheet takes BYTES_IN_SPRITE_SHEET, the least recently used are dropped past this count
+    void setMaxLoadedSheets(size_t count);
+    size_t getMaxLoadedSheets() { return m_maxLoadedSheets; }
+    size_t getLoadedSheetsCount();
+
+    // called by GarbageCollection
+    void unloadIdleSheets(ticks_t idleTime);
 
     ImagePtr getSpriteImage(int id);
     void saveSpriteToFile(int id, const std::string& file);
 
 private:
+    bool decodeSpriteSheet(SpriteSheet& sheet) const;
+    void touchSheet(SpriteSheet& sheet);
+    void evictSheet(SpriteSheet& sheet);
+
     uint32_t m_spritesCount{ 0 };
-    std::vector<SpriteSheetPtr> m_sheets;
+    std::vector<SpriteSheetPtr> m_sheets; // sorted by firstId, ranges don't overlap
     std::string m_path;
+
+    std::mutex m_loadedSheetsMutex;
+    std::list<SpriteSheet*> m_loadedSheets; // most recently used first
+    size_t m_maxLoadedSheets{ 512 };
 };
 
 extern SpriteAppearances g_spriteAppearances;
@@ -97,6 +97,15 @@ void Thing::setShader(const std::string_view name) {
     if (name.empty())
         return;
 
-    if (const auto& shader = g_shaders.getShader(name))
+    if (const auto& shader = g_shaders.getShader(name)) {
         m_shaderId = shader->getId();
+        onLiveChange();
+    }
+}
+
+void Thing::onLiveChange()
+{
+    // only things on the map are drawn by the map views
+    if (m_position.isMapPosition())
+        g_map.notificateTileLive(m_position);
 }
\ No newline at end of file
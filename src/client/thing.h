@@ -180,6 +180,7 @@ public:
 
     virtual void onPositionChange(const Position& /*newPos*/, const Position& /*oldPos*/) {}
     virtual void onAppear() {}
+    void onLiveChange() override;
     virtual void onDisappear() {};
     const Color& getMarkedColor() {
         if (m_markedColor == Color::white)
@@ -190,7 +191,7 @@ public:
     }
 
     bool isMarked() { return m_markedColor != Color::white; }
-    void setMarked(const Color& color) { if (m_markedColor != color) m_markedColor = color; }
+    void setMarked(const Color& color) { if (m_markedColor != color) { m_markedColor = color; onLiveChange(); } }
 
     const Color& getHighlightColor() {
         if (m_highlightColor == Color::white)
@@ -201,7 +202,7 @@ public:
     }
 
     bool isHighlighted() { return m_highlightColor != Color::white; }
-    void setHighlight(const Color& color) { if (m_highlightColor != color) m_highlightColor = color; }
+    void setHighlight(const Color& color) { if (m_highlightColor != color) { m_highlightColor = color; onLiveChange(); } }
 
     bool isHided() { return isOwnerHidden(); }
 
@@ -738,6 +738,19 @@ void ThingType::loadTexture(const int animationPhase)
     if (m_opaque == -1)
         m_opaque = !fullImage->hasTransparentPixel();
 
+    // frames sharing a page are batched in a single draw
+    if (auto region = g_textureAtlas.add(fullImage)) {
+        const auto& offset = region.rect.topLeft();
+        for (auto& posData : textureData.pos) {
+            posData.rects.translate(offset);
+            posData.originRects.translate(offset);
+        }
+
+        textureData.atlasRegion = std::move(region);
+        textureData.source = textureData.atlasRegion.page;
+        return;
+    }
+
     textureData.source = std::make_shared<Texture>(fullImage, true, false);
 }
 
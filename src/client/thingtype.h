@@ -27,6 +27,7 @@
 
 #include <framework/core/declarations.h>
 #include <framework/graphics/drawpoolmanager.h>
+#include <framework/graphics/textureatlas.h>
 #include <framework/luaengine/luaobject.h>
 #include <framework/otml/declarations.h>
 #include <variant>
@@ -450,8 +451,10 @@ public:
     const Timer getLastTimeUsage() const { return m_lastTimeUsage; }
 
     void unload() {
-        for (auto& data : m_textureData)
+        for (auto& data : m_textureData) {
             data.source = nullptr;
+            g_textureAtlas.release(data.atlasRegion);
+        }
     }
 
     PLAYER_ACTION getDefaultAction() { return m_defaultAction; }
@@ -485,6 +488,7 @@ private:
 
         TexturePtr source;
         std::vector<Pos> pos;
+        AtlasRegion atlasRegion; // set when source is a shared atlas page
     };
 
     uint32_t getSpriteIndex(int w, int h, int l, int x, int y, int z, int a) const;
@@ -540,4 +544,9 @@ private:
 
     std::string m_name;
     std::string m_description;
+
+#ifdef CLIENT_CHECKS
+    friend class MapViewCheck;
+    friend class WalkCheck;
+#endif
 };
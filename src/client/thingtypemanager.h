@@ -106,6 +106,10 @@ private:
 #endif
 
     friend class GarbageCollection;
+#ifdef CLIENT_CHECKS
+    friend class MapViewCheck;
+    friend class WalkCheck;
+#endif
 };
 
 extern ThingTypeManager g_things;
@@ -203,6 +203,7 @@ void Tile::addWalkingCreature(const CreaturePtr& creature)
 {
     m_walkingCreatures.emplace_back(creature);
     setThingFlag(creature);
+    onLiveChange();
 }
 
 void Tile::removeWalkingCreature(const CreaturePtr& creature)
@@ -891,6 +892,7 @@ void Tile::select(const TileSelectType selectType)
     }
 
     markHighlightedThing(Color::yellow);
+    onLiveChange();
 }
 
 void Tile::unselect()
@@ -903,6 +905,48 @@ void Tile::unselect()
         checkForDetachableThing();
 }
 
+bool Tile::isLive()
+{
+    // creatures animate and walk, effects play and the selection pulses
+    if (hasCreatures() || !m_walkingCreatures.empty() || hasEffect() || isSelected() || m_fill != Color::alpha)
+        return true;
+
+    if (hasAttachedEffects() || hasAttachedParticles())
+        return true;
+
+    for (const auto& thing : m_things) {
+        if (thing->isMarked() || thing->isHighlighted() || thing->hasShader() || thing->hasAttachedEffects() || thing->hasAttachedParticles())
+            return true;
+    }
+
+    return false;
+}
+
+bool Tile::hasAnimatedItems()
+{
+    return std::ranges::any_of(m_things, [](const ThingPtr& thing) { return thing->isItem() && thing->hasAnimationPhases(); });
+}
+
+void Tile::onLiveChange()
+{
+    g_map.notificateTileLive(m_position);
+}
+
+bool Tile::updateAnimationPhases()
+{
+    size_t hash = 0;
+    for (const auto& thing : m_things) {
+        if (thing->isItem() && thing->hasAnimationPhases())
+            stdext::hash_combine(hash, thing->static_self_cast<Item>()->calculateAnimationPhase());
+    }
+
+    if (hash == m_animationHash)
+        return false;
+
+    m_animationHash = hash;
+    return true;
+}
+
 bool Tile::canRender(uint32_t& flags, const Position& cameraPosition, const AwareRange viewPort)
 {
     const int8_t dz = m_position.z - cameraPosition.z;
@@ -991,6 +1035,7 @@ int Tile::getTimer()
 void Tile::setFill(Color color)
 {
     m_fill = color;
+    onLiveChange();
 }
 
 bool Tile::canShoot(int distance)
@@ -202,6 +202,14 @@ public:
     void unselect();
     bool isSelected() { return m_selectType != TileSelectType::NONE; }
 
+    void onLiveChange() override;
+
+    // whether its drawing can change from one frame to the next without the tile being updated
+    bool isLive();
+    bool hasAnimatedItems();
+    // true when the animation phase of any of its items changed since the last call
+    bool updateAnimationPhases();
+
     TilePtr asTile() { return static_self_cast<Tile>(); }
 
     bool checkForDetachableThing(TileSelectType selectType = TileSelectType::FILTERED);
@@ -251,6 +259,8 @@ private:
     uint32_t m_isCovered{ 0 };
     uint32_t m_thingTypeFlag{ 0 };
 
+    size_t m_animationHash{ 0 };
+
 #ifdef FRAMEWORK_EDITOR
     uint32_t m_houseId{ 0 };
     uint32_t m_flags{ 0 };
@@ -268,4 +278,8 @@ private:
     TileSelectType m_selectType{ TileSelectType::NONE };
 
     bool m_drawTopAndCreature{ true };
+
+#ifdef CLIENT_CHECKS
+    friend class MapViewCheck;
+#endif
 };
@@ -22,6 +22,13 @@
 
 #include "uicreature.h"
 
+UICreature::~UICreature()
+{
+    // the map animates a static walk until it is stopped, nothing draws it once the widget is gone
+    if (m_creature)
+        m_creature->setStaticWalking(0);
+}
+
 void UICreature::drawSelf(const DrawPoolType drawPane)
 {
     if (drawPane != DrawPoolType::FOREGROUND)
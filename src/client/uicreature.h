@@ -29,6 +29,8 @@
 class UICreature final : public UIWidget
 {
 public:
+    ~UICreature() override;
+
     void drawSelf(DrawPoolType drawPane) override;
 
     void setCreature(const CreaturePtr& creature) { m_creature = creature; }
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "walkcheck.h"
+#include "creature.h"
+#include "map.h"
+
+#include "thingtypemanager.h"
+
+#include <framework/core/clock.h>
+#include <framework/core/eventdispatcher.h>
+#include <framework/graphics/drawpool.h>
+#include <framework/platform/platformwindow.h>
+
+#include <random>
+
+namespace
+{
+    // what the former events showed: an update right when the walk starts, then one per walk duration
+    struct Walker
+    {
+        CreaturePtr creature;
+        Otc::Direction direction{ Otc::InvalidDirection };
+        ticks_t start{ 0 };
+        ticks_t nextUpdate{ 0 };
+        ticks_t resumeAt{ 0 };
+        // when the map ended the real walk
+        ticks_t endedAt{ 0 };
+        float ticksPerPixel{ 0 };
+        int walkDuration{ 0 };
+        int pixels{ 0 };
+        bool walking{ false };
+    };
+
+    // a creature walking in place, beside one animated by the per-creature cycle event it had before
+    struct StaticWalker
+    {
+        CreaturePtr creature;
+        CreaturePtr former;
+        ScheduledEventPtr formerEvent;
+        uint8_t lastPhase{ 0 };
+        uint8_t lastFormerPhase{ 0 };
+        ticks_t lastChange{ 0 };
+        ticks_t lastFormerChange{ 0 };
+        size_t changes{ 0 };
+        size_t formerChanges{ 0 };
+    };
+
+    constexpr uint16_t CREATURE_TYPE_ID = 1;
+    constexpr uint16_t STATIC_WALK_SPEED = 1000;
+
+    Point getWalkOffset(const Otc::Direction direction, const int pixels)
+    {
+        const int size = g_gameConfig.getSpriteSize();
+        if (pixels >= size)
+            return {};
+
+        Point offset;
+        if (direction == Otc::North || direction == Otc::NorthEast || direction == Otc::NorthWest)
+            offset.y = size - pixels;
+        else if (direction == Otc::South || direction == Otc::SouthEast || direction == Otc::SouthWest)
+            offset.y = pixels - size;
+
+        if (direction == Otc::East || direction == Otc::NorthEast || direction == Otc::SouthEast)
+            offset.x = pixels - size;
+        else if (direction == Otc::West || direction == Otc::NorthWest || direction == Otc::SouthWest)
+            offset.x = size - pixels;
+        return offset;
+    }
+}
+
+// the checks run without assets, the static walkers get an outfit with three animation phases
+void WalkCheck::installCreatureType()
+{
+    const auto& type = std::make_shared<ThingType>();
+    type->m_null = false;
+    type->m_category = ThingCategoryCreature;
+    type->m_id = CREATURE_TYPE_ID;
+    type->m_animationPhases = 3;
+
+    auto& types = g_things.m_thingTypes[ThingCategoryCreature];
+    types.resize(std::max<size_t>(types.size(), CREATURE_TYPE_ID + 1), g_things.getNullThingType());
+    types[CREATURE_TYPE_ID] = type;
+}
+
+bool WalkCheck::run(const int creatures, const int seconds)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> speeds(80, 1500);
+    std::uniform_int_distribution<int> directions(Otc::North, Otc::NorthWest);
+    std::uniform_int_distribution<int> pauses(0, 100);
+    std::uniform_int_distribution<int> frames(1, 20);
+
+    g_clock.update();
+
+    std::vector<Walker> walkers(std::max(creatures, 1));
+    for (size_t i = 0; i < walkers.size(); ++i) {
+        auto& walker = walkers[i];
+        walker.creature = std::make_shared<Creature>();
+        walker.creature->setSpeed(speeds(rng));
+        // far apart, so their walking tiles never meet
+        walker.creature->setPosition(Position(1000 + (i % 100) * 16, 1000 + (i / 100) * 16, 7));
+    }
+
+    // the camera follows the first one, its walk was updated on every poll
+    walkers.front().creature->setCameraFollowing(true);
+
+    installCreatureType();
+
+    Outfit outfit;
+    outfit.setCategory(ThingCategoryCreature);
+    outfit.setId(CREATURE_TYPE_ID);
+
+    const int formerInterval = std::min<int>(STATIC_WALK_SPEED / g_gameConfig.getSpriteSize(), DrawPool::FPS60);
+    std::vector<StaticWalker> staticWalkers(4);
+    for (auto& walker : staticWalkers) {
+        walker.creature = std::make_shared<Creature>();
+        walker.creature->setOutfit(outfit);
+        walker.creature->setStaticWalking(STATIC_WALK_SPEED);
+
+        // what setStaticWalking did before the map updated the walks
+        walker.former = std::make_shared<Creature>();
+        walker.former->setOutfit(outfit);
+        walker.former->m_walkingAnimationSpeed = STATIC_WALK_SPEED;
+        walker.formerEvent = g_dispatcher.cycleEvent([former = walker.former] { former->updateWalkAnimation(); }, formerInterval);
+        walker.lastChange = walker.lastFormerChange = g_clock.millis();
+    }
+
+    // the shortest time between two phases of the former animation, the map must not change them faster
+    ticks_t minFormerInterval = std::numeric_limits<ticks_t>::max();
+    ticks_t minInterval = std::numeric_limits<ticks_t>::max();
+
+    // the third one is on the map, removing it from there stops its static walk
+    const Position staticWalkerPos(900, 900, 7);
+    g_map.addThing(staticWalkers[2].creature, staticWalkerPos);
+
+    size_t steps = 0, polls = 0, compared = 0, mismatches = 0;
+    int maxDiff = 0;
+    ticks_t maxEarlierEnd = 0;
+
+    const ticks_t end = g_clock.millis() + seconds * 1000;
+    while (g_clock.millis() < end) {
+        const ticks_t now = g_clock.millis();
+
+        for (auto& walker : walkers) {
+            if (walker.walking || walker.creature->isWalking() || now < walker.resumeAt)
+                continue;
+
+            const auto& creature = walker.creature;
+            const Position from = creature->getPosition();
+            walker.direction = static_cast<Otc::Direction>(directions(rng));
+            const Position to = from.translatedToDirection(walker.direction);
+
+            creature->setPosition(to);
+            creature->walk(from, to);
+
+            const uint16_t stepDuration = creature->getStepDuration(true);
+            walker.ticksPerPixel = stepDuration / static_cast<float>(g_gameConfig.getSpriteSize());
+            walker.walkDuration = std::min<int>(stepDuration / g_gameConfig.getSpriteSize(), DrawPool::FPS60);
+
+            // the followed creature had an event on every poll, and its walk was slowed down to stabilize the camera
+            if (creature->isCameraFollowing()) {
+                walker.ticksPerPixel = (stepDuration + (g_window.vsyncEnabled() ? 6.f : 0.f)) / g_gameConfig.getSpriteSize();
+                walker.walkDuration = 0;
+            }
+
+            walker.start = now;
+            walker.nextUpdate = now + walker.walkDuration;
+            walker.endedAt = 0;
+            walker.pixels = 0;
+            walker.walking = true;
+            ++steps;
+        }
+
+        stdext::millisleep(frames(rng));
+
+        // the poll of Application, the map updates the walks in it
+        g_clock.update();
+        g_dispatcher.poll();
+        ++polls;
+
+        const ticks_t polledAt = g_clock.millis();
+        for (auto& walker : walkers) {
+            if (!walker.walking)
+                continue;
+
+            if (polledAt >= walker.nextUpdate) {
+                const int pixels = std::min<int>((polledAt - walker.start) / walker.ticksPerPixel, g_gameConfig.getSpriteSize());
+                walker.pixels = std::max(walker.pixels, pixels);
+                walker.nextUpdate = polledAt + walker.walkDuration;
+            }
+
+            const Point expected = getWalkOffset(walker.direction, walker.pixels);
+            const Point offset = walker.creature->getWalkOffset();
+            const int diff = std::max(std::abs(expected.x - offset.x), std::abs(expected.y - offset.y));
+            maxDiff = std::max(maxDiff, diff);
+            ++compared;
+
+            // the events ran up to a walk duration late, which is at most a pixel
+            if (diff > 1)
+                ++mismatches;
+
+            if (walker.endedAt == 0 && !walker.creature->isWalking())
+                walker.endedAt = polledAt;
+
+            if (walker.pixels == g_gameConfig.getSpriteSize()) {
+                walker.walking = false;
+                walker.resumeAt = polledAt + pauses(rng);
+                if (walker.endedAt != 0)
+                    maxEarlierEnd = std::max<ticks_t>(maxEarlierEnd, polledAt - walker.endedAt);
+                else
+                    ++mismatches; // the map updates each poll, it can't end a walk later
+            }
+        }
+
+        for (auto& walker : staticWalkers) {
+            if (walker.creature->m_walkAnimationPhase != walker.lastPhase) {
+                walker.lastPhase = walker.creature->m_walkAnimationPhase;
+                minInterval = std::min<ticks_t>(minInterval, polledAt - walker.lastChange);
+                walker.lastChange = polledAt;
+                ++walker.changes;
+            }
+
+            if (walker.former->m_walkAnimationPhase != walker.lastFormerPhase) {
+                walker.lastFormerPhase = walker.former->m_walkAnimationPhase;
+                minFormerInterval = std::min<ticks_t>(minFormerInterval, polledAt - walker.lastFormerChange);
+                walker.lastFormerChange = polledAt;
+                ++walker.formerChanges;
+            }
+        }
+    }
+
+    for (const auto& walker : walkers)
+        walker.creature->stopWalk();
+
+    // the map updates them on every poll, the former events at most as often: they can't fall behind
+    size_t staticMismatches = 0, staticChanges = 0, formerStaticChanges = 0;
+    for (auto& walker : staticWalkers) {
+        walker.formerEvent->cancel();
+        staticChanges += walker.changes;
+        formerStaticChanges += walker.formerChanges;
+        if (walker.changes < walker.formerChanges || walker.changes == 0)
+            ++staticMismatches;
+    }
+    // the former event ran up to its interval after the foot delay was over
+    if (minInterval + formerInterval < minFormerInterval)
+        ++staticMismatches;
+
+    // the map holds the static walkers until they are stopped, can no longer be drawn or leave the map
+    staticWalkers[0].creature->setStaticWalking(0);
+    staticWalkers[1].creature->canDraw(false);
+    g_map.removeThing(staticWalkers[2].creature);
+
+    g_clock.update();
+    g_dispatcher.poll();
+
+    const auto isUpdated = [](const StaticWalker& walker) { return std::ranges::find(g_map.m_walkUpdates, walker.creature) != g_map.m_walkUpdates.end(); };
+    const bool released = !isUpdated(staticWalkers[0]) && !isUpdated(staticWalkers[1]) && !isUpdated(staticWalkers[2]) && isUpdated(staticWalkers[3]);
+    staticWalkers[3].creature->setStaticWalking(0);
+
+    std::cout << fmt::format("{} steps of {} creatures over {} polls, {} offsets compared\n", steps, walkers.size(), polls, compared);
+    std::cout << fmt::format("{} more than a pixel off the former walk events (max {} px), walks ended up to {} ms earlier\n",
+                             mismatches, maxDiff, maxEarlierEnd);
+    std::cout << fmt::format("{} phases of {} static walkers, {} with the former events, {} fell behind or changed faster\n",
+                             staticChanges, staticWalkers.size(), formerStaticChanges, staticMismatches);
+    std::cout << fmt::format("the stopped static walkers were {}released by the map\n", released ? "" : "not ");
+    return mismatches == 0 && staticMismatches == 0 && released;
+}
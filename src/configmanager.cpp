@@ -240,6 +240,9 @@ bool ConfigManager::load()
 	boolean[TWO_FACTOR_AUTH] = getGlobalBoolean(L, "enableTwoFactorAuth", true);
 	boolean[CHECK_DUPLICATE_STORAGE_KEYS] = getGlobalBoolean(L, "checkDuplicateStorageKeys", false);
 	boolean[MONSTER_OVERSPAWN] = getGlobalBoolean(L, "monsterOverspawn", false);
+	boolean[PACKET_COMPRESSION] = getGlobalBoolean(L, "packetCompression", false);
+	boolean[PATHFINDING_FLOW_FIELD] = getGlobalBoolean(L, "pathfindingFlowField", false);
+	boolean[MAP_SNAPSHOT] = getGlobalBoolean(L, "mapSnapshot", false);
 
 	string[DEFAULT_PRIORITY] = getGlobalString(L, "defaultPriority", "high");
 	string[SERVER_NAME] = getGlobalString(L, "serverName", "");
@@ -286,6 +289,11 @@ bool ConfigManager::load()
 	integer[QUEST_TRACKER_PREMIUM_LIMIT] = getGlobalNumber(L, "questTrackerPremiumLimit", 15);
 	integer[STAMINA_REGEN_MINUTE] = getGlobalNumber(L, "timeToRegenMinuteStamina", 3 * 60);
 	integer[STAMINA_REGEN_PREMIUM] = getGlobalNumber(L, "timeToRegenMinutePremiumStamina", 6 * 60);
+	integer[PATHFINDING_MAX_NODES] = getGlobalNumber(L, "pathfindingMaxNodes", 512);
+	integer[PACKET_COMPRESSION_THRESHOLD] = getGlobalNumber(L, "packetCompressionThreshold", 256);
+	integer[PACKET_COMPRESSION_LEVEL] = getGlobalNumber(L, "packetCompressionLevel", 6);
+	integer[PATHFINDING_FLOW_FIELD_RADIUS] = getGlobalNumber(L, "pathfindingFlowFieldRadius", 12);
+	integer[DATABASE_WORKERS] = getGlobalNumber(L, "databaseWorkers", 4);
 
 	expStages = loadXMLStages();
 	if (expStages.empty()) {
@@ -47,6 +47,9 @@ enum boolean_config_t
 	MANASHIELD_BREAKABLE,
 	CHECK_DUPLICATE_STORAGE_KEYS,
 	MONSTER_OVERSPAWN,
+	PACKET_COMPRESSION,
+	PATHFINDING_FLOW_FIELD,
+	MAP_SNAPSHOT,
 
 	LAST_BOOLEAN_CONFIG /* this must be the last one */
 };
@@ -119,6 +122,11 @@ enum integer_config_t
 	QUEST_TRACKER_PREMIUM_LIMIT,
 	STAMINA_REGEN_MINUTE,
 	STAMINA_REGEN_PREMIUM,
+	PATHFINDING_MAX_NODES,
+	PACKET_COMPRESSION_THRESHOLD,
+	PACKET_COMPRESSION_LEVEL,
+	PATHFINDING_FLOW_FIELD_RADIUS,
+	DATABASE_WORKERS,
 
 	LAST_INTEGER_CONFIG /* this must be the last one */
 };
@@ -134,6 +134,7 @@ private:
 	void updateItemWeight(int32_t diff);
 
 	friend class ContainerIterator;
+	friend class IOMap;
 	friend class IOMapSerialize;
 };
 
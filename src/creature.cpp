@@ -973,7 +973,15 @@ void Creature::goToFollowCreature()
 			}
 		} else {
 			listWalkDir.clear();
-			if (getPathTo(followCreature->getPosition(), listWalkDir, fpp)) {
+
+			// melee monsters chasing the same creature share one flow field instead of each running A*
+			bool found = false;
+			if (monster && !monster->getMaster() && fpp.maxTargetDist == 1 &&
+			    ConfigManager::getBoolean(ConfigManager::PATHFINDING_FLOW_FIELD)) {
+				found = g_game.map.getFlowFieldPath(*this, *followCreature, listWalkDir);
+			}
+
+			if (found || getPathTo(followCreature->getPosition(), listWalkDir, fpp)) {
 				hasFollowPath = true;
 				startAutoWalk();
 			} else {
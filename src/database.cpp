@@ -197,14 +197,17 @@ bool DBResult::next()
 	return row;
 }
 
-DBInsert::DBInsert(std::string query) : query(std::move(query)) { this->length = this->query.length(); }
+DBInsert::DBInsert(std::string query, Database& db) : db(db), query(std::move(query))
+{
+	this->length = this->query.length();
+}
 
 bool DBInsert::addRow(const std::string& row)
 {
 	// adds new row to buffer
 	const size_t rowLength = row.length();
 	length += rowLength;
-	if (length > Database::getInstance().getMaxPacketSize() && !execute()) {
+	if (length > db.getMaxPacketSize() && !execute()) {
 		return false;
 	}
 
@@ -237,7 +240,7 @@ bool DBInsert::execute()
 	}
 
 	// executes buffer
-	bool res = Database::getInstance().executeQuery(query + values);
+	bool res = db.executeQuery(query + values);
 	values.clear();
 	length = query.length();
 	return res;
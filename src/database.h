@@ -169,12 +169,13 @@ private:
 class DBInsert
 {
 public:
-	explicit DBInsert(std::string query);
+	explicit DBInsert(std::string query, Database& db = Database::getInstance());
 	bool addRow(const std::string& row);
 	bool addRow(std::ostringstream& row);
 	bool execute();
 
 private:
+	Database& db;
 	std::string query;
 	std::string values;
 	size_t length;
@@ -183,12 +184,12 @@ private:
 class DBTransaction
 {
 public:
-	constexpr DBTransaction() = default;
+	explicit DBTransaction(Database& db = Database::getInstance()) : db(db) {}
 
 	~DBTransaction()
 	{
 		if (state == STATE_START) {
-			Database::getInstance().rollback();
+			db.rollback();
 		}
 	}
 
@@ -199,7 +200,7 @@ public:
 	bool begin()
 	{
 		state = STATE_START;
-		return Database::getInstance().beginTransaction();
+		return db.beginTransaction();
 	}
 
 	bool commit()
@@ -209,7 +210,7 @@ public:
 		}
 
 		state = STATE_COMMIT;
-		return Database::getInstance().commit();
+		return db.commit();
 	}
 
 private:
@@ -220,6 +221,7 @@ private:
 		STATE_COMMIT,
 	};
 
+	Database& db;
 	TransactionStates_t state = STATE_NO_START;
 };
 
@@ -5,54 +5,157 @@
 
 #include "databasetasks.h"
 
+#include "configmanager.h"
 #include "tasks.h"
 
 extern Dispatcher g_dispatcher;
 
+namespace {
+
+int64_t getMicroseconds()
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 void DatabaseTasks::start()
 {
-	db.connect();
-	ThreadHolder::start();
+	const auto workerCount = std::max<int64_t>(getNumber(ConfigManager::DATABASE_WORKERS), 1);
+
+	threadState.store(THREAD_STATE_RUNNING, std::memory_order_relaxed);
+	for (int64_t i = 0; i < workerCount; ++i) {
+		auto& db = connections.emplace_back(std::make_unique<Database>());
+		if (!db->connect()) {
+			std::cout << "[Warning - DatabaseTasks::start] Database worker " << i << " could not connect." << std::endl;
+		}
+		threads.emplace_back(&DatabaseTasks::threadMain, this, std::ref(*db));
+	}
+}
+
+void DatabaseTasks::stop() { threadState.store(THREAD_STATE_CLOSING, std::memory_order_relaxed); }
+
+void DatabaseTasks::join()
+{
+	for (std::thread& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
 }
 
-void DatabaseTasks::threadMain()
+void DatabaseTasks::threadMain(Database& db)
 {
-	std::unique_lock<std::mutex> taskLockUnique(taskLock, std::defer_lock);
-	while (getState() != THREAD_STATE_TERMINATED) {
+	std::unique_lock<std::mutex> taskLockUnique(taskLock);
+	while (true) {
+		taskSignal.wait(taskLockUnique, [this]() {
+			return !readyKeys.empty() ||
+			       (queuedTasks == 0 && threadState.load(std::memory_order_relaxed) == THREAD_STATE_TERMINATED);
+		});
+
+		if (readyKeys.empty()) {
+			return;
+		}
+
+		const uint64_t orderKey = readyKeys.front();
+		readyKeys.pop_front();
+
+		auto it = tasks.find(orderKey);
+		DatabaseTask task = std::move(it->second.front());
+		it->second.pop_front();
+		if (it->second.empty()) {
+			tasks.erase(it);
+		}
+
+		if (orderKey != 0) {
+			runningKeys.insert(orderKey);
+		}
+		--queuedTasks;
+		++runningTasks;
+		stats.queued = queuedTasks;
+
+		int64_t startedAt = getMicroseconds();
+		uint64_t waitTime = startedAt - task.addedAt;
+		taskLockUnique.unlock();
+
+		runTask(db, task);
+
+		uint64_t runTime = getMicroseconds() - startedAt;
 		taskLockUnique.lock();
-		if (tasks.empty()) {
-			taskSignal.wait(taskLockUnique);
+
+		--runningTasks;
+		if (orderKey != 0) {
+			runningKeys.erase(orderKey);
+			// the next task of this order was waiting for it
+			if (tasks.find(orderKey) != tasks.end()) {
+				readyKeys.push_back(orderKey);
+				taskSignal.notify_one();
+			}
 		}
 
-		if (!tasks.empty()) {
-			DatabaseTask task = std::move(tasks.front());
-			tasks.pop_front();
-			taskLockUnique.unlock();
-			runTask(task);
-		} else {
-			taskLockUnique.unlock();
+		++stats.completed;
+		stats.totalWaitTime += waitTime;
+		stats.maxWaitTime = std::max(stats.maxWaitTime, waitTime);
+		stats.totalRunTime += runTime;
+		stats.maxRunTime = std::max(stats.maxRunTime, runTime);
+
+		if (queuedTasks == 0) {
+			if (threadState.load(std::memory_order_relaxed) == THREAD_STATE_TERMINATED) {
+				// the other workers may have been waiting for the last tasks of an ordering key before they exit
+				taskSignal.notify_all();
+			}
+
+			if (runningTasks == 0) {
+				idleSignal.notify_all();
+			}
 		}
 	}
 }
 
 void DatabaseTasks::addTask(std::string query, std::function<void(DBResult_ptr, bool)> callback /* = nullptr*/,
-                            bool store /* = false*/)
+                            bool store /* = false*/, uint64_t orderKey /* = DATABASE_ORDER_NONE*/)
 {
-	bool signal = false;
-	taskLock.lock();
-	if (getState() == THREAD_STATE_RUNNING) {
-		signal = tasks.empty();
-		tasks.emplace_back(std::move(query), std::move(callback), store);
-	}
-	taskLock.unlock();
+	addTask(DatabaseTask{std::move(query), std::move(callback), store, orderKey});
+}
+
+void DatabaseTasks::addTask(std::function<void(Database&)> work, uint64_t orderKey /* = DATABASE_ORDER_NONE*/)
+{
+	addTask(DatabaseTask{std::move(work), orderKey});
+}
+
+void DatabaseTasks::addTask(DatabaseTask&& task)
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(taskLock);
+		if (threadState.load(std::memory_order_relaxed) != THREAD_STATE_RUNNING) {
+			return;
+		}
+
+		task.addedAt = getMicroseconds();
+		const uint64_t orderKey = task.orderKey;
+		auto& keyTasks = tasks[orderKey];
+		keyTasks.push_back(std::move(task));
 
-	if (signal) {
-		taskSignal.notify_one();
+		// a task of an ordering key becomes ready when the one before it has run
+		if (orderKey == 0 || (keyTasks.size() == 1 && runningKeys.find(orderKey) == runningKeys.end())) {
+			readyKeys.push_back(orderKey);
+		}
+
+		++queuedTasks;
+		stats.queued = queuedTasks;
+		stats.maxQueued = std::max<uint64_t>(stats.maxQueued, queuedTasks);
 	}
+	taskSignal.notify_one();
 }
 
-void DatabaseTasks::runTask(const DatabaseTask& task)
+void DatabaseTasks::runTask(Database& db, const DatabaseTask& task)
 {
+	if (task.work) {
+		task.work(db);
+		return;
+	}
+
 	bool success;
 	DBResult_ptr result;
 	if (task.store) {
@@ -70,21 +173,22 @@ void DatabaseTasks::runTask(const DatabaseTask& task)
 
 void DatabaseTasks::flush()
 {
-	std::unique_lock<std::mutex> guard{taskLock};
-	while (!tasks.empty()) {
-		auto task = std::move(tasks.front());
-		tasks.pop_front();
-		guard.unlock();
-		runTask(task);
-		guard.lock();
-	}
+	std::unique_lock<std::mutex> taskLockUnique(taskLock);
+	idleSignal.wait(taskLockUnique, [this]() { return (queuedTasks == 0 && runningTasks == 0) || threads.empty(); });
 }
 
 void DatabaseTasks::shutdown()
 {
-	taskLock.lock();
-	setState(THREAD_STATE_TERMINATED);
-	taskLock.unlock();
-	flush();
-	taskSignal.notify_one();
+	{
+		std::lock_guard<std::mutex> lockGuard(taskLock);
+		threadState.store(THREAD_STATE_TERMINATED, std::memory_order_relaxed);
+	}
+	// the workers run what is left and exit
+	taskSignal.notify_all();
+}
+
+DatabaseTaskStats DatabaseTasks::getStats() const
+{
+	std::lock_guard<std::mutex> lockGuard(taskLock);
+	return stats;
 }
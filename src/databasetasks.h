@@ -5,39 +5,98 @@
 #define FS_DATABASETASKS_H
 
 #include "database.h"
-#include "thread_holder_base.h"
+#include "enums.h"
+
+enum DatabaseTaskOrder_t : uint8_t
+{
+	DATABASE_ORDER_NONE,
+	DATABASE_ORDER_SCRIPT,
+	DATABASE_ORDER_SCRIPT_READ,
+	DATABASE_ORDER_SCRIPT_KEY,
+	DATABASE_ORDER_ACCOUNT,
+	DATABASE_ORDER_SERVER_SAVE,
+};
+
+// Tasks with the same key run one at a time, in the order they were added. Tasks without a key run on any free worker.
+constexpr uint64_t getDatabaseOrderKey(DatabaseTaskOrder_t order, uint32_t id = 0)
+{
+	return (static_cast<uint64_t>(order) << 32) | id;
+}
 
 struct DatabaseTask
 {
-	DatabaseTask(std::string&& query, std::function<void(DBResult_ptr, bool)>&& callback, bool store) :
-	    query(std::move(query)), callback(std::move(callback)), store(store)
+	DatabaseTask(std::string&& query, std::function<void(DBResult_ptr, bool)>&& callback, bool store,
+	             uint64_t orderKey) :
+	    query(std::move(query)), callback(std::move(callback)), orderKey(orderKey), store(store)
+	{}
+	DatabaseTask(std::function<void(Database&)>&& work, uint64_t orderKey) :
+	    work(std::move(work)), orderKey(orderKey)
 	{}
 
 	std::string query;
 	std::function<void(DBResult_ptr, bool)> callback;
-	bool store;
+	// runs instead of the query, with the connection of the worker
+	std::function<void(Database&)> work;
+	uint64_t orderKey;
+	int64_t addedAt = 0;
+	bool store = false;
 };
 
-class DatabaseTasks : public ThreadHolder<DatabaseTasks>
+struct DatabaseTaskStats
+{
+	uint64_t completed = 0;
+	uint64_t queued = 0;
+	uint64_t maxQueued = 0;
+	// microseconds
+	uint64_t totalWaitTime = 0;
+	uint64_t maxWaitTime = 0;
+	uint64_t totalRunTime = 0;
+	uint64_t maxRunTime = 0;
+};
+
+/**
+ * Runs queries on a pool of worker threads, each with its own connection, so a
+ * slow query only holds up the tasks ordered after it.
+ */
+class DatabaseTasks
 {
 public:
 	DatabaseTasks() = default;
 	void start();
+	void stop();
+	void join();
+
+	// waits until every task added so far has run
 	void flush();
 	void shutdown();
 
-	void addTask(std::string query, std::function<void(DBResult_ptr, bool)> callback = nullptr, bool store = false);
+	void addTask(std::string query, std::function<void(DBResult_ptr, bool)> callback = nullptr, bool store = false,
+	             uint64_t orderKey = getDatabaseOrderKey(DATABASE_ORDER_NONE));
+	void addTask(std::function<void(Database&)> work, uint64_t orderKey = getDatabaseOrderKey(DATABASE_ORDER_NONE));
 
-	void threadMain();
+	DatabaseTaskStats getStats() const;
 
 private:
-	void runTask(const DatabaseTask& task);
+	void threadMain(Database& db);
+	void runTask(Database& db, const DatabaseTask& task);
+	void addTask(DatabaseTask&& task);
 
-	Database db;
-	std::thread thread;
-	std::list<DatabaseTask> tasks;
-	std::mutex taskLock;
+	std::vector<std::unique_ptr<Database>> connections;
+	std::vector<std::thread> threads;
+	// the waiting tasks of every ordering key, tasks without a key are queued under 0
+	std::unordered_map<uint64_t, std::deque<DatabaseTask>> tasks;
+	// a key for every task a worker may take now, oldest first: once per task without a key, once per ordering key
+	// with waiting tasks and no task being run
+	std::deque<uint64_t> readyKeys;
+	// ordering keys of the tasks being run
+	std::unordered_set<uint64_t> runningKeys;
+	size_t queuedTasks = 0;
+	size_t runningTasks = 0;
+	DatabaseTaskStats stats;
+	mutable std::mutex taskLock;
 	std::condition_variable taskSignal;
+	std::condition_variable idleSignal;
+	std::atomic<ThreadState> threadState{THREAD_STATE_TERMINATED};
 };
 
 extern DatabaseTasks g_databaseTasks;
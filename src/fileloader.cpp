@@ -88,12 +88,146 @@ const Node& Loader::parseTree()
 	return root;
 }
 
+// first unescaped START or END after the properties
+static ContentIt findPropsEnd(ContentIt it, ContentIt end)
+{
+	for (; it != end; ++it) {
+		switch (static_cast<uint8_t>(*it)) {
+			case Node::START:
+			case Node::END:
+				return it;
+			case Node::ESCAPE:
+				if (++it == end) {
+					throw InvalidOTBFormat{};
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	throw InvalidOTBFormat{};
+}
+
+const Node& Loader::parseRoot()
+{
+	auto it = fileContents.begin() + sizeof(Identifier);
+	if (static_cast<uint8_t>(*it) != Node::START) {
+		throw InvalidOTBFormat{};
+	}
+	root.type = *(++it);
+	root.propsBegin = ++it;
+	root.propsEnd = findPropsEnd(it, fileContents.end());
+	root.children.clear();
+	return root;
+}
+
+void Loader::parseChildren(Node& node) const
+{
+	node.children.clear();
+
+	NodeStack parseStack;
+	parseStack.push(&node);
+
+	for (auto it = node.propsEnd; it != fileContents.end(); ++it) {
+		switch (static_cast<uint8_t>(*it)) {
+			case Node::START: {
+				auto& currentNode = getCurrentNode(parseStack);
+				if (currentNode.children.empty()) {
+					currentNode.propsEnd = it;
+				}
+				currentNode.children.emplace_back();
+				auto& child = currentNode.children.back();
+				if (++it == fileContents.end()) {
+					throw InvalidOTBFormat{};
+				}
+				child.type = *it;
+				child.propsBegin = it + sizeof(Node::type);
+				parseStack.push(&child);
+				break;
+			}
+			case Node::END: {
+				auto& currentNode = getCurrentNode(parseStack);
+				if (currentNode.children.empty()) {
+					currentNode.propsEnd = it;
+				}
+				parseStack.pop();
+				if (parseStack.empty()) {
+					return;
+				}
+				break;
+			}
+			case Node::ESCAPE: {
+				if (++it == fileContents.end()) {
+					throw InvalidOTBFormat{};
+				}
+				break;
+			}
+			default: {
+				break;
+			}
+		}
+	}
+	throw InvalidOTBFormat{};
+}
+
+bool ChildCursor::next(Node& child)
+{
+	if (skipPending) {
+		// move past the subtree of the previous child, up to and including its END
+		skipPending = false;
+		for (size_t depth = 0;; ++it) {
+			if (it == end) {
+				throw InvalidOTBFormat{};
+			}
+
+			const auto byte = static_cast<uint8_t>(*it);
+			if (byte == Node::START) {
+				++depth;
+				if (++it == end) {
+					throw InvalidOTBFormat{};
+				}
+			} else if (byte == Node::END) {
+				if (depth-- == 0) {
+					++it;
+					break;
+				}
+			} else if (byte == Node::ESCAPE) {
+				if (++it == end) {
+					throw InvalidOTBFormat{};
+				}
+			}
+		}
+	}
+
+	if (it == end) {
+		throw InvalidOTBFormat{};
+	}
+
+	if (static_cast<uint8_t>(*it) == Node::END) {
+		return false;
+	} else if (static_cast<uint8_t>(*it) != Node::START || ++it == end) {
+		throw InvalidOTBFormat{};
+	}
+
+	child.children.clear();
+	child.type = *it;
+	child.propsBegin = ++it;
+	child.propsEnd = findPropsEnd(it, end);
+
+	it = child.propsEnd;
+	skipPending = true;
+	return true;
+}
+
 bool Loader::getProps(const Node& node, PropStream& props)
 {
 	auto size = std::distance(node.propsBegin, node.propsEnd);
 	if (size == 0) {
 		return false;
 	}
+
+	// the tile areas of a map are read by several threads at once
+	static thread_local std::vector<char> propBuffer;
 	propBuffer.resize(size);
 	bool lastEscaped = false;
 
@@ -41,12 +41,48 @@ class Loader
 {
 	MappedFile fileContents;
 	Node root;
-	std::vector<char> propBuffer;
 
 public:
 	Loader(const std::string& fileName, const Identifier& acceptedIdentifier);
+
+	/**
+	 * Un-escapes the properties of a node into a buffer owned by the calling
+	 * thread, valid until its next getProps call.
+	 */
 	bool getProps(const Node& node, PropStream& props);
 	const Node& parseTree();
+
+	/**
+	 * Reads only the root node, leaving its children to a ChildCursor so the
+	 * whole tree never has to be in memory at once.
+	 */
+	const Node& parseRoot();
+
+	/**
+	 * Builds the subtree of a node read by a ChildCursor. Only reads the mapped
+	 * file, so different nodes can be parsed on different threads.
+	 */
+	void parseChildren(Node& node) const;
+
+	ContentIt end() const { return fileContents.end(); }
+};
+
+/**
+ * Streams the direct children of a node: each next() reads the type and
+ * properties of one child, its own children are skipped unless parsed with
+ * Loader::parseChildren.
+ */
+class ChildCursor
+{
+public:
+	ChildCursor(const Loader& loader, const Node& parent) : it(parent.propsEnd), end(loader.end()) {}
+
+	bool next(Node& child);
+
+private:
+	ContentIt it;
+	ContentIt end;
+	bool skipPending = false;
 };
 
 } // namespace OTB
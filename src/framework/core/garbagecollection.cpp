@@ -21,6 +21,7 @@
  */
 
 #include "garbagecollection.h"
+#include <client/spriteappearances.h>
 #include <client/thingtypemanager.h>
 #include <framework/core/asyncdispatcher.h>
 #include <framework/core/eventdispatcher.h>
@@ -28,18 +29,24 @@
 #include <framework/graphics/drawpoolmanager.h>
 #include <framework/graphics/texturemanager.h>
 #include <framework/luaengine/luainterface.h>
+#include <framework/ui/uimanager.h>
 
 constexpr uint32_t LUA_TIME = 15 * 60 * 1000; // 15min
 constexpr uint32_t TEXTURE_TIME = 30 * 60 * 1000; // 30min
 constexpr uint32_t DRAWPOOL_TIME = 30 * 60 * 1000; // 30min
 constexpr uint32_t THINGTYPE_TIME = 2 * 1000; // 2seg
+constexpr uint32_t SPRITESHEET_TIME = 60 * 1000; // 1min
+constexpr uint32_t UISTYLE_TIME = 5 * 60 * 1000; // 5min
 
-Timer lua_timer, texture_timer, drawpool_timer, thingtype_timer;
+Timer lua_timer, texture_timer, drawpool_timer, thingtype_timer, spritesheet_timer, uistyle_timer;
 
 void GarbageCollection::poll() {
     if (canCheck(thingtype_timer, THINGTYPE_TIME))
         thingType();
 
+    if (canCheck(spritesheet_timer, SPRITESHEET_TIME))
+        spriteSheets();
+
     if (canCheck(texture_timer, TEXTURE_TIME))
         texture();
 
@@ -48,6 +55,9 @@ void GarbageCollection::poll() {
 
     if (canCheck(lua_timer, LUA_TIME))
         lua();
+
+    if (canCheck(uistyle_timer, UISTYLE_TIME))
+        uiStyles();
 }
 
 void GarbageCollection::lua() {
@@ -60,6 +70,14 @@ void GarbageCollection::drawpoll() {
         g_drawPool.get(static_cast<DrawPoolType>(i))->resetBuffer();
 }
 
+void GarbageCollection::uiStyles() {
+    // state styles no widget uses anymore
+    std::erase_if(g_ui.m_stateStyles, [](const auto& item) {
+        const auto& [key, stateStyles] = item;
+        return stateStyles.use_count() == 1;
+    });
+}
+
 void GarbageCollection::texture() {
     static constexpr uint32_t IDLE_TIME = 25 * 60 * 1000; // 25min
 
@@ -110,4 +128,11 @@ void GarbageCollection::thingType() {
         }
         thingTypesToUnload.clear();
     }
-}
\ No newline at end of file
+}
+
+void GarbageCollection::spriteSheets() {
+    static constexpr uint32_t IDLE_TIME = 5 * 60 * 1000; // 5min
+
+    // textures are already built from them, decoded sheets are only needed for new sprites
+    g_spriteAppearances.unloadIdleSheets(IDLE_TIME);
+}
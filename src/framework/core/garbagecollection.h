@@ -33,6 +33,8 @@ public:
     static void texture();
     static void drawpoll();
     static void thingType();
+    static void spriteSheets();
+    static void uiStyles();
 
 private:
     static bool canCheck(Timer& timer, const uint32_t delay) {
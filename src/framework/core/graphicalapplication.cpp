@@ -55,33 +55,40 @@ void GraphicalApplication::init(std::vector<std::string>& args, ApplicationConte
     auto graphicalContext = static_cast<GraphicalApplicationContext*>(context);
     setDrawEvents(graphicalContext->getDrawEvents());
 
-    // setup platform window
-    g_window.init();
-    g_window.hide();
+    // the null render backend only records and counts the draws, there is no window or graphics context
+    const bool nullBackend = g_drawPool.isNullBackend();
 
-    g_window.setOnResize([this](auto&& PH1) {
-        if (!m_running) resize(PH1);
-        else g_dispatcher.addEvent([&, PH1] { resize(PH1); });
-    });
+    if (!nullBackend) {
+        // setup platform window
+        g_window.init();
+        g_window.hide();
 
-    g_window.setOnInputEvent([this](auto&& PH1) {
-        if (!m_running) inputEvent(PH1);
-        else g_dispatcher.addEvent([&, PH1] { inputEvent(PH1); });
-    });
+        g_window.setOnResize([this](auto&& PH1) {
+            if (!m_running) resize(PH1);
+            else g_dispatcher.addEvent([&, PH1] { resize(PH1); });
+        });
 
-    g_window.setOnClose([this] { g_dispatcher.addEvent([this] { close(); }); });
+        g_window.setOnInputEvent([this](auto&& PH1) {
+            if (!m_running) inputEvent(PH1);
+            else g_dispatcher.addEvent([&, PH1] { inputEvent(PH1); });
+        });
 
-    g_mouse.init();
+        g_window.setOnClose([this] { g_dispatcher.addEvent([this] { close(); }); });
+
+        g_mouse.init();
+    }
 
     // initialize ui
     g_ui.init();
 
     // initialize graphics
-    g_graphics.init();
+    if (!nullBackend)
+        g_graphics.init();
     g_drawPool.init(graphicalContext->getSpriteSize());
 
     // fire first resize event
-    resize(g_window.getSize());
+    if (!nullBackend)
+        resize(g_window.getSize());
 
 #ifdef FRAMEWORK_SOUND
     // initialize sound
@@ -95,7 +102,8 @@ void GraphicalApplication::init(std::vector<std::string>& args, ApplicationConte
 void GraphicalApplication::deinit()
 {
     // hide the window because there is no render anymore
-    g_window.hide();
+    if (!g_drawPool.isNullBackend())
+        g_window.hide();
 
     Application::deinit();
 }
@@ -116,12 +124,16 @@ void GraphicalApplication::terminate()
     g_sounds.terminate();
 #endif
 
-    g_mouse.terminate();
+    const bool nullBackend = g_drawPool.isNullBackend();
+    if (!nullBackend)
+        g_mouse.terminate();
 
     // terminate graphics
     g_drawPool.terminate();
-    g_graphics.terminate();
-    g_window.terminate();
+    if (!nullBackend) {
+        g_graphics.terminate();
+        g_window.terminate();
+    }
 
     m_terminated = true;
 }
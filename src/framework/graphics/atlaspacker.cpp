@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "atlaspacker.h"
+
+AtlasPacker::AtlasPacker(const Size& size, const int padding, const int alignment) :
+    m_size(size), m_padding(padding), m_alignment(std::max<int>(alignment, 1))
+{}
+
+bool AtlasPacker::pack(const Size& size, Rect& rect)
+{
+    const int width = align(size.width() + m_padding);
+    const int height = align(size.height() + m_padding);
+    if (width > m_size.width() || height > m_size.height())
+        return false;
+
+    // best fit: the shortest shelf that still has a span wide enough, keeping tall shelves for tall rects
+    Shelf* best = nullptr;
+    Span* bestSpan = nullptr;
+    for (auto& shelf : m_shelves) {
+        if (shelf.height < height || (best && shelf.height >= best->height))
+            continue;
+
+        for (auto& span : shelf.free) {
+            if (span.width >= width) {
+                best = &shelf;
+                bestSpan = &span;
+                break;
+            }
+        }
+    }
+
+    if (!best) {
+        if (m_top + height > m_size.height())
+            return false;
+
+        best = &m_shelves.emplace_back(Shelf{ m_top, height, { Span{ 0, m_size.width() / m_alignment * m_alignment } } });
+        bestSpan = &best->free.front();
+        m_top += height;
+    }
+
+    rect = Rect(bestSpan->x, best->y, size);
+    bestSpan->x += width;
+    bestSpan->width -= width;
+    if (bestSpan->width == 0)
+        best->free.erase(best->free.begin() + (bestSpan - best->free.data()));
+
+    ++m_allocations;
+    m_usedArea += static_cast<size_t>(size.area());
+    return true;
+}
+
+void AtlasPacker::release(const Rect& rect)
+{
+    assert(m_allocations > 0);
+
+    --m_allocations;
+    m_usedArea -= static_cast<size_t>(rect.size().area());
+
+    if (m_allocations == 0) {
+        clear();
+        return;
+    }
+
+    const auto shelf = std::ranges::find_if(m_shelves, [&](const Shelf& shelf) { return shelf.y == rect.top(); });
+    if (shelf == m_shelves.end())
+        return;
+
+    // give the columns back, merged with the free spans around them
+    auto& free = shelf->free;
+    const int width = align(rect.width() + m_padding);
+    auto next = std::ranges::lower_bound(free, rect.left(), {}, &Span::x);
+    next = free.insert(next, Span{ rect.left(), width });
+
+    if (const auto after = next + 1; after != free.end() && next->x + next->width == after->x) {
+        next->width += after->width;
+        free.erase(after);
+    }
+
+    if (next != free.begin()) {
+        if (const auto before = next - 1; before->x + before->width == next->x) {
+            before->width += next->width;
+            free.erase(next);
+        }
+    }
+
+    // empty shelves on top give their rows back
+    const int columns = m_size.width() / m_alignment * m_alignment;
+    while (!m_shelves.empty()) {
+        const auto& top = m_shelves.back();
+        if (top.free.size() != 1 || top.free.front().width != columns)
+            break;
+
+        m_top = top.y;
+        m_shelves.pop_back();
+    }
+}
+
+void AtlasPacker::clear()
+{
+    m_shelves.clear();
+    m_top = 0;
+    m_allocations = 0;
+    m_usedArea = 0;
+}
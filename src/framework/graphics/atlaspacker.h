@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+// Shelf bin packer for one atlas page, CPU side only.
+// Rects are placed left to right on horizontal shelves, each shelf keeps its free spans so
+// released rects leave holes that later rects of the same height or shorter can take.
+// Rects start on multiples of the alignment and are followed by at least padding empty texels,
+// so mip levels down to a texel per alignment block never mix two rects.
+class AtlasPacker
+{
+public:
+    AtlasPacker(const Size& size, int padding = 0, int alignment = 1);
+
+    bool pack(const Size& size, Rect& rect);
+    void release(const Rect& rect);
+    void clear();
+
+    const Size& getSize() const { return m_size; }
+    int getAllocations() const { return m_allocations; }
+    size_t getUsedArea() const { return m_usedArea; }
+    float getOccupancy() const { return m_usedArea / static_cast<float>(m_size.area()); }
+    bool isEmpty() const { return m_allocations == 0; }
+    // the rows taken by shelves, free or not
+    int getTop() const { return m_top; }
+
+private:
+    struct Span
+    {
+        int x;
+        int width;
+    };
+
+    struct Shelf
+    {
+        int y;
+        int height;
+        std::vector<Span> free; // sorted by x, never adjacent
+    };
+
+    int align(const int v) const { return (v + m_alignment - 1) / m_alignment * m_alignment; }
+
+    Size m_size;
+    int m_padding;
+    int m_alignment;
+    int m_top{ 0 }; // first row without a shelf
+    int m_allocations{ 0 };
+    size_t m_usedArea{ 0 };
+    std::vector<Shelf> m_shelves;
+};
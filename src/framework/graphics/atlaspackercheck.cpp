@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "atlaspackercheck.h"
+#include "atlaspacker.h"
+#include "textureatlas.h"
+
+#include <random>
+
+namespace
+{
+    constexpr int padding = TextureAtlas::PADDING;
+    constexpr int alignment = TextureAtlas::ALIGNMENT;
+
+    // the texels of the rect at the last mip level of the page, grown by the empty one it must keep after it
+    Rect getMipBlocks(const Rect& rect, const bool withGutter)
+    {
+        constexpr int block = 1 << TextureAtlas::MIP_LEVELS;
+        const int left = rect.left() / block;
+        const int top = rect.top() / block;
+        const int right = rect.right() / block + (withGutter ? 1 : 0);
+        const int bottom = rect.bottom() / block + (withGutter ? 1 : 0);
+        return Rect(left, top, right - left + 1, bottom - top + 1);
+    }
+}
+
+void AtlasPackerCheck::expect(const bool condition, const std::string_view what)
+{
+    if (!condition) {
+        g_logger.error("Atlas packer check failed: {}", what);
+        ++m_failures;
+    }
+}
+
+bool AtlasPackerCheck::run(const int operations)
+{
+    const Size tile(32);
+    Rect a, b, c, d;
+
+    {
+        AtlasPacker packer(Size(256), padding, alignment);
+        expect(packer.pack(tile, a) && packer.pack(tile, b) && packer.pack(tile, c), "three tiles fit a page");
+        expect(a.top() == b.top() && b.top() == c.top() && a.right() < b.left() && b.right() < c.left(), "tiles go left to right on a shelf");
+
+        // a hole in the middle of a shelf is taken again
+        const int top = packer.getTop();
+        packer.release(b);
+        expect(packer.pack(tile, d) && d == b && packer.getTop() == top, "a released rect in the middle of a shelf is reused");
+
+        // neighbouring holes merge into one span
+        packer.release(a);
+        packer.release(d);
+        const Size wide(2 * (tile.width() + padding) - padding, tile.height());
+        expect(packer.pack(wide, d) && d.topLeft() == a.topLeft(), "neighbouring holes take a wider rect");
+
+        // a shelf left empty on top gives its rows back
+        packer.release(d);
+        packer.release(c);
+        expect(packer.isEmpty() && packer.getTop() == 0 && packer.getUsedArea() == 0, "a page released of everything is empty");
+
+        expect(packer.pack(tile, a) && packer.pack(Size(8), b) && packer.pack(Size(64), c), "tiles of three heights fit a page");
+        const int top2 = packer.getTop();
+        packer.release(c);
+        expect(packer.getTop() < top2, "the empty top shelf gives its rows back");
+        expect(packer.pack(Size(8), d) && d.top() == b.top(), "short rects take the shortest shelf");
+    }
+
+    // random sizes packed and released, every live rect checked against the others after each step
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> sizes(1, 96);
+    std::uniform_int_distribution<int> actions(0, 2);
+
+    AtlasPacker packer(Size(1024), padding, alignment);
+    std::vector<Rect> rects;
+    size_t usedArea = 0, packed = 0, reused = 0;
+    for (int operation = 0; operation < operations; ++operation) {
+        if (!rects.empty() && actions(rng) == 0) {
+            const size_t index = std::uniform_int_distribution<size_t>(0, rects.size() - 1)(rng);
+            usedArea -= rects[index].size().area();
+            packer.release(rects[index]);
+            rects.erase(rects.begin() + index);
+        } else {
+            const int top = packer.getTop();
+            Rect rect;
+            if (!packer.pack(Size(sizes(rng), sizes(rng)), rect))
+                continue;
+
+            expect(rect.left() >= 0 && rect.top() >= 0 && rect.right() < 1024 && rect.bottom() < 1024, "rects stay on the page");
+            expect(rect.left() % alignment == 0 && rect.top() % alignment == 0, "rects start on a block");
+
+            const Rect blocks = getMipBlocks(rect, true);
+            for (const auto& other : rects) {
+                expect(!blocks.intersects(getMipBlocks(other, false)) && !getMipBlocks(other, true).intersects(getMipBlocks(rect, false)),
+                       "rects keep an empty block from each other at the last mip level");
+            }
+
+            usedArea += rect.size().area();
+            rects.emplace_back(rect);
+            ++packed;
+            if (packer.getTop() == top)
+                ++reused;
+        }
+
+        expect(packer.getAllocations() == static_cast<int>(rects.size()) && packer.getUsedArea() == usedArea, "the packer counts what it holds");
+    }
+
+    for (const auto& rect : rects)
+        packer.release(rect);
+    expect(packer.isEmpty() && packer.getTop() == 0, "a page released of everything is empty");
+
+    std::cout << fmt::format("atlas packer check: {} rects packed, {} without a new shelf, {} failures\n", packed, reused, m_failures);
+    return m_failures == 0;
+}
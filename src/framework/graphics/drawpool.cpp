@@ -22,19 +22,25 @@
 
 #include "drawpool.h"
 
-DrawPool* DrawPool::create(const DrawPoolType type)
+DrawPool* DrawPool::create(const DrawPoolType type, const bool nullBackend)
 {
     auto pool = new DrawPool;
     if (type == DrawPoolType::MAP || type == DrawPoolType::FOREGROUND) {
-        pool->setFramebuffer({});
+        pool->m_cached = true;
+        if (!nullBackend)
+            pool->setFramebuffer({});
+
         if (type == DrawPoolType::MAP) {
-            pool->m_framebuffer->m_useAlphaWriting = false;
-            pool->m_framebuffer->disableBlend();
+            if (!nullBackend) {
+                pool->m_framebuffer->m_useAlphaWriting = false;
+                pool->m_framebuffer->disableBlend();
+            }
         } else if (type == DrawPoolType::FOREGROUND) {
             pool->setFPS(10);
 
             // creates a temporary framebuffer with smoothing.
-            pool->m_temporaryFramebuffers.emplace_back(std::make_shared<FrameBuffer>());
+            if (!nullBackend)
+                pool->m_temporaryFramebuffers.emplace_back(std::make_shared<FrameBuffer>());
         }
     } else if (type == DrawPoolType::LIGHT) {
         pool->m_hashCtrl = true;
@@ -49,7 +55,7 @@ DrawPool* DrawPool::create(const DrawPoolType type)
 
 void DrawPool::add(const Color& color, const TexturePtr& texture, DrawMethod&& method, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer)
 {
-    if (!updateHash(method, texture, color, coordsBuffer != nullptr))
+    if (!canRecord(texture) || !updateHash(method, texture, color, coordsBuffer != nullptr))
         return;
 
     bool agroup = m_alwaysGroupDrawings || conductor.agroup;
@@ -62,11 +68,9 @@ void DrawPool::add(const Color& color, const TexturePtr& texture, DrawMethod&& m
         order = THIRD;
 
     if (agroup) {
-        auto& coords = m_coords.try_emplace(getCurrentState().hash, nullptr).first->second;
-        if (!coords) {
-            auto state = getState(texture, color);
-            coords = m_objects[order].emplace_back(std::move(state), getCoordsBuffer()).coords.get();
-        }
+        auto& coords = m_coords.try_emplace(m_drawHash, nullptr).first->second;
+        if (!coords)
+            coords = getCoordsBuffer(m_objects[order].emplace_back(record(texture, color, order)));
 
         if (coordsBuffer)
             coords->append(coordsBuffer.get());
@@ -77,25 +81,24 @@ void DrawPool::add(const Color& color, const TexturePtr& texture, DrawMethod&& m
 
         auto& list = m_objects[order];
         if (!list.empty()) {
-            auto& prevObj = list.back();
-            if (prevObj.state == getCurrentState()) {
+            const auto& prevObj = list.back();
+            if (!prevObj.isAction() && prevObj.hash == m_drawHash) {
                 if (coordsBuffer)
-                    prevObj.coords->append(coordsBuffer.get());
+                    getCoordsBuffer(prevObj)->append(coordsBuffer.get());
                 else
-                    addCoords(prevObj.coords.get(), method);
+                    addCoords(getCoordsBuffer(prevObj), method);
 
                 addNewObj = false;
             }
         }
 
         if (addNewObj) {
-            auto state = getState(texture, color);
-            auto& draw = list.emplace_back(std::move(state), getCoordsBuffer());
+            const auto coords = getCoordsBuffer(list.emplace_back(record(texture, color, order)));
 
             if (coordsBuffer) {
-                draw.coords->append(coordsBuffer.get());
+                coords->append(coordsBuffer.get());
             } else
-                addCoords(draw.coords.get(), method);
+                addCoords(coords, method);
         }
     }
 
@@ -117,41 +120,54 @@ void DrawPool::addCoords(CoordsBuffer* buffer, const DrawMethod& method)
     }
 }
 
-bool DrawPool::updateHash(const DrawMethod& method, const TexturePtr& texture, const Color& color, const bool hasCoord) {
-    auto& state = getCurrentState();
-    state.hash = 0;
+size_t DrawPool::getStateHash()
+{
+    if (!m_stateHashDirty)
+        return m_stateHash;
+
+    const auto& state = std::as_const(*this).getCurrentState();
+    m_stateHash = 0;
+    m_stateHashDirty = false;
 
     { // State Hash
+        auto& hash = m_stateHash;
         if (m_bindedFramebuffers)
-            stdext::hash_combine(state.hash, m_lastFramebufferId);
+            stdext::hash_combine(hash, m_lastFramebufferId);
 
         if (state.blendEquation != BlendEquation::ADD)
-            stdext::hash_combine(state.hash, state.blendEquation);
+            stdext::hash_combine(hash, state.blendEquation);
 
         if (state.compositionMode != CompositionMode::NORMAL)
-            stdext::hash_combine(state.hash, state.compositionMode);
+            stdext::hash_combine(hash, state.compositionMode);
 
         if (state.opacity < 1.f)
-            stdext::hash_combine(state.hash, state.opacity);
+            stdext::hash_combine(hash, state.opacity);
 
         if (state.clipRect.isValid())
-            stdext::hash_union(state.hash, state.clipRect.hash());
+            stdext::hash_union(hash, state.clipRect.hash());
 
         if (state.shaderProgram)
-            stdext::hash_union(state.hash, state.shaderProgram->hash());
+            stdext::hash_union(hash, state.shaderProgram->hash());
 
         if (state.transformMatrix != DEFAULT_MATRIX3)
-            stdext::hash_union(state.hash, state.transformMatrix.hash());
+            stdext::hash_union(hash, state.transformMatrix.hash());
+    }
 
-        if (color != Color::white)
-            stdext::hash_union(state.hash, color.hash());
+    return m_stateHash;
+}
 
-        if (texture)
-            stdext::hash_union(state.hash, texture->hash());
-    }
+bool DrawPool::updateHash(const DrawMethod& method, const TexturePtr& texture, const Color& color, const bool hasCoord) {
+    // the state only changes between batches of draws, so only the color and texture are hashed for each one
+    m_drawHash = getStateHash();
 
-    if (hasFrameBuffer()) { // Pool Hash
-        size_t hash = state.hash;
+    if (color != Color::white)
+        stdext::hash_union(m_drawHash, color.hash());
+
+    if (texture)
+        stdext::hash_union(m_drawHash, texture->hash());
+
+    if (isCached()) { // Pool Hash
+        size_t hash = m_drawHash;
 
         if (method.type == DrawMethodType::TRIANGLE) {
             if (!method.a.isNull()) stdext::hash_union(hash, method.a.hash());
@@ -174,20 +190,81 @@ bool DrawPool::updateHash(const DrawMethod& method, const TexturePtr& texture, c
     return true;
 }
 
-DrawPool::PoolState DrawPool::getState(const TexturePtr& texture, const Color& color)
+bool DrawPool::canRecord(const TexturePtr& texture)
+{
+    const auto& state = m_states[m_lastStateIndex];
+    const auto& frame = m_frames[0];
+
+    // a new entry would wrap its 16-bit index or take NO_INDEX
+    const bool full = (state.drawStateIndex == NO_INDEX && frame.states.size() >= NO_INDEX)
+        || (texture && (texture->isEmpty() || texture->hasPendingUpdate()) && frame.textures.size() >= NO_INDEX)
+        || (state.shaderProgram && state.shaderIndex == NO_INDEX && frame.shaders.size() >= NO_INDEX)
+        || (state.action && state.actionIndex == NO_INDEX && frame.actions.size() >= NO_INDEX);
+
+    return !full || onFrameTableFull();
+}
+
+bool DrawPool::onFrameTableFull()
+{
+    if (!m_frameTableFull) {
+        m_frameTableFull = true;
+        g_logger.traceError("draw pool {} filled a frame table, draws needing a new entry are dropped until the next frame", static_cast<int>(m_type));
+    }
+    return false;
+}
+
+DrawPool::DrawCommand DrawPool::record(const TexturePtr& texture, const Color& color, const uint8_t order)
 {
-    PoolState copy = getCurrentState();
-    if (copy.color != color) copy.color = color;
+    auto& state = m_states[m_lastStateIndex];
+    auto& frame = m_frames[0];
+
+    DrawCommand command{
+        .sortKey = static_cast<uint64_t>(m_flushes) << 40 | static_cast<uint64_t>(order) << 32 | m_commands++,
+        .hash = m_drawHash,
+        .coords = nextCoordsBuffer(),
+        .color = color.rgba()
+    };
+
+    if (state.drawStateIndex == NO_INDEX) {
+        state.drawStateIndex = frame.states.size();
+        frame.states.emplace_back(DrawState{
+            .transformMatrix = state.transformMatrix,
+            .clipRect = state.clipRect,
+            .opacity = state.opacity,
+            .compositionMode = state.compositionMode,
+            .blendEquation = state.blendEquation
+        });
+    }
+    command.state = state.drawStateIndex;
+
     if (texture) {
-        if (texture->isEmpty()) {
-            copy.texture = texture;
+        if (texture->isEmpty() || texture->hasPendingUpdate()) {
+            // it is created on the draw thread
+            command.texture = frame.textures.size();
+            frame.textures.emplace_back(texture);
         } else {
-            copy.textureId = texture->getId();
-            copy.textureMatrixId = texture->getTransformMatrixId();
+            command.textureId = texture->getId();
+            command.textureMatrixId = texture->getTransformMatrixId();
+        }
+    }
+
+    if (state.shaderProgram) {
+        if (state.shaderIndex == NO_INDEX) {
+            state.shaderIndex = frame.shaders.size();
+            frame.shaders.emplace_back(state.shaderProgram);
+        }
+        command.shader = state.shaderIndex;
+    }
+
+    if (state.action) {
+        if (state.actionIndex == NO_INDEX) {
+            state.actionIndex = frame.actions.size();
+            frame.actions.emplace_back(state.action);
         }
+        command.action = state.actionIndex;
     }
 
-    return copy;
+    return command;
 }
 
 void DrawPool::setCompositionMode(const CompositionMode mode, const bool onlyOnce)
@@ -216,11 +293,12 @@ void DrawPool::setOpacity(const float opacity, const bool onlyOnce)
 
 void DrawPool::setShaderProgram(const PainterShaderProgramPtr& shaderProgram, const bool onlyOnce, const std::function<void()>& action)
 {
-    if (g_painter->isReplaceColorShader(getCurrentState().shaderProgram))
+    // there is no painter on the null backend
+    if (g_painter && g_painter->isReplaceColorShader(getCurrentState().shaderProgram))
         return;
 
     if (shaderProgram) {
-        if (!g_painter->isReplaceColorShader(shaderProgram.get()))
+        if (!g_painter || !g_painter->isReplaceColorShader(shaderProgram.get()))
             m_shaderRefreshDelay = FPS20;
 
         getCurrentState().shaderProgram = shaderProgram.get();
@@ -230,6 +308,9 @@ void DrawPool::setShaderProgram(const PainterShaderProgramPtr& shaderProgram, co
         getCurrentState().action = nullptr;
     }
 
+    getCurrentState().shaderIndex = NO_INDEX;
+    getCurrentState().actionIndex = NO_INDEX;
+
     if (onlyOnce) m_onlyOnceStateFlag |= STATE_SHADER_PROGRAM;
 }
 
@@ -247,7 +328,17 @@ void DrawPool::resetState()
     getCurrentState() = {};
     m_lastFramebufferId = 0;
     m_shaderRefreshDelay = 0;
-    m_coordsCache[0].last = 0;
+    m_commands = 0;
+    m_flushes = 0;
+    m_partialRepaint = false;
+    m_frameTableFull = false;
+
+    auto& frame = m_frames[0];
+    frame.last = 0;
+    frame.states.clear();
+    frame.textures.clear();
+    frame.shaders.clear();
+    frame.actions.clear();
     m_scale = PlatformWindow::DEFAULT_DISPLAY_DENSITY;
 }
 
@@ -329,17 +420,14 @@ void DrawPool::PoolState::execute() const {
     g_painter->setShaderProgram(shaderProgram);
     g_painter->setTransformMatrix(transformMatrix);
     if (action) action();
-    if (texture) {
-        texture->create();
-        g_painter->setTexture(texture->getId(), texture->getTransformMatrixId());
-    } else
-        g_painter->setTexture(textureId, textureMatrixId);
+    g_painter->resetTexture();
 }
 
 void DrawPool::setFramebuffer(const Size& size) {
     if (!m_framebuffer) {
         m_framebuffer = std::make_shared<FrameBuffer>();
         m_framebuffer->m_isScene = true;
+        m_cached = true;
     }
 
     if (size.isValid() && m_framebuffer->resize(size)) {
@@ -351,12 +439,24 @@ void DrawPool::setFramebuffer(const Size& size) {
 void DrawPool::removeFramebuffer() {
     m_hashCtrl.reset();
     m_framebuffer = nullptr;
+    m_cached = false;
 }
 
 void DrawPool::addAction(const std::function<void()>& action)
 {
     const uint8_t order = m_type == DrawPoolType::MAP ? THIRD : FIRST;
-    m_objects[order].emplace_back(action);
+
+    auto& actions = m_frames[0].actions;
+    if (actions.size() >= NO_INDEX) {
+        onFrameTableFull();
+        return;
+    }
+
+    m_objects[order].emplace_back(DrawCommand{
+        .sortKey = static_cast<uint64_t>(m_flushes) << 40 | static_cast<uint64_t>(order) << 32 | m_commands++,
+        .action = static_cast<uint16_t>(actions.size())
+    });
+    actions.emplace_back(action);
 }
 
 void DrawPool::bindFrameBuffer(const Size& size, const Color& color)
@@ -390,7 +490,7 @@ void DrawPool::releaseFrameBuffer(const Rect& dest)
         frame->draw(dest);
     });
 
-    if (hasFrameBuffer() && !dest.isNull()) m_hashCtrl.put(dest.hash());
+    if (isCached() && !dest.isNull()) m_hashCtrl.put(dest.hash());
     --m_bindedFramebuffers;
 }
 
@@ -404,12 +504,12 @@ const FrameBufferPtr& DrawPool::getTemporaryFrameBuffer(const uint8_t index) {
     return tempfb;
 }
 
-std::shared_ptr<CoordsBuffer> DrawPool::getCoordsBuffer() {
-    if (++m_coordsCache[0].last > m_coordsCache[0].coords.size()) {
-        return  m_coordsCache[0].coords.emplace_back(std::make_shared<CoordsBuffer>());
-    }
+uint32_t DrawPool::nextCoordsBuffer() {
+    auto& frame = m_frames[0];
+    if (++frame.last > frame.coords.size()) {
+        frame.coords.emplace_back(std::make_shared<CoordsBuffer>());
+    } else
+        frame.coords[frame.last - 1]->clear();
 
-    const auto& coords = m_coordsCache[0].coords[m_coordsCache[0].last - 1];
-    coords->clear();
-    return coords;
+    return frame.last - 1;
 }
\ No newline at end of file
@@ -122,8 +122,11 @@ public:
     bool hasFrameBuffer() const { return m_framebuffer != nullptr; }
     FrameBufferPtr getFrameBuffer() const { return m_framebuffer; }
 
+    // keeps what it drew and only draws again when the hash of the drawings changes, in its framebuffer unless on the null backend
+    bool isCached() const { return m_cached; }
+
     bool canRepaint();
-    void repaint() { if (hasFrameBuffer()) m_hashCtrl.forceUpdate(); m_refreshTimer.update(-1000); }
+    void repaint() { if (isCached()) m_hashCtrl.forceUpdate(); m_refreshTimer.update(-1000); }
     void resetState();
     void scale(float factor);
 
@@ -151,7 +154,7 @@ public:
 
     void resetBuffer() {
         std::scoped_lock l(m_mutexDraw);
-        for (auto& buffer : m_coordsCache) {
+        for (auto& buffer : m_frames) {
             buffer.coords.clear();
             buffer.last = 0;
         }
@@ -176,6 +179,9 @@ protected:
         uint16_t intValue{ 0 };
     };
 
+    static constexpr uint16_t NO_INDEX = UINT16_MAX;
+    static constexpr uint32_t NO_COORDS = UINT32_MAX;
+
     struct PoolState
     {
         Matrix3 transformMatrix = DEFAULT_MATRIX3;
@@ -186,24 +192,48 @@ protected:
         PainterShaderProgram* shaderProgram{ nullptr };
         std::function<void()> action{ nullptr };
         Color color{ Color::white };
-        TexturePtr texture;
-        uint32_t textureId{ 0 };
-        uint16_t textureMatrixId{ 0 };
-        size_t hash{ 0 };
 
-        bool operator==(const PoolState& s2) const { return hash == s2.hash; }
+        // where the draw state, the shader and its action went in the tables of the frame, once a draw used them
+        uint16_t drawStateIndex{ NO_INDEX };
+        uint16_t shaderIndex{ NO_INDEX };
+        uint16_t actionIndex{ NO_INDEX };
+
         void execute() const;
     };
 
-    struct DrawObject
+    // What a draw takes from the pool state, shared in the tables of the frame by the draws recorded with that state
+    struct DrawState
     {
-        DrawObject(std::function<void()> action) : action(std::move(action)) {}
-        DrawObject(PoolState&& state, const std::shared_ptr<CoordsBuffer>& coords) : coords(coords), state(std::move(state)) {}
-        std::function<void()> action{ nullptr };
-        std::shared_ptr<CoordsBuffer> coords;
-        PoolState state;
+        Matrix3 transformMatrix = DEFAULT_MATRIX3;
+        Rect clipRect;
+        float opacity{ 1.f };
+        CompositionMode compositionMode{ CompositionMode::NORMAL };
+        BlendEquation blendEquation{ BlendEquation::ADD };
     };
 
+    // A recorded draw. Everything that is not plain data (the draw state, textures still to be uploaded, shaders, actions, coords)
+    // lives in the tables of the frame and is referenced by index, so commands are copied and moved as bytes.
+    struct DrawCommand
+    {
+        // position of the command in the frame: flush, draw order, then recording order
+        uint64_t sortKey{ 0 };
+        size_t hash{ 0 };
+
+        uint32_t textureId{ 0 };
+        uint32_t coords{ NO_COORDS };
+        // rgba, white by default
+        uint32_t color{ 0xFFFFFFFF };
+        uint16_t textureMatrixId{ 0 };
+        uint16_t texture{ NO_INDEX };
+        uint16_t state{ NO_INDEX };
+        uint16_t shader{ NO_INDEX };
+        // the action of the shader, or the whole command when it has no coords
+        uint16_t action{ NO_INDEX };
+
+        bool isAction() const { return coords == NO_COORDS; }
+    };
+    static_assert(std::is_trivially_copyable_v<DrawCommand>);
+
     struct DrawObjectState
     {
         CompositionMode compositionMode{ CompositionMode::NORMAL };
@@ -215,7 +245,7 @@ protected:
     };
 
 private:
-    static DrawPool* create(DrawPoolType type);
+    static DrawPool* create(DrawPoolType type, bool nullBackend);
     static void addCoords(CoordsBuffer* buffer, const DrawMethod& method);
 
     enum STATE_TYPE : uint32_t
@@ -237,13 +267,24 @@ private:
     void setFPS(const uint16_t fps) { m_refreshDelay = 1000 / fps; }
 
     bool updateHash(const DrawMethod& method, const TexturePtr& texture, const Color& color, bool hasCoord);
-    PoolState getState(const TexturePtr& texture, const Color& color);
-
-    PoolState& getCurrentState() { return m_states[m_lastStateIndex]; }
+    size_t getStateHash();
+    DrawCommand record(const TexturePtr& texture, const Color& color, uint8_t order);
+    // whether the tables of the frame still have an index for what a draw would add to them
+    bool canRecord(const TexturePtr& texture);
+    bool onFrameTableFull();
+
+    // anything that may change the state goes through here, its hash is taken again and it gets a new draw state on the next draw
+    PoolState& getCurrentState()
+    {
+        m_stateHashDirty = true;
+        auto& state = m_states[m_lastStateIndex];
+        state.drawStateIndex = NO_INDEX;
+        return state;
+    }
     const PoolState& getCurrentState() const { return m_states[m_lastStateIndex]; }
 
     float getOpacity() const { return getCurrentState().opacity; }
-    Rect getClipRect() { return getCurrentState().clipRect; }
+    Rect getClipRect() const { return getCurrentState().clipRect; }
 
     void setCompositionMode(CompositionMode mode, bool onlyOnce = false);
     void setBlendEquation(BlendEquation equation, bool onlyOnce = false);
@@ -266,7 +307,8 @@ private:
     void rotate(float x, float y, float angle);
     void rotate(const Point& p, const float angle) { rotate(p.x, p.y, angle); }
 
-    std::shared_ptr<CoordsBuffer> getCoordsBuffer();
+    uint32_t nextCoordsBuffer();
+    CoordsBuffer* getCoordsBuffer(const DrawCommand& command) const { return m_frames[0].coords[command.coords].get(); }
 
     template<typename T>
     void setParameter(std::string_view name, T&& value) {
@@ -293,8 +335,9 @@ private:
     void flush()
     {
         m_coords.clear();
+        ++m_flushes;
         for (auto& objs : m_objects) {
-            m_objectsFlushed.insert(m_objectsFlushed.end(), make_move_iterator(objs.begin()), make_move_iterator(objs.end()));
+            m_objectsFlushed.insert(m_objectsFlushed.end(), objs.begin(), objs.end());
             objs.clear();
         }
     }
@@ -303,27 +346,17 @@ private:
         m_objectsDraw.clear();
 
         if (flush) {
-            if (!m_objectsFlushed.empty()) {
-                if (m_objectsDraw.size() < m_objectsFlushed.size())
-                    m_objectsDraw.swap(m_objectsFlushed);
-
-                if (!m_objectsFlushed.empty())
-                    m_objectsDraw.insert(m_objectsDraw.end(), make_move_iterator(m_objectsFlushed.begin()), make_move_iterator(m_objectsFlushed.end()));
-            }
-
+            // commands are plain bytes, so they are copied in the order of their sort key into a list that keeps its capacity
+            m_objectsDraw.insert(m_objectsDraw.end(), m_objectsFlushed.begin(), m_objectsFlushed.end());
             for (auto& objs : m_objects) {
-                if (m_objectsDraw.size() < objs.size())
-                    m_objectsDraw.swap(objs);
-
-                if (!objs.empty()) {
-                    m_objectsDraw.insert(m_objectsDraw.end(), make_move_iterator(objs.begin()), make_move_iterator(objs.end()));
-                    objs.clear();
-                }
+                m_objectsDraw.insert(m_objectsDraw.end(), objs.begin(), objs.end());
+                objs.clear();
             }
         }
 
         m_objectsFlushed.clear();
-        std::swap(m_coordsCache[0], m_coordsCache[1]);
+        std::swap(m_frames[0], m_frames[1]);
+        m_drawPartialRepaint = m_partialRepaint;
     }
 
     void resetOnlyOnceParameters() {
@@ -349,17 +382,24 @@ private:
 
     void nextStateAndReset() {
         m_states[++m_lastStateIndex] = {};
+        m_stateHashDirty = true;
     }
 
     void backState() {
         --m_lastStateIndex;
+        m_stateHashDirty = true;
     }
 
     const FrameBufferPtr& getTemporaryFrameBuffer(uint8_t index);
 
     bool m_enabled{ true };
+    bool m_cached{ false };
     bool m_alwaysGroupDrawings{ false };
 
+    // the frame only draws over parts of the previous one, so its framebuffer is not cleared before
+    bool m_partialRepaint{ false };
+    bool m_drawPartialRepaint{ false };
+
     int_fast8_t m_bindedFramebuffers{ -1 };
 
     uint16_t m_refreshDelay{ 0 }, m_shaderRefreshDelay{ 0 };
@@ -369,6 +409,15 @@ private:
     PoolState m_states[10];
     uint_fast8_t m_lastStateIndex{ 0 };
 
+    // hash of the current state without the color and texture of a draw, and of the last draw with them
+    size_t m_stateHash{ 0 };
+    size_t m_drawHash{ 0 };
+    bool m_stateHashDirty{ true };
+
+    uint32_t m_commands{ 0 };
+    uint16_t m_flushes{ 0 };
+    bool m_frameTableFull{ false };
+
     DrawPoolType m_type{ DrawPoolType::LAST };
 
     Timer m_refreshTimer;
@@ -378,15 +427,21 @@ private:
     std::vector<Matrix3> m_transformMatrixStack;
     std::vector<FrameBufferPtr> m_temporaryFramebuffers;
 
-    std::vector<DrawObject> m_objects[static_cast<uint8_t>(LAST)];
-    std::vector<DrawObject> m_objectsFlushed;
-    std::vector<DrawObject> m_objectsDraw;
+    std::vector<DrawCommand> m_objects[static_cast<uint8_t>(LAST)];
+    std::vector<DrawCommand> m_objectsFlushed;
+    std::vector<DrawCommand> m_objectsDraw;
 
+    // what the commands of a frame reference, the one being recorded and the one being drawn
     struct
     {
         std::vector<std::shared_ptr<CoordsBuffer>> coords;
         uint_fast32_t last{ 0 };
-    } m_coordsCache[2];
+
+        std::vector<DrawState> states;
+        std::vector<TexturePtr> textures;
+        std::vector<PainterShaderProgram*> shaders;
+        std::vector<std::function<void()>> actions;
+    } m_frames[2];
 
     stdext::map<size_t, CoordsBuffer*> m_coords;
     stdext::map<std::string_view, std::any> m_parameters;
@@ -403,6 +458,9 @@ private:
     std::mutex m_mutexDraw;
 
     friend class DrawPoolManager;
+#ifdef CLIENT_CHECKS
+    friend class DrawPoolCheck;
+#endif
 };
 
 extern DrawPoolManager g_drawPool;
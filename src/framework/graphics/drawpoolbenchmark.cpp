@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "drawpoolbenchmark.h"
+#include "drawpoolmanager.h"
+#include "image.h"
+#include "texture.h"
+
+namespace
+{
+    // a screen of the map the size of the default view, with every tile taken
+    constexpr int tilesX = 18;
+    constexpr int tilesY = 14;
+    constexpr int tileSize = 32;
+
+    void drawMap(const std::vector<TexturePtr>& textures, const int frame)
+    {
+        const Rect src(0, 0, tileSize, tileSize);
+        const int offset = frame % tileSize;
+
+        // two floors, the upper one flushed on top of the lower one like the map view does
+        for (int floor = 0; floor < 2; ++floor) {
+            for (int x = 0; x < tilesX; ++x) {
+                for (int y = 0; y < tilesY; ++y) {
+                    const Rect dest(x * tileSize - offset, y * tileSize - offset, tileSize, tileSize);
+                    const size_t id = x * 7 + y * 3 + floor;
+
+                    g_drawPool.addTexturedRect(dest, textures[id % 8], src, Color::white, { .order = FIRST });
+                    g_drawPool.addTexturedRect(dest, textures[8 + id % 24], src, Color::white, { .order = THIRD });
+
+                    if (id % 5 == 0) {
+                        // a creature, half of them invisible, with its health bar
+                        if (id % 2)
+                            g_drawPool.setOpacity(0.5f, true);
+                        g_drawPool.addTexturedRect(dest, textures[32 + id % 32], src, Color::white, { .order = THIRD });
+                        g_drawPool.addBoundingRect(Rect(dest.topLeft(), tileSize, 4), Color::black, 1, { .agroup = true, .order = FOURTH });
+                        g_drawPool.addFilledRect(Rect(dest.topLeft() + Point(1, 1), tileSize - 2, 2), Color::green, { .agroup = true, .order = FOURTH });
+                    }
+                }
+            }
+            g_drawPool.flush();
+        }
+    }
+
+    void drawForeground(const std::vector<TexturePtr>& textures, const int frame)
+    {
+        // panels of clipped widgets with a background, a border and an icon
+        for (int panel = 0; panel < 8; ++panel) {
+            const Rect clip(panel * 100, 0, 100, 600);
+            for (int widget = 0; widget < 24; ++widget) {
+                const Rect dest(clip.x() + 2, widget * 24 + frame % 2, 96, 22);
+                g_drawPool.setClipRect(clip, true);
+                g_drawPool.addFilledRect(dest, Color(0x22, 0x22, 0x22));
+                g_drawPool.addBoundingRect(dest, Color::gray);
+                g_drawPool.addTexturedRect(Rect(dest.topLeft(), 16, 16), textures[(panel + widget) % textures.size()], Rect(0, 0, 16, 16));
+            }
+        }
+    }
+}
+
+bool DrawPoolBenchmark::run(const int frames)
+{
+    if (!g_drawPool.isNullBackend()) {
+        g_logger.error("Draw pool benchmark: the pools were not created on the null backend.");
+        return false;
+    }
+
+    std::vector<TexturePtr> textures;
+    for (int i = 0; i < 64; ++i)
+        textures.emplace_back(std::make_shared<Texture>(std::make_shared<Image>(Size(tileSize))));
+
+    ticks_t recordTime = 0;
+    ticks_t drawTime = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        ticks_t start = stdext::micros();
+        g_drawPool.preDraw(DrawPoolType::MAP, [&] { drawMap(textures, frame); });
+        g_drawPool.preDraw(DrawPoolType::FOREGROUND, [&] { drawForeground(textures, frame); }, true);
+        recordTime += stdext::micros() - start;
+
+        start = stdext::micros();
+        g_drawPool.drawPool(DrawPoolType::MAP);
+        g_drawPool.drawPool(DrawPoolType::FOREGROUND);
+        drawTime += stdext::micros() - start;
+    }
+
+    const auto& stats = g_drawPool.getNullBackendStats();
+    const int count = std::max(frames, 1);
+    std::cout << fmt::format("{} frames, {} commands/frame, {} vertices/frame, {} texture and {} state changes/frame\n", frames,
+                             stats.commands / count, stats.vertices / count, stats.textureChanges / count, stats.stateChanges / count);
+    std::cout << fmt::format("record {:.2f} us/frame, draw {:.2f} us/frame\n", static_cast<double>(recordTime) / count,
+                             static_cast<double>(drawTime) / count);
+    return true;
+}
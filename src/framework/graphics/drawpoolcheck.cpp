@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "drawpoolcheck.h"
+#include "drawpoolmanager.h"
+#include "image.h"
+#include "texture.h"
+
+void DrawPoolCheck::expect(const bool condition, const std::string_view what)
+{
+    if (!condition) {
+        g_logger.error("Draw pool check failed: {}", what);
+        ++m_failures;
+    }
+}
+
+bool DrawPoolCheck::run()
+{
+    if (!g_drawPool.isNullBackend()) {
+        g_logger.error("Draw pool check: the pools were not created on the null backend.");
+        return false;
+    }
+
+    const auto pool = g_drawPool.get(DrawPoolType::MAP);
+    const auto& commands = pool->m_objectsDraw;
+    const auto& frame = pool->m_frames[1];
+
+    // records a scene, hands its commands to the checks and lets the null backend draw them
+    const auto scene = [&](const std::function<void()>& record, const std::function<void()>& check) {
+        g_drawPool.preDraw(DrawPoolType::MAP, record, true);
+        check();
+        g_drawPool.drawPool(DrawPoolType::MAP);
+    };
+
+    // not uploaded yet, so it goes in the texture table of the frame
+    const auto texture = std::make_shared<Texture>(std::make_shared<Image>(Size(32)));
+    const Rect src(0, 0, 32, 32);
+
+    scene([&] {
+        g_drawPool.addTexturedRect(Rect(0, 0, 32, 32), texture, src, Color::white, { .order = THIRD });
+        g_drawPool.addTexturedRect(Rect(32, 0, 32, 32), texture, src, Color::white, { .order = THIRD });
+    }, [&] {
+        expect(commands.size() == 1, "two draws of the same state are one command");
+        if (commands.size() != 1)
+            return;
+
+        const auto& command = commands[0];
+        expect(frame.coords[command.coords]->getVertexCount() == 12, "the merged command holds both rects");
+        expect(command.texture == 0 && frame.textures.size() == 1 && frame.textures[0] == texture, "the pending texture is in the table");
+    });
+
+    scene([&] {
+        g_drawPool.addFilledRect(Rect(0, 0, 8, 8), Color::red, { .order = THIRD });
+        g_drawPool.addFilledRect(Rect(0, 0, 8, 8), Color::green, { .order = FIRST });
+        g_drawPool.flush();
+        g_drawPool.addFilledRect(Rect(0, 0, 8, 8), Color::blue, { .order = FIRST });
+    }, [&] {
+        expect(commands.size() == 3, "three draws of different colors are three commands");
+        if (commands.size() != 3)
+            return;
+
+        expect(commands[0].color == Color::green.rgba() && commands[1].color == Color::red.rgba() && commands[2].color == Color::blue.rgba(),
+               "commands are drawn by flush, then draw order");
+        expect(frame.states.size() == 1 && commands[0].state == 0 && commands[1].state == 0 && commands[2].state == 0,
+               "draws of the same state share its entry");
+        expect(commands[0].sortKey < commands[1].sortKey && commands[1].sortKey < commands[2].sortKey, "sort keys follow the draw order");
+        expect(commands[0].texture == DrawPool::NO_INDEX && commands[0].shader == DrawPool::NO_INDEX && commands[0].action == DrawPool::NO_INDEX,
+               "a plain fill references no table");
+    });
+
+    scene([&] {
+        g_drawPool.addFilledRect(Rect(0, 0, 8, 8), Color::red, { .order = THIRD });
+        g_drawPool.setOpacity(0.5f, true);
+        g_drawPool.addFilledRect(Rect(8, 0, 8, 8), Color::red, { .order = THIRD });
+        g_drawPool.addFilledRect(Rect(16, 0, 8, 8), Color::red, { .order = THIRD });
+    }, [&] {
+        expect(commands.size() == 3, "a state change between draws splits the command");
+        if (commands.size() != 3)
+            return;
+
+        expect(frame.states[commands[0].state].opacity == 1.f && frame.states[commands[1].state].opacity == 0.5f
+               && frame.states[commands[2].state].opacity == 1.f, "a command draws with the state it was recorded with");
+    });
+
+    int calls = 0;
+    g_drawPool.resetNullBackendStats();
+    scene([&] {
+        g_drawPool.addAction([&calls] { ++calls; });
+        g_drawPool.addAction([&calls] { calls += 10; });
+    }, [&] {
+        expect(commands.size() == 2 && frame.actions.size() == 2, "each action is a command");
+        for (const auto& command : commands) {
+            expect(command.isAction() && command.action < frame.actions.size(), "an action command references the action table");
+            if (command.action < frame.actions.size())
+                frame.actions[command.action]();
+        }
+        expect(calls == 11, "action commands run their own action");
+    });
+    expect(g_drawPool.getNullBackendStats().actions == 2, "the null backend counts the actions");
+
+    // every index but NO_INDEX is taken, the next draw needing one is dropped instead of wrapping
+    scene([&] {
+        for (size_t i = 0; i <= DrawPool::NO_INDEX; ++i)
+            g_drawPool.addAction([] {});
+    }, [&] {
+        expect(commands.size() == DrawPool::NO_INDEX && frame.actions.size() == DrawPool::NO_INDEX, "actions stop at the last index");
+        expect(!commands.empty() && commands.back().action == DrawPool::NO_INDEX - 1, "the last action takes the last index");
+    });
+
+    scene([&] {
+        for (size_t i = 0; i <= DrawPool::NO_INDEX; ++i)
+            g_drawPool.addTexturedRect(Rect(0, 0, 32, 32), texture, src, i % 2 ? Color::white : Color::black);
+    }, [&] {
+        expect(frame.textures.size() == DrawPool::NO_INDEX, "pending textures stop at the last index");
+        expect(std::ranges::none_of(commands, [](const auto& command) { return command.texture == DrawPool::NO_INDEX; }),
+               "no textured command lost its texture");
+    });
+
+    std::cout << fmt::format("draw pool check: {} failures\n", m_failures);
+    return m_failures == 0;
+}
@@ -40,7 +40,7 @@ void DrawPoolManager::init(const uint16_t spriteSize)
 
     // Create Pools
     for (int8_t i = -1; ++i < static_cast<uint8_t>(DrawPoolType::LAST);) {
-        m_pools[i] = DrawPool::create(static_cast<DrawPoolType>(i));
+        m_pools[i] = DrawPool::create(static_cast<DrawPoolType>(i), m_nullBackend);
     }
 }
 
@@ -59,7 +59,7 @@ bool DrawPoolManager::isPreDrawing() const { return CURRENT_POOL != static_cast<
 
 void DrawPoolManager::draw()
 {
-    if (m_size != g_graphics.getViewportSize()) {
+    if (!m_nullBackend && m_size != g_graphics.getViewportSize()) {
         m_size = g_graphics.getViewportSize();
         m_transformMatrix = g_painter->getTransformMatrix(m_size);
         g_painter->setResolution(m_size, m_transformMatrix);
@@ -70,14 +70,54 @@ void DrawPoolManager::draw()
     }
 }
 
-void DrawPoolManager::drawObject(const DrawPool::DrawObject& obj)
+void DrawPoolManager::drawObject(const DrawPool& pool, const DrawPool::DrawCommand& command)
 {
-    if (obj.action) {
-        obj.action();
-    } else {
-        obj.state.execute();
-        g_painter->drawCoords(*obj.coords, DrawMode::TRIANGLES);
+    // the frame recorded last, swapped in by DrawPool::release
+    const auto& frame = pool.m_frames[1];
+    if (command.isAction()) {
+        frame.actions[command.action]();
+        return;
+    }
+
+    const auto& state = frame.states[command.state];
+    g_painter->setColor(Color(command.color));
+    g_painter->setOpacity(state.opacity);
+    g_painter->setCompositionMode(state.compositionMode);
+    g_painter->setBlendEquation(state.blendEquation);
+    g_painter->setClipRect(state.clipRect);
+    g_painter->setShaderProgram(command.shader != DrawPool::NO_INDEX ? frame.shaders[command.shader] : nullptr);
+    g_painter->setTransformMatrix(state.transformMatrix);
+    if (command.action != DrawPool::NO_INDEX) frame.actions[command.action]();
+    if (command.texture != DrawPool::NO_INDEX) {
+        const auto& texture = frame.textures[command.texture];
+        texture->create();
+        g_painter->setTexture(texture->getId(), texture->getTransformMatrixId());
+    } else
+        g_painter->setTexture(command.textureId, command.textureMatrixId);
+
+    g_painter->drawCoords(*frame.coords[command.coords], DrawMode::TRIANGLES);
+}
+
+void DrawPoolManager::countObject(const DrawPool& pool, const DrawPool::DrawCommand& command)
+{
+    const auto& frame = pool.m_frames[1];
+    auto& stats = m_nullBackendStats;
+    ++stats.commands;
+
+    if (command.isAction()) {
+        // actions bind framebuffers and set uniforms, none of which exists here
+        ++stats.actions;
+        return;
     }
+
+    const auto& last = m_lastNullCommand;
+    if (command.texture != DrawPool::NO_INDEX || command.textureId != last.textureId)
+        ++stats.textureChanges;
+    if (command.hash != last.hash)
+        ++stats.stateChanges;
+
+    stats.vertices += frame.coords[command.coords]->getVertexCount();
+    m_lastNullCommand = command;
 }
 
 void DrawPoolManager::addTexturedCoordsBuffer(const TexturePtr& texture, const CoordsBufferPtr& coords, const Color& color, const DrawConductor& condutor) const
@@ -182,7 +222,7 @@ void DrawPoolManager::preDraw(const DrawPoolType type, const std::function<void(
     if (beforeRelease)
         beforeRelease();
 
-    if (pool->hasFrameBuffer())
+    if (pool->hasFrameBuffer() && !m_nullBackend)
         pool->m_framebuffer->prepare(dest, src, colorClear);
 
     pool->release(pool->m_repaint = alwaysDraw || pool->canRepaint());
@@ -202,11 +242,26 @@ void DrawPoolManager::drawPool(const DrawPoolType type) {
 
     std::scoped_lock l(pool->m_mutexDraw);
 
+    if (m_nullBackend) {
+        if (pool->m_repaint.exchange(false, std::memory_order_acq_rel)) {
+            m_lastNullCommand = {};
+            uint64_t lastSortKey = 0;
+            for (const auto& command : pool->m_objectsDraw) {
+                assert(command.sortKey >= lastSortKey);
+                lastSortKey = command.sortKey;
+                countObject(*pool, command);
+            }
+        }
+
+        pool->m_objectsDraw.clear();
+        return;
+    }
+
     if (pool->hasFrameBuffer()) {
         if (pool->m_repaint.exchange(false, std::memory_order_acq_rel)) {
-            pool->m_framebuffer->bind();
-            for (const auto& obj : pool->m_objectsDraw)
-                drawObject(obj);
+            pool->m_framebuffer->bind(!pool->m_drawPartialRepaint);
+            for (const auto& command : pool->m_objectsDraw)
+                drawObject(*pool, command);
             pool->m_framebuffer->release();
         }
 
@@ -221,8 +276,8 @@ void DrawPoolManager::drawPool(const DrawPoolType type) {
         if (pool->m_afterDraw) pool->m_afterDraw();
     } else {
         pool->m_repaint.store(false, std::memory_order_release);
-        for (const auto& obj : pool->m_objectsDraw) {
-            drawObject(obj);
+        for (const auto& command : pool->m_objectsDraw) {
+            drawObject(*pool, command);
         }
     }
 }
\ No newline at end of file
@@ -26,6 +26,16 @@
 #include <framework/graphics/drawpool.h>
 #include <framework/graphics/framebuffer.h>
 
+// What the null backend was asked to draw, counted in place of drawing it.
+struct NullBackendStats
+{
+    uint64_t commands{ 0 };
+    uint64_t actions{ 0 };
+    uint64_t vertices{ 0 };
+    uint64_t textureChanges{ 0 };
+    uint64_t stateChanges{ 0 };
+};
+
 class DrawPoolManager
 {
 public:
@@ -54,6 +64,9 @@ public:
     void addBoundingRect(const Rect& dest, const Color& color = Color::white, uint16_t innerLineWidth = 1, const DrawConductor& condutor = DEFAULT_DRAW_CONDUCTOR) const;
     void addAction(const std::function<void()>& action) const { getCurrentPool()->addAction(action); }
 
+    // the pool keeps what its framebuffer has and only draws over it, for frames that only update some regions
+    void setPartialRepaint() const { getCurrentPool()->m_partialRepaint = true; }
+
     void bindFrameBuffer(const Size& size, const Color& color = Color::white) const { getCurrentPool()->bindFrameBuffer(size, color); }
     void releaseFrameBuffer(const Rect& dest) const { getCurrentPool()->releaseFrameBuffer(dest); };
 
@@ -62,7 +75,7 @@ public:
     void setBlendEquation(const BlendEquation equation, const bool onlyOnce = false) const { getCurrentPool()->setBlendEquation(equation, onlyOnce); }
     void setCompositionMode(const CompositionMode mode, const bool onlyOnce = false) const { getCurrentPool()->setCompositionMode(mode, onlyOnce); }
 
-    bool shaderNeedFramebuffer() const { return getCurrentPool()->getCurrentState().shaderProgram && getCurrentPool()->getCurrentState().shaderProgram->useFramebuffer(); }
+    bool shaderNeedFramebuffer() const { const auto& state = std::as_const(*getCurrentPool()).getCurrentState(); return state.shaderProgram && state.shaderProgram->useFramebuffer(); }
     void setShaderProgram(const PainterShaderProgramPtr& shaderProgram, const std::function<void()>& action) const { getCurrentPool()->setShaderProgram(shaderProgram, false, action); }
     void setShaderProgram(const PainterShaderProgramPtr& shaderProgram, const bool onlyOnce = false, const std::function<void()>& action = nullptr) const { getCurrentPool()->setShaderProgram(shaderProgram, onlyOnce, action); }
 
@@ -107,13 +120,21 @@ public:
 
     bool isPreDrawing() const;
 
+    // Records the pools as usual but only counts what they would draw, without touching OpenGL,
+    // so the pools can be built and measured without a GPU. Set before the pools are created.
+    void setNullBackend(const bool v) { assert(!m_pools[0]); m_nullBackend = v; }
+    bool isNullBackend() const { return m_nullBackend; }
+    const NullBackendStats& getNullBackendStats() const { return m_nullBackendStats; }
+    void resetNullBackendStats() { m_nullBackendStats = {}; }
+
 private:
     DrawPool* getCurrentPool() const;
 
     void draw();
     void init(uint16_t spriteSize);
     void terminate() const;
-    void drawObject(const DrawPool::DrawObject& obj);
+    void drawObject(const DrawPool& pool, const DrawPool::DrawCommand& command);
+    void countObject(const DrawPool& pool, const DrawPool::DrawCommand& command);
     void drawPool(DrawPoolType type);
 
     std::array<DrawPool*, static_cast<uint8_t>(DrawPoolType::LAST)> m_pools{};
@@ -123,7 +144,15 @@ private:
 
     uint16_t m_spriteSize{ 32 };
 
+    bool m_nullBackend{ false };
+    NullBackendStats m_nullBackendStats;
+    DrawPool::DrawCommand m_lastNullCommand;
+
     friend class GraphicalApplication;
+#ifdef CLIENT_CHECKS
+    friend class DrawPoolBenchmark;
+    friend class DrawPoolCheck;
+#endif
 };
 
 extern DrawPoolManager g_drawPool;
@@ -79,7 +79,7 @@ bool FrameBuffer::resize(const Size& size)
     return true;
 }
 
-void FrameBuffer::bind()
+void FrameBuffer::bind(const bool clear)
 {
     internalBind();
 
@@ -93,6 +93,9 @@ void FrameBuffer::bind()
     g_painter->setResolution(getSize(), m_textureMatrix);
     g_painter->setAlphaWriting(m_useAlphaWriting);
 
+    if (!clear)
+        return;
+
     if (m_colorClear != Color::alpha) {
         g_painter->resetTexture();
         g_painter->setColor(m_colorClear);
@@ -33,7 +33,7 @@ public:
     ~FrameBuffer();
 
     void release() const;
-    void bind();
+    void bind(bool clear = true);
     void draw();
     void draw(const Rect& dest) { prepare(dest, Rect(0, 0, getSize())); draw(); }
 
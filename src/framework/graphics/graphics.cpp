@@ -24,6 +24,7 @@
 #include "fontmanager.h"
 
 #include "painter.h"
+#include "textureatlas.h"
 #include "texturemanager.h"
 #include <framework/platform/platformwindow.h>
 
@@ -91,6 +92,7 @@ void Graphics::terminate()
 {
     g_painter = nullptr;
     g_fonts.terminate();
+    g_textureAtlas.clear();
     g_textures.terminate();
 
     m_ok = false;
@@ -22,81 +22,105 @@
 
 #include "particle.h"
 #include "drawpoolmanager.h"
+#include "particletype.h"
 
 #include <framework/graphics/animatedtexture.h>
 
-void Particle::render() const
+void ParticleStore::add(const ParticleTypePtr& type, const PointF& position, const PointF& velocity, const PointF& acceleration,
+                        const float duration, const Size& startSize, const Size& finalSize)
 {
-    if (!m_texture) {
-        g_drawPool.addFilledRect(m_rect, m_color);
-        return;
+    auto it = std::find(m_types.begin(), m_types.end(), type);
+    if (it == m_types.end()) {
+        if (m_types.size() > std::numeric_limits<uint8_t>::max())
+            return;
+        it = m_types.insert(m_types.end(), type);
     }
 
-    g_drawPool.setCompositionMode(m_compositionMode, true);
-    if (m_animatedTexture) {
-        const auto& frame = m_animatedTexture->getCurrentFrame();
-        if (frame)
-            g_drawPool.addTexturedRect(m_rect, frame, m_color);
-        return;
-    }
-    g_drawPool.addTexturedRect(m_rect, m_texture, m_color);
+    m_type.emplace_back(static_cast<uint8_t>(it - m_types.begin()));
+    m_positionX.emplace_back(position.x);
+    m_positionY.emplace_back(position.y);
+    m_velocityX.emplace_back(velocity.x);
+    m_velocityY.emplace_back(velocity.y);
+    m_accelerationX.emplace_back(acceleration.x);
+    m_accelerationY.emplace_back(acceleration.y);
+    m_startWidth.emplace_back(startSize.width());
+    m_startHeight.emplace_back(startSize.height());
+    m_finalWidth.emplace_back(finalSize.width());
+    m_finalHeight.emplace_back(finalSize.height());
+    m_duration.emplace_back(duration);
+    m_ignorePhysicsAfter.emplace_back(type->pIgnorePhysicsAfter);
+    m_elapsed.emplace_back(0.f);
 }
 
-void Particle::update(const float elapsedTime)
+void ParticleStore::removeFinished()
 {
-    // check if finished
-    if (m_duration >= 0 && m_elapsedTime >= m_duration) {
-        m_finished = true;
-        return;
-    }
+    size_t kept = 0;
+    for (size_t i = 0, count = size(); i < count; ++i) {
+        if (m_duration[i] >= 0 && m_elapsed[i] >= m_duration[i])
+            continue;
 
-    if (m_animatedTexture)
-        m_animatedTexture->update();
-
-    updateColor();
-    updateSize();
-    updatePosition(elapsedTime);
+        if (kept != i)
+            forEachAttribute([kept, i](auto& values) { values[kept] = values[i]; });
+        ++kept;
+    }
 
-    m_elapsedTime += elapsedTime;
+    if (kept != size())
+        forEachAttribute([kept](auto& values) { values.resize(kept); });
 }
 
-void Particle::updatePosition(const float elapsedTime)
+void ParticleStore::update(const float elapsedTime)
 {
-    if (m_ignorePhysicsAfter < 0 || m_elapsedTime < m_ignorePhysicsAfter) {
-        // update position
-        PointF delta = m_velocity * elapsedTime;
-        delta.y *= -1; // painter orientate Y axis in the inverse direction
+    for (const auto& type : m_types) {
+        if (type->pAnimatedTexture)
+            type->pAnimatedTexture->update();
+    }
 
-        const auto& position = m_position + delta;
+    const size_t count = size();
+    float* positionX = m_positionX.data();
+    float* positionY = m_positionY.data();
+    float* velocityX = m_velocityX.data();
+    float* velocityY = m_velocityY.data();
+    const float* accelerationX = m_accelerationX.data();
+    const float* accelerationY = m_accelerationY.data();
+    const float* ignorePhysicsAfter = m_ignorePhysicsAfter.data();
+    float* elapsed = m_elapsed.data();
 
-        if (m_position != position) {
-            m_position += delta;
-        }
+    // branchless, so the compiler can run it over several particles at once
+    for (size_t i = 0; i < count; ++i) {
+        const bool physics = ignorePhysicsAfter[i] < 0 || elapsed[i] < ignorePhysicsAfter[i];
+        const float step = physics ? elapsedTime : 0.f;
 
-        // update acceleration
-        m_velocity += m_acceleration * elapsedTime;
+        positionX[i] += velocityX[i] * step;
+        positionY[i] -= velocityY[i] * step; // painter orientate Y axis in the inverse direction
+        velocityX[i] += accelerationX[i] * step;
+        velocityY[i] += accelerationY[i] * step;
+        elapsed[i] += elapsedTime;
     }
-
-    m_rect.move(static_cast<int>(m_position.x) - m_size.width() / 2, static_cast<int>(m_position.y) - m_size.height() / 2);
 }
 
-void Particle::updateSize()
+void ParticleStore::render() const
 {
-    m_size = m_startSize + (m_finalSize - m_startSize) / m_duration * m_elapsedTime;
-    m_rect.resize(m_size);
-}
+    for (size_t i = 0, count = size(); i < count; ++i) {
+        const auto& type = m_types[m_type[i]];
+        const float life = m_duration[i] > 0 ? std::clamp(m_elapsed[i] / m_duration[i], 0.f, 1.f) : 0.f;
 
-void Particle::updateColor()
-{
-    const float currentLife = m_elapsedTime / m_duration;
-    if (currentLife < m_colorsStops[1]) {
-        const float range = m_colorsStops[1] - m_colorsStops[0];
-        const float factor = (currentLife - m_colorsStops[0]) / range;
-        m_color = m_colors[0] * (1.0f - factor) + m_colors[1] * factor;
-    } else if (m_colors.size() > 1) {
-        m_colors.erase(m_colors.begin());
-        m_colorsStops.erase(m_colorsStops.begin());
-    } else if (m_color != m_colors[0]) {
-        m_color = m_colors[0];
+        const int width = static_cast<int>(m_startWidth[i] + (m_finalWidth[i] - m_startWidth[i]) * life);
+        const int height = static_cast<int>(m_startHeight[i] + (m_finalHeight[i] - m_startHeight[i]) * life);
+        const Rect rect(static_cast<int>(m_positionX[i]) - width / 2, static_cast<int>(m_positionY[i]) - height / 2, width, height);
+        const Color& color = type->getColor(life);
+
+        if (!type->pTexture) {
+            g_drawPool.addFilledRect(rect, color);
+            continue;
+        }
+
+        g_drawPool.setCompositionMode(type->pCompositionMode, true);
+        if (type->pAnimatedTexture) {
+            const auto& frame = type->pAnimatedTexture->getCurrentFrame();
+            if (frame)
+                g_drawPool.addTexturedRect(rect, frame, color);
+            continue;
+        }
+        g_drawPool.addTexturedRect(rect, type->pTexture, color);
     }
-}
\ No newline at end of file
+}
@@ -24,63 +24,66 @@
 
 #include "declarations.h"
 #include "painter.h"
-#include <framework/core/timer.h>
 
-class Particle
+#include <span>
+
+// The particles of a system, one array per attribute, so a step is a few loops over contiguous floats
+// instead of a call per particle.
+class ParticleStore
 {
 public:
-    Particle(const Point& pos, const Size& startSize, const Size& finalSize, const PointF& velocity,
-                       const PointF& acceleration, const float duration, const float ignorePhysicsAfter, const std::vector<Color>& colors,
-                       const std::vector<float>& colorsStops, const CompositionMode compositionMode, TexturePtr texture,
-                       AnimatedTexturePtr animatedTexture) :
-        m_colors(colors), m_colorsStops(colorsStops), m_texture(std::move(texture)), m_animatedTexture(std::move(
-        animatedTexture)), m_position(PointF(pos.x, pos.y)),
-        m_velocity(velocity), m_acceleration(acceleration), m_startSize(startSize), m_finalSize(finalSize),
-        m_duration(duration), m_ignorePhysicsAfter(ignorePhysicsAfter), m_compositionMode(compositionMode)
-    {
-    }
+    void add(const ParticleTypePtr& type, const PointF& position, const PointF& velocity, const PointF& acceleration,
+             float duration, const Size& startSize, const Size& finalSize);
 
-    void render() const;
+    // drops the particles past their duration, the others keep their drawing order
+    void removeFinished();
     void update(float elapsedTime);
+    void render() const;
 
-    bool hasFinished() const { return m_finished; }
-
-    PointF getPosition() { return m_position; }
-    PointF getVelocity() { return m_velocity; }
+    size_t size() const { return m_elapsed.size(); }
+    bool empty() const { return m_elapsed.empty(); }
 
-    void setPosition(const PointF& position) { m_position = position; }
-    void setVelocity(const PointF& velocity) { m_velocity = velocity; }
+    // the attributes the affectors change
+    std::span<const float> getPositionsX() const { return m_positionX; }
+    std::span<const float> getPositionsY() const { return m_positionY; }
+    std::span<float> getVelocitiesX() { return m_velocityX; }
+    std::span<float> getVelocitiesY() { return m_velocityY; }
 
 private:
-    void updateColor();
-    void updatePosition(float elapsedTime);
-    void updateSize();
-
-    std::vector<Color> m_colors;
-    std::vector<float> m_colorsStops;
-
-    TexturePtr m_texture;
-    AnimatedTexturePtr m_animatedTexture;
-
-    PointF m_position;
-    PointF m_velocity;
-    PointF m_acceleration;
-
-    Rect m_rect;
-
-    Color m_color;
-
-    Size m_size;
-    Size m_startSize;
-    Size m_finalSize;
-
-    Timer m_animationTimer;
-
-    float m_duration;
-    float m_ignorePhysicsAfter;
-    float m_elapsedTime{ 0 };
-
-    CompositionMode m_compositionMode;
+    template<typename Function>
+    void forEachAttribute(Function f)
+    {
+        f(m_type);
+        f(m_positionX);
+        f(m_positionY);
+        f(m_velocityX);
+        f(m_velocityY);
+        f(m_accelerationX);
+        f(m_accelerationY);
+        f(m_startWidth);
+        f(m_startHeight);
+        f(m_finalWidth);
+        f(m_finalHeight);
+        f(m_duration);
+        f(m_ignorePhysicsAfter);
+        f(m_elapsed);
+    }
 
-    bool m_finished{ false };
+    // the types of the particles, indexed by m_type
+    std::vector<ParticleTypePtr> m_types;
+
+    std::vector<uint8_t> m_type;
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_velocityX;
+    std::vector<float> m_velocityY;
+    std::vector<float> m_accelerationX;
+    std::vector<float> m_accelerationY;
+    std::vector<float> m_startWidth;
+    std::vector<float> m_startHeight;
+    std::vector<float> m_finalWidth;
+    std::vector<float> m_finalHeight;
+    std::vector<float> m_duration;
+    std::vector<float> m_ignorePhysicsAfter;
+    std::vector<float> m_elapsed;
 };
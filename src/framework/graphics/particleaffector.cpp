@@ -77,14 +77,17 @@ void GravityAffector::load(const OTMLNodePtr& node)
     }
 }
 
-void GravityAffector::updateParticle(const ParticlePtr& particle, const float elapsedTime) const
+void GravityAffector::updateParticles(ParticleStore& particles, const float elapsedTime) const
 {
     if (!m_active)
         return;
 
-    PointF velocity = particle->getVelocity();
-    velocity += PointF(m_gravity * elapsedTime * std::cos(m_angle), m_gravity * elapsedTime * std::sin(m_angle));
-    particle->setVelocity(velocity);
+    const float x = m_gravity * elapsedTime * std::cos(m_angle);
+    const float y = m_gravity * elapsedTime * std::sin(m_angle);
+    for (float& velocity : particles.getVelocitiesX())
+        velocity += x;
+    for (float& velocity : particles.getVelocitiesY())
+        velocity += y;
 }
 
 void AttractionAffector::load(const OTMLNodePtr& node)
@@ -107,17 +110,28 @@ void AttractionAffector::load(const OTMLNodePtr& node)
     }
 }
 
-void AttractionAffector::updateParticle(const ParticlePtr& particle, const float elapsedTime) const
+void AttractionAffector::updateParticles(ParticleStore& particles, const float elapsedTime) const
 {
     if (!m_active)
         return;
 
-    const auto& pPosition = particle->getPosition();
-    const auto& d = PointF(m_position.x - pPosition.x, pPosition.y - m_position.y);
-    if (d.length() == 0)
-        return;
+    const auto positionsX = particles.getPositionsX();
+    const auto positionsY = particles.getPositionsY();
+    const auto velocitiesX = particles.getVelocitiesX();
+    const auto velocitiesY = particles.getVelocitiesY();
+
+    const float direction = m_repelish ? -1.f : 1.f;
+    const float acceleration = m_acceleration * elapsedTime * direction;
+    const float reduction = 1.f - m_reduction / 100.f * elapsedTime;
+
+    for (size_t i = 0; i < positionsX.size(); ++i) {
+        const float dx = m_position.x - positionsX[i];
+        const float dy = positionsY[i] - m_position.y;
+        const float length = std::sqrt(dx * dx + dy * dy);
+        if (length == 0)
+            continue;
 
-    const auto& direction = m_repelish ? PointF(-1, -1) : PointF(1, 1);
-    const auto& pVelocity = particle->getVelocity() + (d / d.length() * m_acceleration * elapsedTime) * direction;
-    particle->setVelocity(pVelocity - pVelocity * m_reduction / 100.f * elapsedTime);
-}
\ No newline at end of file
+        velocitiesX[i] = (velocitiesX[i] + dx / length * acceleration) * reduction;
+        velocitiesY[i] = (velocitiesY[i] + dy / length * acceleration) * reduction;
+    }
+}
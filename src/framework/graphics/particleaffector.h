@@ -32,7 +32,8 @@ public:
 
     void update(float elapsedTime);
     virtual void load(const OTMLNodePtr& node);
-    virtual void updateParticle(const ParticlePtr&, float) const = 0;
+    // runs over every particle of the system at once
+    virtual void updateParticles(ParticleStore& particles, float elapsedTime) const = 0;
 
     bool hasFinished() const { return m_finished; }
 
@@ -48,7 +49,7 @@ class GravityAffector final : public ParticleAffector
 {
 public:
     void load(const OTMLNodePtr& node) override;
-    void updateParticle(const ParticlePtr& particle, float elapsedTime) const override;
+    void updateParticles(ParticleStore& particles, float elapsedTime) const override;
 
 private:
     float m_angle{ 0 };
@@ -59,7 +60,7 @@ class AttractionAffector final : public ParticleAffector
 {
 public:
     void load(const OTMLNodePtr& node) override;
-    void updateParticle(const ParticlePtr& particle, float elapsedTime) const override;
+    void updateParticles(ParticleStore& particles, float elapsedTime) const override;
 
 private:
     Point m_position;
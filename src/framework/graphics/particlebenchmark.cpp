@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "particlebenchmark.h"
+#include "particleeffect.h"
+#include "particlemanager.h"
+
+bool ParticleBenchmark::run(const std::string_view effectName, const int steps)
+{
+    const auto& effect = g_particles.createEffect(effectName);
+    if (!effect) {
+        g_logger.error("Particle benchmark: effect '{}' not found.", effectName);
+        return false;
+    }
+
+    // the rate ParticleSystem::update steps at
+    static constexpr float delay = 0.0166;
+
+    size_t particleSteps = 0;
+    size_t maxParticles = 0;
+    ticks_t elapsed = 0;
+    int step = 0;
+    for (; step < steps && !effect->hasFinished(); ++step) {
+        const ticks_t start = stdext::micros();
+        effect->step(delay);
+        elapsed += stdext::micros() - start;
+
+        const size_t particles = effect->getParticleCount();
+        particleSteps += particles;
+        maxParticles = std::max(maxParticles, particles);
+    }
+
+    std::cout << fmt::format("{} steps of '{}' in {:.3f} ms, up to {} particles\n", step, effectName, elapsed / 1000.0, maxParticles);
+    std::cout << fmt::format("{:.2f} us/step, {:.2f} ns/particle\n", static_cast<double>(elapsed) / std::max(step, 1),
+                             elapsed * 1000.0 / std::max<size_t>(particleSteps, 1));
+    return true;
+}
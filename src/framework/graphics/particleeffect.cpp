@@ -69,4 +69,18 @@ void ParticleEffect::update()
             ++it;
         }
     }
-}
\ No newline at end of file
+}
+
+void ParticleEffect::step(const float elapsedTime)
+{
+    for (const auto& system : m_systems)
+        system->step(elapsedTime);
+}
+
+size_t ParticleEffect::getParticleCount() const
+{
+    size_t count = 0;
+    for (const auto& system : m_systems)
+        count += system->getParticleCount();
+    return count;
+}
@@ -50,6 +50,9 @@ public:
     bool hasFinished() const { return m_systems.empty(); }
     void render() const;
     void update();
+    void step(float elapsedTime);
+
+    size_t getParticleCount() const;
 
     const ParticleEffectTypePtr& getEffectType() { return m_effectType; }
 
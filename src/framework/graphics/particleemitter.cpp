@@ -23,7 +23,6 @@
 #include "particleemitter.h"
 #include "particle.h"
 #include "particlemanager.h"
-#include "particlesystem.h"
 
 void ParticleEmitter::load(const OTMLNodePtr& node)
 {
@@ -47,7 +46,7 @@ void ParticleEmitter::load(const OTMLNodePtr& node)
         throw Exception("emitter didn't provide a valid particle type");
 }
 
-void ParticleEmitter::update(const float elapsedTime, const ParticleSystemPtr& system)
+void ParticleEmitter::update(const float elapsedTime, ParticleStore& particles)
 {
     m_elapsedTime += elapsedTime;
 
@@ -89,11 +88,7 @@ void ParticleEmitter::update(const float elapsedTime, const ParticleSystemPtr& s
             Size startSize = type->pStartSize * multiplier;
             Size finalSize = type->pFinalSize * multiplier;
 
-            system->addParticle(std::make_shared<Particle>(pPosition, startSize, finalSize,
-                                pVelocity, pAcceleration,
-                                pDuration, type->pIgnorePhysicsAfter,
-                                type->pColors, type->pColorsStops,
-                                type->pCompositionMode, type->pTexture, type->pAnimatedTexture));
+            particles.add(m_particleType, PointF(pPosition.x, pPosition.y), pVelocity, pAcceleration, pDuration, startSize, finalSize);
         }
     }
 
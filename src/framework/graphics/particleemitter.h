@@ -32,7 +32,7 @@ public:
 
     void load(const OTMLNodePtr& node);
 
-    void update(float elapsedTime, const ParticleSystemPtr& system);
+    void update(float elapsedTime, ParticleStore& particles);
 
     bool hasFinished() const { return m_finished; }
 
@@ -51,13 +51,7 @@ void ParticleSystem::load(const OTMLNodePtr& node)
     }
 }
 
-void ParticleSystem::addParticle(const ParticlePtr& particle) { m_particles.emplace_back(particle); }
-
-void ParticleSystem::render() const
-{
-    for (const auto& particle : m_particles)
-        particle->render();
-}
+void ParticleSystem::render() const { m_particles.render(); }
 
 void ParticleSystem::update()
 {
@@ -76,45 +70,39 @@ void ParticleSystem::update()
 
     m_lastUpdateTime = g_clock.seconds() - std::fmod(elapsedTime, delay);
 
-    const auto& self = shared_from_this();
-    for (int i = 0; i < std::floor(elapsedTime / delay); ++i) {
-        // update emitters
-        for (auto it = m_emitters.begin(); it != m_emitters.end();) {
-            const ParticleEmitterPtr& emitter = *it;
-            if (emitter->hasFinished()) {
-                it = m_emitters.erase(it);
-            } else {
-                emitter->update(delay, self);
-                ++it;
-            }
-        }
+    for (int i = 0; i < std::floor(elapsedTime / delay); ++i)
+        step(delay);
 
-        // update affectors
-        for (auto it = m_affectors.begin(); it != m_affectors.end();) {
-            const ParticleAffectorPtr& affector = *it;
-            if (affector->hasFinished()) {
-                it = m_affectors.erase(it);
-            } else {
-                affector->update(delay);
-                ++it;
-            }
-        }
+    g_drawPool.repaint(DrawPoolType::FOREGROUND);
+}
 
-        // update particles
-        for (auto it = m_particles.begin(); it != m_particles.end();) {
-            const ParticlePtr& particle = *it;
-            if (particle->hasFinished()) {
-                it = m_particles.erase(it);
-            } else {
-                // pass particles through affectors
-                for (const auto& particleAffector : m_affectors)
-                    particleAffector->updateParticle(particle, delay);
+void ParticleSystem::step(const float elapsedTime)
+{
+    // update emitters
+    for (auto it = m_emitters.begin(); it != m_emitters.end();) {
+        const ParticleEmitterPtr& emitter = *it;
+        if (emitter->hasFinished()) {
+            it = m_emitters.erase(it);
+        } else {
+            emitter->update(elapsedTime, m_particles);
+            ++it;
+        }
+    }
 
-                particle->update(delay);
-                ++it;
-            }
+    // update affectors
+    for (auto it = m_affectors.begin(); it != m_affectors.end();) {
+        const ParticleAffectorPtr& affector = *it;
+        if (affector->hasFinished()) {
+            it = m_affectors.erase(it);
+        } else {
+            affector->update(elapsedTime);
+            ++it;
         }
     }
 
-    g_drawPool.repaint(DrawPoolType::FOREGROUND);
-}
\ No newline at end of file
+    // update particles
+    m_particles.removeFinished();
+    for (const auto& affector : m_affectors)
+        affector->updateParticles(m_particles, elapsedTime);
+    m_particles.update(elapsedTime);
+}
@@ -23,26 +23,29 @@
 #pragma once
 
 #include "declarations.h"
+#include "particle.h"
 #include "particleemitter.h"
 
-class ParticleSystem : public std::enable_shared_from_this<ParticleSystem>
+class ParticleSystem
 {
 public:
     ParticleSystem();
 
     void load(const OTMLNodePtr& node);
 
-    void addParticle(const ParticlePtr& particle);
-
     void render() const;
     void update();
+    // a single step of the simulation, without looking at the clock
+    void step(float elapsedTime);
+
+    size_t getParticleCount() const { return m_particles.size(); }
 
     bool hasFinished() const { return m_finished; }
 
 private:
     bool m_finished{ false };
     float m_lastUpdateTime;
-    std::list<ParticlePtr> m_particles;
+    ParticleStore m_particles;
     std::list<ParticleEmitterPtr> m_emitters;
     std::list<ParticleAffectorPtr> m_affectors;
 };
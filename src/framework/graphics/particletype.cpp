@@ -128,6 +128,23 @@ void ParticleType::load(const OTMLNodePtr& node)
     if (pColors.size() != pColorsStops.size())
         throw Exception("particle colors must be equal to colorstops-1");
 
+    for (size_t i = 0; i < pColorGradient.size(); ++i) {
+        const float life = static_cast<float>(i) / (pColorGradient.size() - 1);
+
+        // the last stop the particle has reached, interpolated towards the next one
+        size_t stop = 0;
+        while (stop + 1 < pColorsStops.size() && pColorsStops[stop + 1] <= life)
+            ++stop;
+
+        if (stop + 1 == pColorsStops.size() || life < pColorsStops[stop]) {
+            pColorGradient[i] = pColors[stop];
+            continue;
+        }
+
+        const float factor = (life - pColorsStops[stop]) / (pColorsStops[stop + 1] - pColorsStops[stop]);
+        pColorGradient[i] = pColors[stop] * (1.0f - factor) + pColors[stop + 1] * factor;
+    }
+
     if (pTexture) {
         pTexture->create();
         pTexture->setSmooth(true);
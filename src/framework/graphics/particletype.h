@@ -33,6 +33,9 @@ public:
     void load(const OTMLNodePtr& node);
     std::string getName() const { return pName; }
 
+    // color at life in [0, 1]
+    const Color& getColor(const float life) const { return pColorGradient[static_cast<size_t>(life * (pColorGradient.size() - 1) + 0.5f)]; }
+
 protected:
 
     // name
@@ -41,6 +44,8 @@ protected:
     // visual ralated
     std::vector<Color> pColors;
     std::vector<float> pColorsStops;
+    // the colors sampled over the life of a particle, shared by every particle of this type
+    std::array<Color, 256> pColorGradient;
     TexturePtr pTexture;
     AnimatedTexturePtr pAnimatedTexture;
     ParticleTypePtr particleType;
@@ -76,4 +81,5 @@ protected:
     float pIgnorePhysicsAfter{ -1 };
 
     friend class ParticleEmitter;
+    friend class ParticleStore;
 };
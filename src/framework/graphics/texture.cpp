@@ -169,8 +169,8 @@ bool Texture::setupSize(const Size& size)
     if (m_size == size)
         return true;
 
-    // checks texture max size
-    if (std::max<int>(size.width(), size.height()) > g_graphics.getMaxTextureSize()) {
+    // checks texture max size, there is none to check without a graphics context (null render backend)
+    if (g_graphics.ok() && std::max<int>(size.width(), size.height()) > g_graphics.getMaxTextureSize()) {
         g_logger.error(
             "loading texture with size {}x{} failed, "
             "the maximum size allowed by the graphics card is {}x{}, "
@@ -60,6 +60,8 @@ public:
     bool hasRepeat() const { return getProp(repeat); }
     bool hasMipmaps() const { return getProp(hasMipMaps); }
     virtual bool isAnimatedTexture() const { return false; }
+    // pixels waiting for create() even though the texture already exists
+    virtual bool hasPendingUpdate() const { return false; }
     bool setupSize(const Size& size);
 
 protected:
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "textureatlas.h"
+#include "graphics.h"
+#include "image.h"
+
+TextureAtlas g_textureAtlas;
+
+AtlasPage::AtlasPage(const Size& size, const int padding, const int alignment) : m_packer(size, padding, alignment)
+{
+#ifndef OPENGL_ES
+    // OpenGL ES 2 can't cap the mip levels, and the levels past TextureAtlas::MIP_LEVELS mix neighbours
+    setProp(Prop::buildMipmaps, true);
+#endif
+    setupSize(size);
+}
+
+void AtlasPage::queueUpload(const Rect& rect, const ImagePtr& image)
+{
+    std::scoped_lock l(m_uploadsMutex);
+    m_uploads.emplace_back(rect, image);
+    m_pending.store(true, std::memory_order_release);
+}
+
+void AtlasPage::create()
+{
+    if (m_id == 0) {
+        createTexture();
+        bind();
+
+        // padding must be transparent
+        const std::vector<uint8_t> blank(static_cast<size_t>(m_size.area()) * 4, 0);
+        setupPixels(0, m_size, blank.data());
+        setupWrap();
+        setupFilters();
+#ifndef OPENGL_ES
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, TextureAtlas::MIP_LEVELS);
+#endif
+    }
+
+    if (!m_pending.load(std::memory_order_acquire))
+        return;
+
+    std::vector<std::pair<Rect, ImagePtr>> uploads;
+    {
+        std::scoped_lock l(m_uploadsMutex);
+        uploads.swap(m_uploads);
+        m_pending.store(false, std::memory_order_release);
+    }
+
+    bind();
+    std::vector<uint8_t> blank;
+    for (const auto& [rect, image] : uploads) {
+        const uint8_t* pixels = image ? image->getPixelData() : nullptr;
+        if (!pixels) {
+            blank.resize(static_cast<size_t>(rect.size().area()) * 4, 0);
+            pixels = blank.data();
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x(), rect.y(), rect.width(), rect.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+
+    if (getProp(Prop::buildMipmaps)) {
+        if (hasMipmaps())
+            glGenerateMipmap(GL_TEXTURE_2D);
+        else
+            buildHardwareMipmaps();
+    }
+}
+
+AtlasRegion TextureAtlas::add(const ImagePtr& image)
+{
+    if (!m_enabled || !image || image->getBpp() != 4)
+        return {};
+
+    const int maxTextureSize = g_graphics.getMaxTextureSize();
+    const int pageSize = maxTextureSize > 0 ? std::min<int>(PAGE_SIZE, maxTextureSize) : PAGE_SIZE;
+    if (image->getWidth() > pageSize / 2 || image->getHeight() > pageSize / 2)
+        return {};
+
+    std::scoped_lock l(m_mutex);
+
+    AtlasRegion region;
+    for (const auto& page : m_pages) {
+        if (page->m_packer.pack(image->getSize(), region.rect)) {
+            region.page = page;
+            break;
+        }
+    }
+
+    if (!region.page) {
+        const auto& page = m_pages.emplace_back(std::make_shared<AtlasPage>(Size(pageSize), PADDING, ALIGNMENT));
+        if (!page->m_packer.pack(image->getSize(), region.rect))
+            return {};
+
+        region.page = page;
+    }
+
+    region.page->queueUpload(region.rect, image);
+    return region;
+}
+
+void TextureAtlas::release(AtlasRegion& region)
+{
+    if (!region)
+        return;
+
+    std::scoped_lock l(m_mutex);
+
+    region.page->m_packer.release(region.rect);
+    if (region.page->m_packer.isEmpty())
+        std::erase(m_pages, region.page);
+    else
+        region.page->queueUpload(region.rect, nullptr);
+
+    region = {};
+}
+
+void TextureAtlas::clear()
+{
+    std::scoped_lock l(m_mutex);
+    m_pages.clear();
+}
+
+size_t TextureAtlas::getPageCount()
+{
+    std::scoped_lock l(m_mutex);
+    return m_pages.size();
+}
+
+int TextureAtlas::getAllocations()
+{
+    std::scoped_lock l(m_mutex);
+
+    int allocations = 0;
+    for (const auto& page : m_pages)
+        allocations += page->m_packer.getAllocations();
+    return allocations;
+}
+
+size_t TextureAtlas::getUsedArea()
+{
+    std::scoped_lock l(m_mutex);
+
+    size_t area = 0;
+    for (const auto& page : m_pages)
+        area += page->m_packer.getUsedArea();
+    return area;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "atlaspacker.h"
+#include "texture.h"
+
+// Texture shared by many small images, pixels are queued from any thread and
+// uploaded by the graphics thread the next time the page is used.
+class AtlasPage final : public Texture
+{
+public:
+    AtlasPage(const Size& size, int padding, int alignment);
+
+    void create() override;
+    bool hasPendingUpdate() const override { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    // without an image the rect is cleared, so a rect taking its place later keeps a transparent gutter
+    void queueUpload(const Rect& rect, const ImagePtr& image);
+
+    AtlasPacker m_packer;
+
+    std::mutex m_uploadsMutex;
+    std::vector<std::pair<Rect, ImagePtr>> m_uploads;
+    std::atomic_bool m_pending{ false };
+
+    friend class TextureAtlas;
+};
+
+using AtlasPagePtr = std::shared_ptr<AtlasPage>;
+
+struct AtlasRegion
+{
+    AtlasPagePtr page;
+    Rect rect;
+
+    explicit operator bool() const { return page != nullptr; }
+};
+
+class TextureAtlas
+{
+public:
+    // frames start on 4px blocks with at least one empty block after them, so linear filtering never reads
+    // a neighbour down to mip level 2, where a block is one texel; the page has no levels past that
+    static constexpr int PADDING = 4;
+    static constexpr int ALIGNMENT = 4;
+    static constexpr int MIP_LEVELS = 2;
+
+    // images bigger than half a page keep their own texture
+    AtlasRegion add(const ImagePtr& image);
+    void release(AtlasRegion& region);
+    void clear();
+
+    void setEnabled(const bool v) { m_enabled = v; }
+    bool isEnabled() const { return m_enabled; }
+
+    size_t getPageCount();
+    int getAllocations();
+    size_t getUsedArea();
+
+private:
+    static constexpr int PAGE_SIZE = 2048;
+
+    std::mutex m_mutex;
+    std::vector<AtlasPagePtr> m_pages;
+    std::atomic_bool m_enabled{ true };
+};
+
+extern TextureAtlas g_textureAtlas;
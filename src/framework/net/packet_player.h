@@ -36,6 +36,8 @@ public:
 
     void onOutputPacket(const OutputMessagePtr& packet);
 
+    const auto& getInputPackets() const { return m_input; }
+
 private:
     void process();
 
@@ -27,6 +27,7 @@
 
 #include "inputmessage.h"
 #include "outputmessage.h"
+#include "xtea.h"
 #include "framework/core/graphicalapplication.h"
 #ifdef __EMSCRIPTEN__
 #include "webconnection.h"
@@ -264,31 +265,7 @@ void Protocol::generateXteaKey()
     std::random_device rd;
     std::uniform_int_distribution<uint32_t > unif;
     std::ranges::generate(m_xteaKey, [&unif, &rd] { return unif(rd); });
-}
-
-namespace
-{
-    constexpr uint32_t delta = 0x9E3779B9;
-
-    template<typename Round>
-    void apply_rounds(uint8_t* data, const size_t length, Round round)
-    {
-        for (auto j = 0u; j < length; j += 8) {
-            uint32_t left = data[j + 0] | data[j + 1] << 8u | data[j + 2] << 16u | data[j + 3] << 24u,
-                right = data[j + 4] | data[j + 5] << 8u | data[j + 6] << 16u | data[j + 7] << 24u;
-
-            round(left, right);
-
-            data[j] = static_cast<uint8_t>(left);
-            data[j + 1] = static_cast<uint8_t>(left >> 8u);
-            data[j + 2] = static_cast<uint8_t>(left >> 16u);
-            data[j + 3] = static_cast<uint8_t>(left >> 24u);
-            data[j + 4] = static_cast<uint8_t>(right);
-            data[j + 5] = static_cast<uint8_t>(right >> 8u);
-            data[j + 6] = static_cast<uint8_t>(right >> 16u);
-            data[j + 7] = static_cast<uint8_t>(right >> 24u);
-        }
-    }
+    m_xteaRoundKeys = xtea::expandKey(m_xteaKey);
 }
 
 bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage) const
@@ -299,12 +276,7 @@ bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage) const
         return false;
     }
 
-    for (uint32_t i = 0, sum = delta << 5, next_sum = sum - delta; i < 32; ++i, sum = next_sum, next_sum -= delta) {
-        apply_rounds(inputMessage->getReadBuffer(), encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            right -= ((left << 4 ^ left >> 5) + left) ^ (sum + m_xteaKey[(sum >> 11) & 3]);
-            left -= ((right << 4 ^ right >> 5) + right) ^ (next_sum + m_xteaKey[next_sum & 3]);
-        });
-    }
+    xtea::decrypt(inputMessage->getReadBuffer(), encryptedSize, m_xteaRoundKeys);
 
     const uint16_t decryptedSize = inputMessage->getU16() + 2;
     const int sizeDelta = decryptedSize - encryptedSize;
@@ -329,12 +301,7 @@ void Protocol::xteaEncrypt(const OutputMessagePtr& outputMessage) const
         encryptedSize += n;
     }
 
-    for (uint32_t i = 0, sum = 0, next_sum = sum + delta; i < 32; ++i, sum = next_sum, next_sum += delta) {
-        apply_rounds(outputMessage->getDataBuffer() - 2, encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            left += ((right << 4 ^ right >> 5) + right) ^ (sum + m_xteaKey[sum & 3]);
-            right += ((left << 4 ^ left >> 5) + left) ^ (next_sum + m_xteaKey[(next_sum >> 11) & 3]);
-        });
-    }
+    xtea::encrypt(outputMessage->getDataBuffer() - 2, encryptedSize, m_xteaRoundKeys);
 }
 
 void Protocol::onConnect() { callLuaField("onConnect"); }
@@ -397,16 +364,21 @@ void Protocol::onPlayerPacket(const std::shared_ptr<std::vector<uint8_t>>& packe
     post(g_ioService, [&, packet] {
         if (m_disconnected)
             return;
-        m_inputMessage->reset();
-
-        m_inputMessage->setHeaderSize(0);
-        m_inputMessage->fillBuffer(packet->data(), packet->size());
-        m_inputMessage->setMessageSize(packet->size());
-        onRecv(m_inputMessage);
+        recvPacket(*packet);
     });
     #endif
 }
 
+void Protocol::recvPacket(const std::vector<uint8_t>& packet)
+{
+    m_inputMessage->reset();
+
+    m_inputMessage->setHeaderSize(0);
+    m_inputMessage->fillBuffer(packet.data(), packet.size());
+    m_inputMessage->setMessageSize(packet.size());
+    onRecv(m_inputMessage);
+}
+
 void Protocol::playRecord(PacketPlayerPtr player)
 {
     m_disconnected = false;
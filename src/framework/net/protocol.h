@@ -27,6 +27,7 @@
 #include "connection.h"
 #endif
 #include "declarations.h"
+#include "xtea.h"
 
 #include <framework/luaengine/luaobject.h>
 #include <framework/proxy/proxy.h>
@@ -64,7 +65,11 @@ public:
 #endif
 
     void generateXteaKey();
-    void setXteaKey(const uint32_t a, const uint32_t b, const uint32_t c, const uint32_t d) { m_xteaKey = { a, b, c, d }; }
+    void setXteaKey(const uint32_t a, const uint32_t b, const uint32_t c, const uint32_t d)
+    {
+        m_xteaKey = { a, b, c, d };
+        m_xteaRoundKeys = xtea::expandKey(m_xteaKey);
+    }
     std::vector<uint32_t > getXteaKey() { return { m_xteaKey.begin(), m_xteaKey.end() }; }
     void enableXteaEncryption() { m_xteaEncryptionEnabled = true; }
 
@@ -84,11 +89,13 @@ protected:
 
     void onProxyPacket(const std::shared_ptr<std::vector<uint8_t>>& packet);
     void onPlayerPacket(const std::shared_ptr<std::vector<uint8_t>>& packet);
+    void recvPacket(const std::vector<uint8_t>& packet);
     void onLocalDisconnected(std::error_code ec);
     bool m_disconnected = false;
     uint32_t m_proxy = 0;
 
     std::array<uint32_t, 4> m_xteaKey{};
+    xtea::RoundKeys m_xteaRoundKeys{};
     uint32_t m_packetNumber{ 0 };
 
     PacketPlayerPtr m_player;
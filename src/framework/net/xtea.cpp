@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "xtea.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define XTEA_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+ // compiled for AVX2 regardless of the target flags, used only when the CPU has it
+#define XTEA_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace xtea
+{
+    namespace
+    {
+        constexpr uint32_t delta = 0x9E3779B9;
+        constexpr size_t blockSize = 8;
+
+        template<typename Round>
+        void applyRounds(uint8_t* data, const size_t blocks, Round round)
+        {
+            for (size_t j = 0, length = blocks * blockSize; j < length; j += blockSize) {
+                uint32_t left = data[j + 0] | data[j + 1] << 8u | data[j + 2] << 16u | data[j + 3] << 24u,
+                    right = data[j + 4] | data[j + 5] << 8u | data[j + 6] << 16u | data[j + 7] << 24u;
+
+                round(left, right);
+
+                data[j] = static_cast<uint8_t>(left);
+                data[j + 1] = static_cast<uint8_t>(left >> 8u);
+                data[j + 2] = static_cast<uint8_t>(left >> 16u);
+                data[j + 3] = static_cast<uint8_t>(left >> 24u);
+                data[j + 4] = static_cast<uint8_t>(right);
+                data[j + 5] = static_cast<uint8_t>(right >> 8u);
+                data[j + 6] = static_cast<uint8_t>(right >> 16u);
+                data[j + 7] = static_cast<uint8_t>(right >> 24u);
+            }
+        }
+
+        void encryptBlocks(uint8_t* data, const size_t blocks, const RoundKeys& k)
+        {
+            applyRounds(data, blocks, [&](uint32_t& left, uint32_t& right) {
+                for (size_t i = 0; i < k.size(); i += 2) {
+                    left += ((right << 4 ^ right >> 5) + right) ^ k[i];
+                    right += ((left << 4 ^ left >> 5) + left) ^ k[i + 1];
+                }
+            });
+        }
+
+        void decryptBlocks(uint8_t* data, const size_t blocks, const RoundKeys& k)
+        {
+            applyRounds(data, blocks, [&](uint32_t& left, uint32_t& right) {
+                for (size_t i = k.size(); i > 0; i -= 2) {
+                    right -= ((left << 4 ^ left >> 5) + left) ^ k[i - 1];
+                    left -= ((right << 4 ^ right >> 5) + right) ^ k[i - 2];
+                }
+            });
+        }
+
+#ifdef XTEA_SSE2
+        // 4 blocks at a time, the left and right halves of each block in separate lanes
+        inline __m128i mix(const __m128i v) { return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v); }
+
+        inline void loadSse2(const uint8_t* it, __m128i& left, __m128i& right)
+        {
+            const __m128 a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it)));
+            const __m128 b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it + 16)));
+            left = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            right = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        inline void storeSse2(uint8_t* it, const __m128i left, const __m128i right)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(it), _mm_unpacklo_epi32(left, right));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(it + 16), _mm_unpackhi_epi32(left, right));
+        }
+
+        size_t encryptSse2(uint8_t* data, const size_t blocks, const RoundKeys& k)
+        {
+            size_t done = 0;
+            for (; done + 4 <= blocks; done += 4) {
+                uint8_t* it = data + done * blockSize;
+                __m128i left, right;
+                loadSse2(it, left, right);
+
+                for (size_t i = 0; i < k.size(); i += 2) {
+                    left = _mm_add_epi32(left, _mm_xor_si128(mix(right), _mm_set1_epi32(k[i])));
+                    right = _mm_add_epi32(right, _mm_xor_si128(mix(left), _mm_set1_epi32(k[i + 1])));
+                }
+
+                storeSse2(it, left, right);
+            }
+            return done;
+        }
+
+        size_t decryptSse2(uint8_t* data, const size_t blocks, const RoundKeys& k)
+        {
+            size_t done = 0;
+            for (; done + 4 <= blocks; done += 4) {
+                uint8_t* it = data + done * blockSize;
+                __m128i left, right;
+                loadSse2(it, left, right);
+
+                for (size_t i = k.size(); i > 0; i -= 2) {
+                    right = _mm_sub_epi32(right, _mm_xor_si128(mix(left), _mm_set1_epi32(k[i - 1])));
+                    left = _mm_sub_epi32(left, _mm_xor_si128(mix(right), _mm_set1_epi32(k[i - 2])));
+                }
+
+                storeSse2(it, left, right);
+            }
+            return done;
+        }
+#endif
+
+#ifdef XTEA_AVX2
+        // 8 blocks at a time, the halves are split within each 128-bit lane and joined back the same way
+        __attribute__((target("avx2"))) inline __m256i mix(const __m256i v)
+        {
+            return _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v, 4), _mm256_srli_epi32(v, 5)), v);
+        }
+
+        __attribute__((target("avx2"))) inline void loadAvx2(const uint8_t* it, __m256i& left, __m256i& right)
+        {
+            const __m256 a = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(it)));
+            const __m256 b = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(it + 32)));
+            left = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            right = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        __attribute__((target("avx2"))) inline void storeAvx2(uint8_t* it, const __m256i left, const __m256i right)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(it), _mm256_unpacklo_epi32(left, right));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(it + 32), _mm256_unpackhi_epi32(left, right));
+        }
+
+        __attribute__((target("avx2"))) size_t encryptAvx2(uint8_t* data, const size_t blocks, const RoundKeys& k)
+        {
+            size_t done = 0;
+            for (; done + 8 <= blocks; done += 8) {
+                uint8_t* it = data + done * blockSize;
+                __m256i left, right;
+                loadAvx2(it, left, right);
+
+                for (size_t i = 0; i < k.size(); i += 2) {
+                    left = _mm256_add_epi32(left, _mm256_xor_si256(mix(right), _mm256_set1_epi32(k[i])));
+                    right = _mm256_add_epi32(right, _mm256_xor_si256(mix(left), _mm256_set1_epi32(k[i + 1])));
+                }
+
+                storeAvx2(it, left, right);
+            }
+            return done;
+        }
+
+        __attribute__((target("avx2"))) size_t decryptAvx2(uint8_t* data, const size_t blocks, const RoundKeys& k)
+        {
+            size_t done = 0;
+            for (; done + 8 <= blocks; done += 8) {
+                uint8_t* it = data + done * blockSize;
+                __m256i left, right;
+                loadAvx2(it, left, right);
+
+                for (size_t i = k.size(); i > 0; i -= 2) {
+                    right = _mm256_sub_epi32(right, _mm256_xor_si256(mix(left), _mm256_set1_epi32(k[i - 1])));
+                    left = _mm256_sub_epi32(left, _mm256_xor_si256(mix(right), _mm256_set1_epi32(k[i - 2])));
+                }
+
+                storeAvx2(it, left, right);
+            }
+            return done;
+        }
+
+        // checked during static initialization, which may run before the runtime fills in the CPU features itself
+        const bool hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+#endif
+    }
+
+    RoundKeys expandKey(const Key& key)
+    {
+        RoundKeys expanded;
+        for (uint32_t i = 0, sum = 0, next_sum = sum + delta; i < expanded.size(); i += 2, sum = next_sum, next_sum += delta) {
+            expanded[i] = sum + key[sum & 3];
+            expanded[i + 1] = next_sum + key[(next_sum >> 11) & 3];
+        }
+        return expanded;
+    }
+
+    void encrypt(uint8_t* data, const size_t length, const RoundKeys& k)
+    {
+        // blocks are independent, the widest implementation takes as many as it can and leaves the rest to the next
+        const size_t blocks = length / blockSize;
+        size_t done = 0;
+#ifdef XTEA_AVX2
+        if (hasAvx2)
+            done = encryptAvx2(data, blocks, k);
+#endif
+#ifdef XTEA_SSE2
+        done += encryptSse2(data + done * blockSize, blocks - done, k);
+#endif
+        encryptBlocks(data + done * blockSize, blocks - done, k);
+    }
+
+    void decrypt(uint8_t* data, const size_t length, const RoundKeys& k)
+    {
+        const size_t blocks = length / blockSize;
+        size_t done = 0;
+#ifdef XTEA_AVX2
+        if (hasAvx2)
+            done = decryptAvx2(data, blocks, k);
+#endif
+#ifdef XTEA_SSE2
+        done += decryptSse2(data + done * blockSize, blocks - done, k);
+#endif
+        decryptBlocks(data + done * blockSize, blocks - done, k);
+    }
+}
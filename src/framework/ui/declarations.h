@@ -39,8 +39,11 @@ class UIAnchorGroup;
 class UIAnchorLayout;
 class UIParticles;
 
+struct UIStateStyles;
+
 using UIWidgetPtr = std::shared_ptr<UIWidget>;
 using UIParticlesPtr = std::shared_ptr<UIParticles>;
+using UIStateStylesPtr = std::shared_ptr<UIStateStyles>;
 using UITextEditPtr = std::shared_ptr<UITextEdit>;
 using UILayoutPtr = std::shared_ptr<UILayout>;
 using UIBoxLayoutPtr = std::shared_ptr<UIBoxLayout>;
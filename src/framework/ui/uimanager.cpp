@@ -22,6 +22,7 @@
 
 #include "uimanager.h"
 #include "ui.h"
+#include "uitranslator.h"
 
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/modulemanager.h>
@@ -34,6 +35,17 @@
 
 UIManager g_ui;
 
+namespace
+{
+    void hashNode(size_t& hash, const OTMLNodePtr& node)
+    {
+        stdext::hash_combine(hash, node->tag());
+        stdext::hash_combine(hash, node->rawValue());
+        for (const auto& child : node->children())
+            hashNode(hash, child);
+    }
+}
+
 void UIManager::init()
 {
     // creates root widget
@@ -54,6 +66,7 @@ void UIManager::terminate()
     m_hoveredWidget = nullptr;
     m_pressedWidget = nullptr;
     m_styles.clear();
+    m_stateStyles.clear();
     m_destroyedWidgets.clear();
     m_checkEvent = nullptr;
 }
@@ -321,6 +334,7 @@ void UIManager::onWidgetDestroy(const UIWidgetPtr& widget)
 void UIManager::clearStyles()
 {
     m_styles.clear();
+    m_stateStyles.clear();
 }
 
 bool UIManager::importStyle(const std::string& fl, const bool checkDeviceStyles)
@@ -451,6 +465,66 @@ std::string UIManager::getStyleClass(const std::string_view styleName)
     return "";
 }
 
+UIStateStylesPtr UIManager::getStateStyles(const OTMLNodePtr& style)
+{
+    // the styles without state styles share an empty table, their widgets build nothing
+    static const auto noStateStyles = std::make_shared<UIStateStyles>();
+
+    // widgets clone their style, the ones of the same style share the table when their state styles are the same,
+    // and so are the values these change, which the built styles reset to
+    size_t hash = 0;
+    bool hasStateStyles = false;
+    for (const auto& node : style->children()) {
+        if (!node->tag().starts_with("$"))
+            continue;
+
+        hasStateStyles = true;
+        hashNode(hash, node);
+        for (const auto& child : node->children()) {
+            if (const auto& defaultNode = style->get(child->tag()))
+                hashNode(hash, defaultNode);
+            else
+                stdext::hash_combine(hash, child->tag());
+        }
+    }
+
+    if (!hasStateStyles)
+        return noStateStyles;
+
+    auto& stateStyles = m_stateStyles[style->tag()][hash];
+    if (stateStyles)
+        return stateStyles;
+
+    stateStyles = std::make_shared<UIStateStyles>();
+    for (const auto& node : style->children()) {
+        if (!node->tag().starts_with("$"))
+            continue;
+
+        auto& selector = stateStyles->selectors.emplace_back();
+        selector.style = node->clone();
+
+        for (std::string stateStr : stdext::split(node->tag().substr(1), " ")) {
+            if (stateStr.length() == 0)
+                continue;
+
+            const bool notstate = (stateStr[0] == '!');
+            if (notstate)
+                stateStr = stateStr.substr(1);
+
+            // a state that does not exist is never on
+            const auto state = Fw::translateState(stateStr);
+            if (state == Fw::InvalidState)
+                selector.never |= !notstate;
+            else if (notstate)
+                selector.off |= state;
+            else
+                selector.on |= state;
+        }
+    }
+
+    return stateStyles;
+}
+
 OTMLNodePtr UIManager::findMainWidgetNode(const OTMLDocumentPtr& doc)
 {
     OTMLNodePtr mainNode = nullptr;
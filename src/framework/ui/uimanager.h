@@ -49,6 +49,7 @@ public:
     OTMLNodePtr getStyle(std::string_view sn);
     std::string getStyleName(std::string_view styleName);
     std::string getStyleClass(std::string_view styleName);
+    UIStateStylesPtr getStateStyles(const OTMLNodePtr& style);
     OTMLNodePtr findMainWidgetNode(const OTMLDocumentPtr& doc);
 
     UIWidgetPtr loadUI(const std::string& file, const UIWidgetPtr& parent);
@@ -83,6 +84,7 @@ protected:
 
     friend class UIWidget;
     friend class GraphicalApplication;
+    friend class GarbageCollection;
 
 private:
     UIWidgetPtr m_rootWidget;
@@ -94,6 +96,8 @@ private:
     bool m_hoverUpdateScheduled{ false };
     bool m_drawDebugBoxes{ false };
     stdext::map<std::string, OTMLNodePtr> m_styles;
+    // by style name, then by a hash of its state styles and of the values they change
+    std::unordered_map<std::string, std::unordered_map<size_t, UIStateStylesPtr>> m_stateStyles;
     UIWidgetList m_destroyedWidgets;
     ScheduledEventPtr m_checkEvent;
 };
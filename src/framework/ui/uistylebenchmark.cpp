@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2010-2024 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "uistylebenchmark.h"
+#include "uimanager.h"
+#include "uiwidget.h"
+
+#include <framework/otml/otmldocument.h>
+
+namespace
+{
+    // a list row with the state styles the game lists use
+    constexpr std::string_view rowStyle = R"(BenchmarkRow < UIWidget
+  size: 150 20
+  color: #aaaaaa
+  background-color: alpha
+  opacity: 0.8
+  text-offset: 4 2
+
+  $hover:
+    color: #ffffff
+    background-color: #ffffff22
+
+  $checked:
+    color: #ffffff
+    background-color: #00000066
+    border: 1 #ffffff
+
+  $on:
+    icon-color: #ff0000
+
+  $hover checked:
+    background-color: #ffffff44
+
+  $!on:
+    icon-color: #ffffff
+
+  $disabled:
+    color: #666666
+    opacity: 0.5
+)";
+
+    constexpr int rows = 100;
+}
+
+bool UIStyleBenchmark::run(const int flips)
+{
+    try {
+        std::istringstream in{ std::string(rowStyle) };
+        g_ui.importStyleFromOTML(OTMLDocument::parse(in, "uistylebenchmark"));
+    } catch (stdext::exception& e) {
+        g_logger.error("UI style benchmark: unable to import the row style: {}", e.what());
+        return false;
+    }
+
+    std::vector<UIWidgetPtr> widgets;
+    for (int i = 0; i < rows; ++i) {
+        const auto& widget = g_ui.createWidget("BenchmarkRow", nullptr);
+        if (!widget)
+            return false;
+        widgets.emplace_back(widget);
+    }
+
+    // the rows of one style share their state styles
+    const auto countBuilt = [&widgets] {
+        std::set<UIStateStyles*> tables;
+        size_t built = 0;
+        for (const auto& widget : widgets) {
+            if (widget->m_stateStyles && tables.emplace(widget->m_stateStyles.get()).second)
+                built += widget->m_stateStyles->built.size();
+        }
+        return std::make_pair(tables.size(), built);
+    };
+    const size_t builtBefore = countBuilt().second;
+
+    // every flip changes one state of one row, the way the mouse moves down a list
+    const ticks_t start = stdext::micros();
+    for (int flip = 0; flip < flips; ++flip) {
+        const auto& widget = widgets[flip % rows];
+        switch ((flip / rows) % 3) {
+            case 0: widget->setChecked(!widget->isChecked()); break;
+            case 1: widget->setOn(!widget->isOn()); break;
+            default: widget->setEnabled(!widget->isExplicitlyEnabled()); break;
+        }
+    }
+    const ticks_t elapsed = stdext::micros() - start;
+
+    const auto [tables, builtAfter] = countBuilt();
+    const size_t built = builtAfter >= builtBefore ? builtAfter - builtBefore : builtAfter;
+
+    for (const auto& widget : widgets)
+        widget->destroy();
+
+    std::cout << fmt::format("{} state flips over {} widgets in {:.3f} ms\n", flips, rows, elapsed / 1000.0);
+    std::cout << fmt::format("{:.2f} us/flip\n", static_cast<double>(elapsed) / std::max(flips, 1));
+    std::cout << fmt::format("{} state styles built, {} flips found a built one, {} style table(s)\n", built, flips - std::min<size_t>(built, flips), tables);
+    return true;
+}
@@ -633,6 +633,7 @@ void UIWidget::mergeStyle(const OTMLNodePtr& styleNode)
     m_style->merge(styleNode);
     m_style->setTag(name);
     m_style->setSource(source);
+    m_stateStyles = nullptr;
     updateStyle();
 }
 
@@ -1103,6 +1104,7 @@ void UIWidget::setStyle(const std::string_view styleName)
     styleNode = styleNode->clone();
     applyStyle(styleNode);
     m_style = styleNode;
+    m_stateStyles = nullptr;
     updateStyle();
 }
 
@@ -1110,6 +1112,7 @@ void UIWidget::setStyleFromNode(const OTMLNodePtr& styleNode)
 {
     applyStyle(styleNode);
     m_style = styleNode;
+    m_stateStyles = nullptr;
     updateStyle();
 }
 
@@ -1667,47 +1670,94 @@ void UIWidget::updateStyle()
     if (!m_style)
         return;
 
-    const auto& newStateStyle = OTMLNode::create();
+    if (!m_stateStyles)
+        compileStateStyles();
 
-    // copy only the changed styles from default style
-    if (m_stateStyle) {
-        for (const auto& node : m_stateStyle->children()) {
-            if (const auto& otherNode = m_style->get(node->tag()))
-                newStateStyle->addChild(otherNode->clone());
-        }
+    auto& stateStyles = *m_stateStyles;
+
+    // a style without state styles only resets what the previous state style changed
+    if (stateStyles.selectors.empty()) {
+        if (m_stateStyle && m_stateStyle->size() > 0)
+            applyStyle(buildStateStyle(m_stateStyle));
+        m_stateStyle = nullptr;
+        m_stateStyleIndex = -1;
+        return;
     }
 
-    // checks for states combination
-    for (const auto& style : m_style->children()) {
-        if (style->tag().starts_with("$")) {
-            std::string statesStr = style->tag().substr(1);
-            std::vector<std::string> statesSplit = stdext::split(statesStr, " ");
+    // styles that go through many combinations start over, rather than keep every style
+    if (stateStyles.built.size() >= UIStateStyles::MAX_BUILT) {
+        stateStyles.built.clear();
+        stateStyles.builtResets.clear();
+        stateStyles.resets.clear();
+        stateStyles.builtIndex.clear();
+    }
 
-            bool match = true;
-            for (std::string stateStr : statesSplit) {
-                if (stateStr.length() == 0)
-                    continue;
+    // the tags the state style applied last resets, kept for the ones built since the table started over
+    uint32_t resets;
+    if (m_stateStyleIndex >= 0 && static_cast<size_t>(m_stateStyleIndex) < stateStyles.built.size() && stateStyles.built[m_stateStyleIndex] == m_stateStyle)
+        resets = stateStyles.builtResets[m_stateStyleIndex];
+    else
+        resets = getStateStyleResets(m_stateStyle);
 
-                const bool notstate = (stateStr[0] == '!');
-                if (notstate)
-                    stateStr = stateStr.substr(1);
+    const uint64_t key = static_cast<uint64_t>(resets) << 32 | static_cast<uint32_t>(m_states);
+    if (const auto it = stateStyles.builtIndex.find(key); it != stateStyles.builtIndex.end())
+        m_stateStyleIndex = it->second;
+    else {
+        m_stateStyleIndex = stateStyles.built.size();
+        const auto& builtStyle = stateStyles.built.emplace_back(buildStateStyle(m_stateStyle));
+        stateStyles.builtResets.emplace_back(getStateStyleResets(builtStyle));
+        stateStyles.builtIndex.emplace(key, m_stateStyleIndex);
+    }
 
-                const bool stateOn = hasState(Fw::translateState(stateStr));
-                if ((!notstate && !stateOn) || (notstate && stateOn))
-                    match = false;
-            }
+    const auto newStateStyle = stateStyles.built[m_stateStyleIndex];
 
-            // merge states styles
-            if (match) {
-                newStateStyle->merge(style);
+    //TODO: prevent setting already set proprieties
+
+    applyStyle(newStateStyle);
+    m_stateStyle = newStateStyle;
+}
+
+void UIWidget::compileStateStyles()
+{
+    m_stateStyles = g_ui.getStateStyles(m_style);
+    m_stateStyleIndex = -1;
+}
+
+uint32_t UIWidget::getStateStyleResets(const OTMLNodePtr& stateStyle) const
+{
+    std::string tags;
+    if (stateStyle) {
+        for (const auto& node : stateStyle->children()) {
+            if (m_style->get(node->tag())) {
+                tags += node->tag();
+                tags += '\n';
             }
         }
     }
 
-    //TODO: prevent setting already set proprieties
+    auto& resets = m_stateStyles->resets;
+    return resets.try_emplace(tags, static_cast<uint32_t>(resets.size())).first->second;
+}
 
-    applyStyle(newStateStyle);
-    m_stateStyle = newStateStyle;
+OTMLNodePtr UIWidget::buildStateStyle(const OTMLNodePtr& previousStateStyle) const
+{
+    const auto& newStateStyle = OTMLNode::create();
+
+    // copy only the changed styles from default style
+    if (previousStateStyle) {
+        for (const auto& node : previousStateStyle->children()) {
+            if (const auto& otherNode = m_style->get(node->tag()))
+                newStateStyle->addChild(otherNode->clone());
+        }
+    }
+
+    // merge the styles of the states combination
+    for (const auto& selector : m_stateStyles->selectors) {
+        if (!selector.never && (m_states & selector.on) == selector.on && (m_states & selector.off) == 0)
+            newStateStyle->merge(selector.style);
+    }
+
+    return newStateStyle;
 }
 
 void UIWidget::onStyleApply(const std::string_view, const OTMLNodePtr& styleNode)
@@ -45,6 +45,29 @@ struct EdgeGroup
     T left;
 };
 
+// the $state styles of a style with their states parsed once, and the styles already built from them,
+// shared by the widgets of the same style
+struct UIStateStyles
+{
+    static constexpr size_t MAX_BUILT = 64;
+
+    struct Selector
+    {
+        OTMLNodePtr style;
+        int32_t on{ Fw::DefaultState };
+        int32_t off{ Fw::DefaultState };
+        bool never{ false };
+    };
+
+    std::vector<Selector> selectors;
+
+    // a style is built from the tags the previous one resets to the default style and the states of the widget
+    std::vector<OTMLNodePtr> built;
+    std::vector<uint32_t> builtResets;
+    stdext::map<std::string, uint32_t> resets;
+    stdext::map<uint64_t, uint16_t> builtIndex;
+};
+
 enum FlagProp : uint32_t
 {
     PropTextWrap = 1 << 0,
@@ -252,8 +275,13 @@ private:
     void updateStates();
     void updateChildrenIndexStates();
     void updateStyle();
+    void compileStateStyles();
+    uint32_t getStateStyleResets(const OTMLNodePtr& stateStyle) const;
+    OTMLNodePtr buildStateStyle(const OTMLNodePtr& previousStateStyle) const;
 
     OTMLNodePtr m_stateStyle;
+    UIStateStylesPtr m_stateStyles;
+    int32_t m_stateStyleIndex{ -1 };
     int32_t m_states{ Fw::DefaultState };
 
     // event processing
@@ -281,6 +309,9 @@ protected:
     virtual bool onDoubleClick(const Point& mousePos);
 
     friend class UILayout;
+#ifdef CLIENT_CHECKS
+    friend class UIStyleBenchmark;
+#endif
 
     bool propagateOnKeyText(std::string_view keyText);
     bool propagateOnKeyDown(uint8_t keyCode, int keyboardModifiers);
@@ -141,14 +141,31 @@ void Game::saveGameState()
 
 	std::cout << "Saving server..." << std::endl;
 
+	int64_t start = OTSYS_TIME();
+	std::vector<PlayerSaveData> playerSaves;
+	playerSaves.reserve(players.size());
 	for (const auto& it : players) {
 		it.second->loginPosition = it.second->getPosition();
-		IOLoginData::savePlayer(it.second);
+		playerSaves.push_back(IOLoginData::getPlayerSaveData(it.second));
 	}
+	std::cout << "> Took the state of " << playerSaves.size() << " players in " << (OTSYS_TIME() - start) / 1000.
+	          << "s." << std::endl;
+
+	// the players are written by the database thread while the game goes on
+	g_databaseTasks.addTask(
+	    [playerSaves = std::move(playerSaves)](Database& db) {
+		    if (!IOLoginData::savePlayers(db, playerSaves)) {
+			    std::cout << "[Error - Game::saveGameState] Failed to save players." << std::endl;
+		    }
+	    },
+	    getDatabaseOrderKey(DATABASE_ORDER_SERVER_SAVE));
 
 	Map::save();
 
-	g_databaseTasks.flush();
+	// only wait for the database when the server is going down
+	if (gameState == GAME_STATE_SHUTDOWN || gameState == GAME_STATE_CLOSED) {
+		g_databaseTasks.flush();
+	}
 
 	if (gameState == GAME_STATE_MAINTAIN) {
 		setGameState(GAME_STATE_NORMAL);
@@ -539,6 +556,7 @@ bool Game::removeCreature(Creature* creature, bool isLogout /* = true*/)
 	}
 
 	tile->removeCreature(creature);
+	map.removeFlowField(creature->getID());
 
 	const Position& tilePosition = tile->getPosition();
 
@@ -5024,7 +5042,11 @@ BedItem* Game::getBedBySleeper(uint32_t guid) const
 	return it->second;
 }
 
-void Game::setBedSleeper(BedItem* bed, uint32_t guid) { bedSleepersMap[guid] = bed; }
+void Game::setBedSleeper(BedItem* bed, uint32_t guid)
+{
+	std::lock_guard<std::mutex> lockGuard(mapLoadLock);
+	bedSleepersMap[guid] = bed;
+}
 
 void Game::removeBedSleeper(uint32_t guid)
 {
@@ -5045,6 +5067,7 @@ Item* Game::getUniqueItem(uint16_t uniqueId)
 
 bool Game::addUniqueItem(uint16_t uniqueId, Item* item)
 {
+	std::lock_guard<std::mutex> lockGuard(mapLoadLock);
 	auto result = uniqueItems.emplace(uniqueId, item);
 	if (!result.second) {
 		std::cout << "Duplicate unique id: " << uniqueId << std::endl;
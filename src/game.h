@@ -532,6 +532,9 @@ private:
 	std::unordered_map<uint32_t, Guild_ptr> guilds;
 	std::unordered_map<uint16_t, Item*> uniqueItems;
 
+	// map loading registers unique items and bed sleepers from its worker threads
+	std::mutex mapLoadLock;
+
 	std::list<Item*> decayItems[EVENT_DECAY_BUCKETS];
 	std::list<Creature*> checkCreatureLists[EVENT_CREATURECOUNT];
 
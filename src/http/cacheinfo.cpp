@@ -9,13 +9,31 @@ namespace beast = boost::beast;
 namespace json = boost::json;
 using boost::beast::http::status;
 
+namespace {
+
+// every open launcher polls this, the count is only read from the database every few seconds
+constexpr auto playersOnlineTTL = std::chrono::seconds(5);
+
+std::mutex playersOnlineLock;
+std::optional<uint32_t> playersOnline;
+std::chrono::steady_clock::time_point playersOnlineExpiresAt;
+
+} // namespace
+
 std::pair<status, json::value> tfs::http::handle_cacheinfo(const json::object&, std::string_view)
 {
-	thread_local auto& db = Database::getInstance();
-	auto result = db.storeQuery("SELECT COUNT(*) AS `count` FROM `players_online`");
-	if (!result) {
-		return make_error_response();
+	// held while the count is read, so concurrent requests wait for one query instead of all running it
+	std::lock_guard<std::mutex> lockGuard(playersOnlineLock);
+	if (!playersOnline || playersOnlineExpiresAt <= std::chrono::steady_clock::now()) {
+		thread_local auto& db = Database::getInstance();
+		auto result = db.storeQuery("SELECT COUNT(*) AS `count` FROM `players_online`");
+		if (!result) {
+			return make_error_response();
+		}
+
+		playersOnline = result->getNumber<uint32_t>("count");
+		playersOnlineExpiresAt = std::chrono::steady_clock::now() + playersOnlineTTL;
 	}
 
-	return {status::ok, {{"playersonline", result->getNumber<uint32_t>("count")}}};
+	return {status::ok, {{"playersonline", *playersOnline}}};
 }
@@ -1,10 +1,32 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string_view>
+#include <vector>
 
 namespace tfs::http {
 
 void start(std::string_view address, unsigned short port = 8080, int threads = 1);
 void stop();
 
+// upper bounds of the request latency buckets in microseconds, slower requests are counted in one more bucket
+inline constexpr std::array<uint64_t, 8> latency_buckets = {1000, 2500, 5000, 10000, 25000, 100000, 250000, 1000000};
+
+struct RequestStats
+{
+	std::string_view type;
+	uint64_t count = 0;
+	uint64_t time = 0; // microseconds
+	std::array<uint64_t, latency_buckets.size() + 1> buckets = {};
+};
+
+std::vector<RequestStats> get_request_stats();
+
+/**
+ * Drops the cached character list of an account, so the next login reads it
+ * from the database again.
+ */
+void invalidate_character_list(uint64_t accountId);
+
 } // namespace tfs::http
@@ -5,6 +5,7 @@
 #include "../base64.h"
 #include "../game.h"
 #include "error.h"
+#include "http.h"
 
 #include <fmt/format.h>
 
@@ -31,8 +32,146 @@ int getPvpType()
 	tfs::unreachable();
 }
 
+using steady_clock = std::chrono::steady_clock;
+
+// clients reconnecting after a server save all ask for the same lists at once
+constexpr auto worldListTTL = std::chrono::seconds(30);
+constexpr auto characterListTTL = std::chrono::seconds(60);
+constexpr size_t maxCharacterLists = 4096;
+
+struct CharacterList
+{
+	json::array characters;
+	uint32_t lastLogin = 0;
+	// the characters of the account when the list was read, checked before a cached list is served
+	uint64_t playerCount = 0;
+	uint64_t maxPlayerId = 0;
+	steady_clock::time_point expiresAt;
+};
+
+std::mutex characterListsLock;
+std::unordered_map<uint64_t, std::shared_ptr<const CharacterList>> characterLists;
+// bumped by every invalidation, so a list read before one is not cached after it
+uint64_t characterListsVersion = 0;
+
+std::mutex worldListLock;
+std::shared_ptr<const json::array> worldList;
+steady_clock::time_point worldListExpiresAt;
+
+std::shared_ptr<const CharacterList> loadCharacterList(Database& db, uint64_t accountId)
+{
+	auto result = db.storeQuery(fmt::format(
+	    "SELECT `id`, `name`, `level`, `vocation`, `lastlogin`, `sex`, `looktype`, `lookhead`, `lookbody`, `looklegs`, `lookfeet`, `lookaddons` FROM `players` WHERE `account_id` = {:d}",
+	    accountId));
+
+	auto list = std::make_shared<CharacterList>();
+	list->expiresAt = steady_clock::now() + characterListTTL;
+	if (!result) {
+		return list;
+	}
+
+	do {
+		auto vocation = g_vocations.getVocation(result->getNumber<uint32_t>("vocation"));
+		assert(vocation);
+
+		list->characters.push_back({
+		    {"worldid", 0}, // not implemented
+		    {"name", result->getString("name")},
+		    {"level", result->getNumber<uint32_t>("level")},
+		    {"vocation", vocation->getVocName()},
+		    {"lastlogin", result->getNumber<uint64_t>("lastlogin")},
+		    {"ismale", result->getNumber<uint16_t>("sex") == PLAYERSEX_MALE},
+		    {"ishidden", false},        // not implemented
+		    {"ismaincharacter", false}, // not implemented
+		    {"tutorial", false},        // not implemented
+		    {"outfitid", result->getNumber<uint32_t>("looktype")},
+		    {"headcolor", result->getNumber<uint32_t>("lookhead")},
+		    {"torsocolor", result->getNumber<uint32_t>("lookbody")},
+		    {"legscolor", result->getNumber<uint32_t>("looklegs")},
+		    {"detailcolor", result->getNumber<uint32_t>("lookfeet")},
+		    {"addonsflags", result->getNumber<uint32_t>("lookaddons")},
+		    {"dailyrewardstate", 0}, // not implemented
+		});
+
+		list->lastLogin = std::max(list->lastLogin, result->getNumber<uint32_t>("lastlogin"));
+		list->maxPlayerId = std::max(list->maxPlayerId, result->getNumber<uint64_t>("id"));
+		++list->playerCount;
+	} while (result->next());
+	return list;
+}
+
+std::shared_ptr<const CharacterList> getCharacterList(Database& db, uint64_t accountId)
+{
+	// characters are created and deleted outside of the server, by account managers and websites, so a cached list
+	// is only served while the account has the same characters; this reads the players index only
+	uint64_t playerCount = 0, maxPlayerId = 0;
+	if (auto result = db.storeQuery(fmt::format(
+	        "SELECT COUNT(*) AS `count`, COALESCE(MAX(`id`), 0) AS `max_id` FROM `players` WHERE `account_id` = {:d}",
+	        accountId))) {
+		playerCount = result->getNumber<uint64_t>("count");
+		maxPlayerId = result->getNumber<uint64_t>("max_id");
+	}
+
+	uint64_t version;
+	{
+		std::lock_guard<std::mutex> lockGuard(characterListsLock);
+		auto it = characterLists.find(accountId);
+		if (it != characterLists.end() && it->second->expiresAt > steady_clock::now() &&
+		    it->second->playerCount == playerCount && it->second->maxPlayerId == maxPlayerId) {
+			return it->second;
+		}
+		version = characterListsVersion;
+	}
+
+	auto list = loadCharacterList(db, accountId);
+
+	std::lock_guard<std::mutex> lockGuard(characterListsLock);
+	if (version != characterListsVersion) {
+		return list;
+	}
+
+	if (characterLists.size() >= maxCharacterLists) {
+		auto now = steady_clock::now();
+		std::erase_if(characterLists, [now](const auto& it) { return it.second->expiresAt <= now; });
+	}
+	characterLists[accountId] = list;
+	return list;
+}
+
+std::shared_ptr<const json::array> getWorldList()
+{
+	std::lock_guard<std::mutex> lockGuard(worldListLock);
+	if (worldList && worldListExpiresAt > steady_clock::now()) {
+		return worldList;
+	}
+
+	worldList = std::make_shared<const json::array>(json::array{
+	    {
+	        {"id", 0}, // not implemented
+	        {"name", getString(ConfigManager::SERVER_NAME)},
+	        {"externaladdressprotected", getString(ConfigManager::IP)},
+	        {"externalportprotected", getNumber(ConfigManager::GAME_PORT)},
+	        {"externaladdressunprotected", getString(ConfigManager::IP)},
+	        {"externalportunprotected", getNumber(ConfigManager::GAME_PORT)},
+	        {"previewstate", 0}, // not implemented
+	        {"location", getString(ConfigManager::LOCATION)},
+	        {"anticheatprotection", false}, // not implemented
+	        {"pvptype", getPvpType()},
+	    },
+	});
+	worldListExpiresAt = steady_clock::now() + worldListTTL;
+	return worldList;
+}
+
 } // namespace
 
+void tfs::http::invalidate_character_list(uint64_t accountId)
+{
+	std::lock_guard<std::mutex> lockGuard(characterListsLock);
+	characterLists.erase(accountId);
+	++characterListsVersion;
+}
+
 std::pair<status, json::value> tfs::http::handle_login(const json::object& body, std::string_view ip)
 {
 	using namespace std::chrono;
@@ -91,54 +230,8 @@ std::pair<status, json::value> tfs::http::handle_login(const json::object& body,
 		return make_error_response();
 	}
 
-	result = db.storeQuery(fmt::format(
-	    "SELECT `id`, `name`, `level`, `vocation`, `lastlogin`, `sex`, `looktype`, `lookhead`, `lookbody`, `looklegs`, `lookfeet`, `lookaddons` FROM `players` WHERE `account_id` = {:d}",
-	    accountId));
-
-	json::array characters;
-	uint32_t lastLogin = 0;
-	if (result) {
-		do {
-			auto vocation = g_vocations.getVocation(result->getNumber<uint32_t>("vocation"));
-			assert(vocation);
-
-			characters.push_back({
-			    {"worldid", 0}, // not implemented
-			    {"name", result->getString("name")},
-			    {"level", result->getNumber<uint32_t>("level")},
-			    {"vocation", vocation->getVocName()},
-			    {"lastlogin", result->getNumber<uint64_t>("lastlogin")},
-			    {"ismale", result->getNumber<uint16_t>("sex") == PLAYERSEX_MALE},
-			    {"ishidden", false},        // not implemented
-			    {"ismaincharacter", false}, // not implemented
-			    {"tutorial", false},        // not implemented
-			    {"outfitid", result->getNumber<uint32_t>("looktype")},
-			    {"headcolor", result->getNumber<uint32_t>("lookhead")},
-			    {"torsocolor", result->getNumber<uint32_t>("lookbody")},
-			    {"legscolor", result->getNumber<uint32_t>("looklegs")},
-			    {"detailcolor", result->getNumber<uint32_t>("lookfeet")},
-			    {"addonsflags", result->getNumber<uint32_t>("lookaddons")},
-			    {"dailyrewardstate", 0}, // not implemented
-			});
-
-			lastLogin = std::max(lastLogin, result->getNumber<uint32_t>("lastlogin"));
-		} while (result->next());
-	}
-
-	json::array worlds{
-	    {
-	        {"id", 0}, // not implemented
-	        {"name", getString(ConfigManager::SERVER_NAME)},
-	        {"externaladdressprotected", getString(ConfigManager::IP)},
-	        {"externalportprotected", getNumber(ConfigManager::GAME_PORT)},
-	        {"externaladdressunprotected", getString(ConfigManager::IP)},
-	        {"externalportunprotected", getNumber(ConfigManager::GAME_PORT)},
-	        {"previewstate", 0}, // not implemented
-	        {"location", getString(ConfigManager::LOCATION)},
-	        {"anticheatprotection", false}, // not implemented
-	        {"pvptype", getPvpType()},
-	    },
-	};
+	auto characterList = getCharacterList(db, accountId);
+	auto worlds = getWorldList();
 
 	return {
 	    status::ok,
@@ -146,7 +239,7 @@ std::pair<status, json::value> tfs::http::handle_login(const json::object& body,
 	        {"session",
 	         {
 	             {"sessionkey", tfs::base64::encode(sessionKey)},
-	             {"lastlogintime", lastLogin},
+	             {"lastlogintime", characterList->lastLogin},
 	             {"ispremium", premiumEndsAt >= now},
 	             {"premiumuntil", premiumEndsAt},
 	             // not implemented
@@ -160,8 +253,8 @@ std::pair<status, json::value> tfs::http::handle_login(const json::object& body,
 	         }},
 	        {"playdata",
 	         {
-	             {"worlds", worlds},
-	             {"characters", characters},
+	             {"worlds", *worlds},
+	             {"characters", characterList->characters},
 	         }},
 	    },
 	};
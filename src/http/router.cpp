@@ -2,17 +2,51 @@
 
 #include "cacheinfo.h"
 #include "error.h"
+#include "http.h"
 #include "login.h"
 
+#include <atomic>
 #include <boost/json/monotonic_resource.hpp>
 #include <boost/json/parse.hpp>
 #include <boost/json/serialize.hpp>
+#include <chrono>
 
 namespace beast = boost::beast;
 namespace json = boost::json;
 
 namespace {
 
+// request types with their own latency histogram, anything else is counted as the last one
+constexpr std::array<std::string_view, 3> requestTypes = {"cacheinfo", "login", "other"};
+
+struct LatencyHistogram
+{
+	std::atomic<uint64_t> count{0};
+	std::atomic<uint64_t> time{0};
+	std::array<std::atomic<uint64_t>, tfs::http::latency_buckets.size() + 1> buckets{};
+};
+
+std::array<LatencyHistogram, requestTypes.size()> histograms;
+
+size_t getRequestTypeIndex(std::string_view type)
+{
+	auto it = std::find(requestTypes.begin(), requestTypes.end() - 1, type);
+	return std::distance(requestTypes.begin(), it);
+}
+
+void addRequestLatency(size_t typeIndex, uint64_t time)
+{
+	using tfs::http::latency_buckets;
+
+	auto& histogram = histograms[typeIndex];
+	histogram.count.fetch_add(1, std::memory_order_relaxed);
+	histogram.time.fetch_add(time, std::memory_order_relaxed);
+
+	auto bucket = std::distance(latency_buckets.begin(),
+	                            std::lower_bound(latency_buckets.begin(), latency_buckets.end(), time));
+	histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
 auto router(std::string_view type, const json::object& body, std::string_view ip)
 {
 	using namespace tfs::http;
@@ -34,7 +68,10 @@ thread_local json::monotonic_resource mr;
 beast::http::message_generator tfs::http::handle_request(const beast::http::request<beast::http::string_body>& req,
                                                          std::string_view ip)
 {
-	auto&& [status, responseBody] = [&req, ip]() {
+	auto start = std::chrono::steady_clock::now();
+	size_t typeIndex = requestTypes.size() - 1;
+
+	auto&& [status, responseBody] = [&req, ip, &typeIndex]() {
 		json::error_code ec;
 		auto requestBody = json::parse(req.body(), ec, &mr);
 		if (ec || !requestBody.is_object()) {
@@ -47,6 +84,7 @@ beast::http::message_generator tfs::http::handle_request(const beast::http::requ
 			return make_error_response({.code = 2, .message = "Invalid request type."});
 		}
 
+		typeIndex = getRequestTypeIndex(typeField->get_string());
 		return router(typeField->get_string(), requestBodyObj, ip);
 	}();
 
@@ -54,5 +92,25 @@ beast::http::message_generator tfs::http::handle_request(const beast::http::requ
 	res.body() = json::serialize(responseBody);
 	res.keep_alive(req.keep_alive());
 	res.prepare_payload();
+
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	addRequestLatency(typeIndex, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
 	return res;
 }
+
+std::vector<tfs::http::RequestStats> tfs::http::get_request_stats()
+{
+	std::vector<RequestStats> stats;
+	stats.reserve(requestTypes.size());
+	for (size_t i = 0; i < requestTypes.size(); ++i) {
+		const auto& histogram = histograms[i];
+		auto& requestStats = stats.emplace_back();
+		requestStats.type = requestTypes[i];
+		requestStats.count = histogram.count.load(std::memory_order_relaxed);
+		requestStats.time = histogram.time.load(std::memory_order_relaxed);
+		for (size_t bucket = 0; bucket < histogram.buckets.size(); ++bucket) {
+			requestStats.buckets[bucket] = histogram.buckets[bucket].load(std::memory_order_relaxed);
+		}
+	}
+	return stats;
+}
@@ -6,6 +6,7 @@
 #include "../../database.h"
 #include "../../tools.h"
 #include "../../vocation.h"
+#include "../http.h"
 #include "../login.h"
 
 #include <boost/test/unit_test.hpp>
@@ -296,3 +297,61 @@ BOOST_FIXTURE_TEST_CASE(test_login_success_with_token, LoginFixture)
 
 	BOOST_TEST(status == status::ok);
 }
+
+BOOST_FIXTURE_TEST_CASE(test_login_character_list_cached_until_invalidated, LoginFixture)
+{
+	auto result = db.storeQuery(
+	    "INSERT INTO `accounts` (`name`, `email`, `password`) VALUES ('klmn', 'klmn@example.com', SHA1('bar')) RETURNING `id`");
+	auto id = result->getNumber<uint64_t>("id");
+
+	BOOST_TEST(db.executeQuery(fmt::format("INSERT INTO `players` (`account_id`, `name`) VALUES ({:d}, 'First')", id)));
+
+	boost::json::object request{{"type", "login"}, {"email", "klmn@example.com"}, {"password", "bar"}};
+	{
+		auto&& [status, body] = tfs::http::handle_login(request, ip);
+		BOOST_TEST(status == status::ok);
+		BOOST_TEST(body.at("playdata").at("characters").as_array().size() == 1);
+	}
+
+	BOOST_TEST(db.executeQuery(fmt::format("UPDATE `players` SET `level` = 8 WHERE `account_id` = {:d}", id)));
+
+	// served from the cache until the account is invalidated
+	{
+		auto&& [status, body] = tfs::http::handle_login(request, ip);
+		BOOST_TEST(body.at("playdata").at("characters").at(0).at("level").as_uint64() == 1);
+	}
+
+	tfs::http::invalidate_character_list(id);
+	{
+		auto&& [status, body] = tfs::http::handle_login(request, ip);
+		BOOST_TEST(body.at("playdata").at("characters").at(0).at("level").as_uint64() == 8);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(test_login_character_list_sees_new_characters, LoginFixture)
+{
+	auto result = db.storeQuery(
+	    "INSERT INTO `accounts` (`name`, `email`, `password`) VALUES ('opqr', 'opqr@example.com', SHA1('bar')) RETURNING `id`");
+	auto id = result->getNumber<uint64_t>("id");
+
+	BOOST_TEST(db.executeQuery(fmt::format("INSERT INTO `players` (`account_id`, `name`) VALUES ({:d}, 'Third')", id)));
+
+	boost::json::object request{{"type", "login"}, {"email", "opqr@example.com"}, {"password", "bar"}};
+	{
+		auto&& [status, body] = tfs::http::handle_login(request, ip);
+		BOOST_TEST(body.at("playdata").at("characters").as_array().size() == 1);
+	}
+
+	// created outside of the server, nothing invalidates the cached list
+	BOOST_TEST(db.executeQuery(fmt::format("INSERT INTO `players` (`account_id`, `name`) VALUES ({:d}, 'Fourth')", id)));
+	{
+		auto&& [status, body] = tfs::http::handle_login(request, ip);
+		BOOST_TEST(body.at("playdata").at("characters").as_array().size() == 2);
+	}
+
+	BOOST_TEST(db.executeQuery("DELETE FROM `players` WHERE `name` = 'Third'"));
+	{
+		auto&& [status, body] = tfs::http::handle_login(request, ip);
+		BOOST_TEST(body.at("playdata").at("characters").as_array().size() == 1);
+	}
+}
@@ -9,10 +9,329 @@
 #include "configmanager.h"
 #include "depotchest.h"
 #include "game.h"
+#include "http/http.h"
 #include "inbox.h"
 
 extern Game g_game;
 
+namespace {
+
+// what was last written for each player, so older snapshots and unchanged item tables are skipped
+struct SavedPlayer
+{
+	uint64_t sequence = 0;
+	uint64_t itemsHash = 0;
+	uint64_t depotItemsHash = 0;
+};
+
+// held while a save is written, so saves of the same player reach the database in snapshot order
+std::mutex saveLock;
+
+std::mutex savedPlayersLock;
+std::unordered_map<uint32_t, SavedPlayer> savedPlayers;
+// saves taken on the dispatcher while a server save holds saveLock, it writes them once it is done
+std::unordered_map<uint32_t, PlayerSaveData> pendingSaves;
+bool takingPendingSaves = false;
+
+std::atomic<uint64_t> saveSequence{0};
+
+uint64_t hashItemRows(const std::vector<PlayerSaveData::ItemRow>& rows)
+{
+	constexpr uint64_t prime = 1099511628211ULL;
+	uint64_t hash = 14695981039346656037ULL;
+
+	auto add = [&hash](const void* data, size_t size) {
+		auto bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ bytes[i]) * prime;
+		}
+	};
+
+	for (const auto& row : rows) {
+		add(&row.pid, sizeof(row.pid));
+		add(&row.itemType, sizeof(row.itemType));
+		add(&row.count, sizeof(row.count));
+		uint32_t size = row.attributes.size();
+		add(&size, sizeof(size));
+		add(row.attributes.data(), row.attributes.size());
+	}
+	return hash;
+}
+
+std::string joinGuids(const std::vector<const PlayerSaveData*>& players)
+{
+	std::string guids;
+	for (const PlayerSaveData* player : players) {
+		if (!guids.empty()) {
+			guids.push_back(',');
+		}
+		guids += std::to_string(player->guid);
+	}
+	return guids;
+}
+
+bool deletePlayerRows(Database& db, std::string_view table, const std::vector<const PlayerSaveData*>& players)
+{
+	if (players.empty()) {
+		return true;
+	}
+	return db.executeQuery(fmt::format("DELETE FROM `{:s}` WHERE `player_id` IN ({:s})", table, joinGuids(players)));
+}
+
+bool insertItemRows(Database& db, std::string_view table, const std::vector<const PlayerSaveData*>& players,
+                    std::vector<PlayerSaveData::ItemRow> PlayerSaveData::*rows)
+{
+	DBInsert query(
+	    fmt::format("INSERT INTO `{:s}` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", table),
+	    db);
+
+	for (const PlayerSaveData* player : players) {
+		for (const auto& row : player->*rows) {
+			if (!query.addRow(fmt::format("{:d}, {:d}, {:d}, {:d}, {:d}, {:s}", player->guid, row.pid, row.sid,
+			                              row.itemType, row.count, db.escapeString(row.attributes)))) {
+				return false;
+			}
+		}
+	}
+	return query.execute();
+}
+
+// a player of a save, with the tables that have to be written for it
+struct PlayerWrite
+{
+	const PlayerSaveData* player;
+	bool full;
+	bool items;
+	bool depotItems;
+};
+
+bool writePlayers(Database& db, const std::vector<PlayerWrite>& writes)
+{
+	std::vector<const PlayerSaveData*> fullSaves, itemSaves, depotItemSaves;
+	for (const PlayerWrite& write : writes) {
+		const PlayerSaveData& player = *write.player;
+		if (!write.full) {
+			if (!db.executeQuery(fmt::format("UPDATE `players` SET {:s} WHERE `id` = {:d}", player.loginColumns,
+			                                 player.guid))) {
+				return false;
+			}
+			continue;
+		}
+
+		if (!db.executeQuery(fmt::format("UPDATE `players` SET {:s}, `conditions` = {:s} WHERE `id` = {:d}",
+		                                 player.columns, db.escapeString(player.conditions), player.guid))) {
+			return false;
+		}
+
+		fullSaves.push_back(&player);
+		if (write.items) {
+			itemSaves.push_back(&player);
+		}
+		if (write.depotItems) {
+			depotItemSaves.push_back(&player);
+		}
+	}
+
+	// learned spells
+	if (!deletePlayerRows(db, "player_spells", fullSaves)) {
+		return false;
+	}
+
+	DBInsert spellsQuery("INSERT INTO `player_spells` (`player_id`, `name`) VALUES ", db);
+	for (const PlayerSaveData* player : fullSaves) {
+		for (const std::string& spellName : player->spells) {
+			if (!spellsQuery.addRow(fmt::format("{:d}, {:s}", player->guid, db.escapeString(spellName)))) {
+				return false;
+			}
+		}
+	}
+
+	if (!spellsQuery.execute()) {
+		return false;
+	}
+
+	// item saving
+	if (!deletePlayerRows(db, "player_items", itemSaves) ||
+	    !insertItemRows(db, "player_items", itemSaves, &PlayerSaveData::items)) {
+		return false;
+	}
+
+	// save depot items
+	if (!deletePlayerRows(db, "player_depotitems", depotItemSaves) ||
+	    !insertItemRows(db, "player_depotitems", depotItemSaves, &PlayerSaveData::depotItems)) {
+		return false;
+	}
+
+	if (!deletePlayerRows(db, "player_storage", fullSaves)) {
+		return false;
+	}
+
+	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ", db);
+	for (const PlayerSaveData* player : fullSaves) {
+		for (const auto& [key, value] : player->storage) {
+			if (!storageQuery.addRow(fmt::format("{:d}, {:d}, {:d}", player->guid, key, value))) {
+				return false;
+			}
+		}
+	}
+	return storageQuery.execute();
+}
+
+// writes the players in one transaction, must be called with saveLock held
+bool writeSaves(Database& db, const std::vector<PlayerSaveData>& players)
+{
+	int64_t start = OTSYS_TIME();
+
+	// a newer snapshot of the player was already written, e.g. when it logged out during a server save
+	std::vector<const PlayerSaveData*> saves;
+	saves.reserve(players.size());
+	std::vector<SavedPlayer> saved;
+	saved.reserve(players.size());
+	{
+		std::lock_guard<std::mutex> lockGuard(savedPlayersLock);
+		for (const PlayerSaveData& player : players) {
+			const SavedPlayer& savedPlayer = savedPlayers[player.guid];
+			if (player.sequence > savedPlayer.sequence) {
+				saves.push_back(&player);
+				saved.push_back(savedPlayer);
+			}
+		}
+	}
+
+	if (saves.empty()) {
+		return true;
+	}
+
+	DBResult_ptr result =
+	    db.storeQuery(fmt::format("SELECT `id`, `save` FROM `players` WHERE `id` IN ({:s})", joinGuids(saves)));
+	if (!result) {
+		return false;
+	}
+
+	std::unordered_map<uint32_t, bool> saveFlags;
+	do {
+		saveFlags.emplace(result->getNumber<uint32_t>("id"), result->getNumber<uint16_t>("save") != 0);
+	} while (result->next());
+
+	std::vector<PlayerWrite> writes;
+	writes.reserve(saves.size());
+	bool success = true;
+
+	for (size_t i = 0; i < saves.size(); ++i) {
+		const PlayerSaveData& player = *saves[i];
+
+		auto it = saveFlags.find(player.guid);
+		if (it == saveFlags.end()) {
+			std::cout << "[Error - IOLoginData::savePlayers] Player " << player.guid << " does not exist."
+			          << std::endl;
+			success = false;
+			continue;
+		}
+
+		bool full = it->second;
+		writes.push_back({&player, full, full && player.itemsHash != saved[i].itemsHash,
+		                  full && player.depotItemsHash != saved[i].depotItemsHash});
+	}
+
+	int64_t flagsTime = OTSYS_TIME() - start;
+	int64_t writeStart = OTSYS_TIME();
+
+	DBTransaction transaction(db);
+	if (!transaction.begin()) {
+		return false;
+	}
+
+	// all players at once, and one by one when that fails so one bad player does not hold back the others
+	if (!db.executeQuery("SAVEPOINT `players`")) {
+		return false;
+	}
+
+	if (writePlayers(db, writes)) {
+		if (!db.executeQuery("RELEASE SAVEPOINT `players`")) {
+			return false;
+		}
+	} else {
+		if (!db.executeQuery("ROLLBACK TO SAVEPOINT `players`")) {
+			return false;
+		}
+
+		std::vector<PlayerWrite> written;
+		written.reserve(writes.size());
+		for (const PlayerWrite& write : writes) {
+			if (!db.executeQuery("SAVEPOINT `player`")) {
+				return false;
+			}
+
+			if (writePlayers(db, {write})) {
+				written.push_back(write);
+				continue;
+			}
+
+			if (!db.executeQuery("ROLLBACK TO SAVEPOINT `player`")) {
+				return false;
+			}
+
+			std::cout << "[Error - IOLoginData::savePlayers] Failed to save player " << write.player->guid << '.'
+			          << std::endl;
+			success = false;
+		}
+		writes = std::move(written);
+	}
+
+	int64_t writeTime = OTSYS_TIME() - writeStart;
+	int64_t commitStart = OTSYS_TIME();
+
+	// End the transaction
+	if (!transaction.commit()) {
+		return false;
+	}
+
+	size_t fullSaves = 0, itemSaves = 0, depotItemSaves = 0;
+	{
+		std::lock_guard<std::mutex> lockGuard(savedPlayersLock);
+		for (const PlayerWrite& write : writes) {
+			SavedPlayer& savedPlayer = savedPlayers[write.player->guid];
+			savedPlayer.sequence = write.player->sequence;
+			if (write.full) {
+				savedPlayer.itemsHash = write.player->itemsHash;
+				savedPlayer.depotItemsHash = write.player->depotItemsHash;
+				++fullSaves;
+			}
+			itemSaves += write.items;
+			depotItemSaves += write.depotItems;
+		}
+	}
+
+	// the level, outfit and last login shown in the character list may have changed
+	for (const PlayerWrite& write : writes) {
+		tfs::http::invalidate_character_list(write.player->accountId);
+	}
+
+	if (players.size() > 1) {
+		std::cout << "> Saved " << fullSaves << " players (" << itemSaves << " inventories, " << depotItemSaves
+		          << " depots changed) in " << (OTSYS_TIME() - start) / 1000. << "s: flags " << flagsTime / 1000.
+		          << "s, writes " << writeTime / 1000. << "s, commit " << (OTSYS_TIME() - commitStart) / 1000.
+		          << "s." << std::endl;
+	}
+	return success;
+}
+
+// a save of the player handed to the running server save is not written yet
+void waitForPendingSave(uint32_t guid)
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(savedPlayersLock);
+		if (guid != 0 ? !pendingSaves.contains(guid) : pendingSaves.empty()) {
+			return;
+		}
+	}
+
+	// the server save writes them before it lets go of the lock
+	std::lock_guard<std::mutex> saveGuard(saveLock);
+}
+
+} // namespace
+
 uint32_t IOLoginData::getAccountIdByPlayerName(const std::string& playerName)
 {
 	Database& db = Database::getInstance();
@@ -93,6 +412,8 @@ bool IOLoginData::preloadPlayer(Player* player)
 
 bool IOLoginData::loadPlayerById(Player* player, uint32_t id)
 {
+	waitForPendingSave(id);
+
 	Database& db = Database::getInstance();
 	return loadPlayer(
 	    player,
@@ -103,6 +424,9 @@ bool IOLoginData::loadPlayerById(Player* player, uint32_t id)
 
 bool IOLoginData::loadPlayerByName(Player* player, const std::string& name)
 {
+	// the guid is not known yet, any pending save may be this player
+	waitForPendingSave(0);
+
 	Database& db = Database::getInstance();
 	return loadPlayer(
 	    player,
@@ -153,6 +477,15 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result)
 
 	player->setGUID(result->getNumber<uint32_t>("id"));
 	player->name = result->getString("name");
+
+	{
+		// items may have been changed in the database while the player was offline
+		std::lock_guard<std::mutex> lockGuard(savedPlayersLock);
+		if (auto it = savedPlayers.find(player->getGUID()); it != savedPlayers.end()) {
+			it->second.itemsHash = 0;
+			it->second.depotItemsHash = 0;
+		}
+	}
 	player->accountNumber = accountId;
 
 	Group* group = g_game.groups.getGroup(result->getNumber<uint16_t>("group_id"));
@@ -487,8 +820,8 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result)
 	return true;
 }
 
-bool IOLoginData::saveItems(const Player* player, const ItemBlockList& itemList, DBInsert& query_insert,
-                            PropWriteStream& propWriteStream)
+void IOLoginData::addItemRows(const ItemBlockList& itemList, std::vector<PlayerSaveData::ItemRow>& rows,
+                              PropWriteStream& propWriteStream)
 {
 	using ContainerBlock = std::pair<Container*, int32_t>;
 	std::vector<ContainerBlock> containers;
@@ -496,20 +829,19 @@ bool IOLoginData::saveItems(const Player* player, const ItemBlockList& itemList,
 
 	int32_t runningId = 100;
 
-	Database& db = Database::getInstance();
+	auto addRow = [&](int32_t pid, const Item* item) {
+		propWriteStream.clear();
+		item->serializeAttr(propWriteStream);
+
+		auto attributes = propWriteStream.getStream();
+		rows.push_back({pid, runningId, item->getID(), item->getSubType(), {attributes.data(), attributes.size()}});
+	};
+
 	for (const auto& it : itemList) {
-		int32_t pid = it.first;
 		Item* item = it.second;
 		++runningId;
 
-		propWriteStream.clear();
-		item->serializeAttr(propWriteStream);
-
-		if (!query_insert.addRow(fmt::format("{:d}, {:d}, {:d}, {:d}, {:d}, {:s}", player->getGUID(), pid, runningId,
-		                                     item->getID(), item->getSubType(),
-		                                     db.escapeString(propWriteStream.getStream())))) {
-			return false;
-		}
+		addRow(it.first, item);
 
 		if (Container* container = item->getContainer()) {
 			containers.emplace_back(container, runningId);
@@ -529,38 +861,25 @@ bool IOLoginData::saveItems(const Player* player, const ItemBlockList& itemList,
 				containers.emplace_back(subContainer, runningId);
 			}
 
-			propWriteStream.clear();
-			item->serializeAttr(propWriteStream);
-
-			if (!query_insert.addRow(fmt::format("{:d}, {:d}, {:d}, {:d}, {:d}, {:s}", player->getGUID(), parentId,
-			                                     runningId, item->getID(), item->getSubType(),
-			                                     db.escapeString(propWriteStream.getStream())))) {
-				return false;
-			}
+			addRow(parentId, item);
 		}
 	}
-	return query_insert.execute();
 }
 
-bool IOLoginData::savePlayer(Player* player)
+PlayerSaveData IOLoginData::getPlayerSaveData(Player* player)
 {
 	if (player->isDead()) {
 		player->changeHealth(1);
 	}
 
-	Database& db = Database::getInstance();
+	PlayerSaveData data;
+	data.guid = player->getGUID();
+	data.accountId = player->getAccount();
+	data.sequence = ++saveSequence;
 
-	DBResult_ptr result =
-	    db.storeQuery(fmt::format("SELECT `save` FROM `players` WHERE `id` = {:d}", player->getGUID()));
-	if (!result) {
-		return false;
-	}
-
-	if (result->getNumber<uint16_t>("save") == 0) {
-		return db.executeQuery(
-		    fmt::format("UPDATE `players` SET `lastlogin` = {:d}, `lastip` = INET6_ATON('{:s}') WHERE `id` = {:d}",
-		                player->lastLoginSaved, player->lastIP.to_string(), player->getGUID()));
-	}
+	// used instead of the full save while the save flag of the player is off
+	data.loginColumns = fmt::format("`lastlogin` = {:d}, `lastip` = INET6_ATON('{:s}')", player->lastLoginSaved,
+	                                player->lastIP.to_string());
 
 	// serialize conditions
 	PropWriteStream propWriteStream;
@@ -571,9 +890,11 @@ bool IOLoginData::savePlayer(Player* player)
 		}
 	}
 
-	// First, an UPDATE query to write the player itself
+	auto conditions = propWriteStream.getStream();
+	data.conditions.assign(conditions.data(), conditions.size());
+
+	// the players row, conditions are escaped and added when it is written
 	std::ostringstream query;
-	query << "UPDATE `players` SET ";
 	query << "`level` = " << player->level << ',';
 	query << "`group_id` = " << player->group->id << ',';
 	query << "`vocation` = " << player->getVocationId() << ',';
@@ -609,8 +930,6 @@ bool IOLoginData::savePlayer(Player* player)
 		query << "`lastip` = INET6_ATON('" << player->lastIP.to_string() << "'),";
 	}
 
-	query << "`conditions` = " << db.escapeString(propWriteStream.getStream()) << ',';
-
 	if (g_game.getWorldType() != WORLD_TYPE_PVP_ENFORCED) {
 		int64_t skullTime = 0;
 
@@ -654,41 +973,12 @@ bool IOLoginData::savePlayer(Player* player)
 		query << "`onlinetime` = `onlinetime` + " << (time(nullptr) - player->lastLoginSaved) << ',';
 	}
 	query << "`blessings` = " << player->blessings.to_ulong();
-	query << " WHERE `id` = " << player->getGUID();
-
-	DBTransaction transaction;
-	if (!transaction.begin()) {
-		return false;
-	}
-
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
+	data.columns = query.str();
 
 	// learned spells
-	if (!db.executeQuery(fmt::format("DELETE FROM `player_spells` WHERE `player_id` = {:d}", player->getGUID()))) {
-		return false;
-	}
-
-	DBInsert spellsQuery("INSERT INTO `player_spells` (`player_id`, `name`) VALUES ");
-	for (const std::string& spellName : player->learnedInstantSpellList) {
-		if (!spellsQuery.addRow(fmt::format("{:d}, {:s}", player->getGUID(), db.escapeString(spellName)))) {
-			return false;
-		}
-	}
-
-	if (!spellsQuery.execute()) {
-		return false;
-	}
+	data.spells.assign(player->learnedInstantSpellList.begin(), player->learnedInstantSpellList.end());
 
 	// item saving
-	if (!db.executeQuery(fmt::format("DELETE FROM `player_items` WHERE `player_id` = {:d}", player->getGUID()))) {
-		return false;
-	}
-
-	DBInsert itemsQuery(
-	    "INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	ItemBlockList itemList;
 	for (int32_t slotId = CONST_SLOT_FIRST; slotId <= CONST_SLOT_LAST; ++slotId) {
 		Item* item = player->inventory[slotId];
@@ -697,17 +987,10 @@ bool IOLoginData::savePlayer(Player* player)
 		}
 	}
 
-	if (!saveItems(player, itemList, itemsQuery, propWriteStream)) {
-		return false;
-	}
+	addItemRows(itemList, data.items, propWriteStream);
+	data.itemsHash = hashItemRows(data.items);
 
 	// save depot items
-	if (!db.executeQuery(fmt::format("DELETE FROM `player_depotitems` WHERE `player_id` = {:d}", player->getGUID()))) {
-		return false;
-	}
-
-	DBInsert depotQuery(
-	    "INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
 	itemList.clear();
 
 	for (const auto& it : player->depotChests) {
@@ -716,28 +999,66 @@ bool IOLoginData::savePlayer(Player* player)
 		}
 	}
 
-	if (!saveItems(player, itemList, depotQuery, propWriteStream)) {
-		return false;
+	addItemRows(itemList, data.depotItems, propWriteStream);
+	data.depotItemsHash = hashItemRows(data.depotItems);
+
+	data.storage = player->getStorageMap();
+	return data;
+}
+
+bool IOLoginData::savePlayer(Player* player)
+{
+	PlayerSaveData data = getPlayerSaveData(player);
+
+	std::unique_lock<std::mutex> saveGuard(saveLock, std::try_to_lock);
+	if (!saveGuard.owns_lock()) {
+		// a server save is being written, hand the save over instead of waiting for it on the dispatcher
+		{
+			std::lock_guard<std::mutex> lockGuard(savedPlayersLock);
+			if (takingPendingSaves) {
+				pendingSaves.insert_or_assign(data.guid, std::move(data));
+				return true;
+			}
+		}
+
+		// it is already writing the saves handed over to it
+		saveGuard.lock();
 	}
 
-	if (!db.executeQuery(fmt::format("DELETE FROM `player_storage` WHERE `player_id` = {:d}", player->getGUID()))) {
-		return false;
+	std::vector<PlayerSaveData> players;
+	players.push_back(std::move(data));
+	return writeSaves(Database::getInstance(), players);
+}
+
+bool IOLoginData::savePlayers(Database& db, const std::vector<PlayerSaveData>& players)
+{
+	std::lock_guard<std::mutex> saveGuard(saveLock);
+
+	{
+		std::lock_guard<std::mutex> lockGuard(savedPlayersLock);
+		takingPendingSaves = true;
 	}
 
-	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
+	bool success = writeSaves(db, players);
 
-	for (const auto& [key, value] : player->getStorageMap()) {
-		if (!storageQuery.addRow(fmt::format("{:d}, {:d}, {:d}", player->getGUID(), key, value))) {
-			return false;
+	// the players that logged out meanwhile, newer than their snapshot in the batch
+	std::vector<PlayerSaveData> pending;
+	{
+		std::lock_guard<std::mutex> lockGuard(savedPlayersLock);
+		takingPendingSaves = false;
+		pending.reserve(pendingSaves.size());
+		for (auto& it : pendingSaves) {
+			pending.push_back(std::move(it.second));
 		}
+		pendingSaves.clear();
 	}
 
-	if (!storageQuery.execute()) {
-		return false;
+	if (!pending.empty() && !writeSaves(db, pending)) {
+		std::cout << "[Error - IOLoginData::savePlayers] Failed to save " << pending.size()
+		          << " players saved during the server save." << std::endl;
+		success = false;
 	}
-
-	// End the transaction
-	return transaction.commit();
+	return success;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid)
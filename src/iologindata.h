@@ -14,6 +14,37 @@ struct VIPEntry;
 
 using ItemBlockList = std::list<std::pair<int32_t, Item*>>;
 
+/**
+ * Everything a save writes for one player, copied on the dispatcher thread so
+ * it can be written by the database thread while the game goes on.
+ */
+struct PlayerSaveData
+{
+	struct ItemRow
+	{
+		int32_t pid;
+		int32_t sid;
+		uint16_t itemType;
+		uint16_t count;
+		std::string attributes;
+	};
+
+	uint32_t guid = 0;
+	uint32_t accountId = 0;
+	// order in which the snapshots were taken, a save never overwrites a newer one
+	uint64_t sequence = 0;
+
+	std::string columns;
+	std::string loginColumns;
+	std::string conditions;
+	std::vector<std::string> spells;
+	std::vector<ItemRow> items;
+	std::vector<ItemRow> depotItems;
+	uint64_t itemsHash = 0;
+	uint64_t depotItemsHash = 0;
+	std::map<uint32_t, int32_t> storage;
+};
+
 class IOLoginData
 {
 public:
@@ -29,6 +60,20 @@ public:
 	static bool loadPlayerByName(Player* player, const std::string& name);
 	static bool loadPlayer(Player* player, DBResult_ptr result);
 	static bool savePlayer(Player* player);
+
+	/**
+	 * Takes the state of a player to save, must run on the dispatcher thread.
+	 */
+	static PlayerSaveData getPlayerSaveData(Player* player);
+
+	/**
+	 * Writes the given players in one transaction, with one multi-row statement
+	 * per table. Item tables of players whose items did not change since they
+	 * were last written are left alone. When a statement fails the players are
+	 * written one by one and only the failing ones are left out. Players saved
+	 * with savePlayer meanwhile are written right after.
+	 */
+	static bool savePlayers(Database& db, const std::vector<PlayerSaveData>& players);
 	static uint32_t getGuidByName(const std::string& name);
 	static bool getGuidByNameEx(uint32_t& guid, bool& specialVip, std::string& name);
 	static std::string getNameByGuid(uint32_t guid);
@@ -49,8 +94,8 @@ private:
 	using ItemMap = std::map<uint32_t, std::pair<Item*, uint32_t>>;
 
 	static void loadItems(ItemMap& itemMap, DBResult_ptr result);
-	static bool saveItems(const Player* player, const ItemBlockList& itemList, DBInsert& query_insert,
-	                      PropWriteStream& propWriteStream);
+	static void addItemRows(const ItemBlockList& itemList, std::vector<PlayerSaveData::ItemRow>& rows,
+	                        PropWriteStream& propWriteStream);
 };
 
 #endif // FS_IOLOGINDATA_H
@@ -5,8 +5,11 @@
 
 #include "iomap.h"
 
+#include "depotlocker.h"
 #include "housetile.h"
 
+#include <fstream>
+
 /*
         OTBM_ROOTV1
         |
@@ -50,12 +53,536 @@ Tile* IOMap::createTile(Item*& ground, Item* item, uint16_t x, uint16_t y, uint8
 	return tile;
 }
 
+namespace {
+
+// Stops and joins the tile area workers on every way out of loadMap, before the loader they read from is gone.
+class TileAreaWorkers
+{
+public:
+	explicit TileAreaWorkers(std::function<void()> stop) : stop(std::move(stop)) {}
+	~TileAreaWorkers() { join(); }
+
+	// non-copyable
+	TileAreaWorkers(const TileAreaWorkers&) = delete;
+	TileAreaWorkers& operator=(const TileAreaWorkers&) = delete;
+
+	void start(size_t count, const std::function<void()>& work)
+	{
+		for (size_t i = 0; i < count; ++i) {
+			threads.emplace_back(work);
+		}
+	}
+
+	void join()
+	{
+		if (threads.empty()) {
+			return;
+		}
+
+		stop();
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		threads.clear();
+	}
+
+private:
+	std::function<void()> stop;
+	std::vector<std::thread> threads;
+};
+
+constexpr OTB::Identifier snapshotIdentifier = {{'O', 'T', 'B', 'S'}};
+constexpr uint32_t snapshotVersion = 2;
+
+// a house tile, or the kind of tile IOMap::createTile picked for the items on it
+enum SnapshotTileKind : uint8_t
+{
+	SNAPSHOT_TILE_STATIC = 0,
+	SNAPSHOT_TILE_DYNAMIC = 1,
+	SNAPSHOT_TILE_HOUSE = 2,
+};
+
+constexpr tileflags_t snapshotZoneFlags[] = {TILESTATE_PROTECTIONZONE, TILESTATE_NOPVPZONE, TILESTATE_PVPZONE,
+                                             TILESTATE_NOLOGOUT};
+
+// Writes an item with every attribute the map can give it. Item::serializeAttr leaves out what is only ever read
+// from the map (action ids of fixed items, unique ids, house door and depot ids), so those are added here.
+void writeSnapshotItem(PropWriteStream& stream, const Item* item)
+{
+	stream.write<uint16_t>(item->getID());
+
+	const Door* door = item->getDoor();
+	if (door) {
+		// house doors do not save their attributes with the house items
+		item->Item::serializeAttr(stream);
+	} else {
+		item->serializeAttr(stream);
+	}
+
+	if (!Item::items[item->getID()].moveable && item->getActionId() != 0) {
+		stream.write<uint8_t>(ATTR_ACTION_ID);
+		stream.write<uint16_t>(item->getActionId());
+	}
+
+	if (item->getUniqueId() != 0) {
+		stream.write<uint8_t>(ATTR_UNIQUE_ID);
+		stream.write<uint16_t>(item->getUniqueId());
+	}
+
+	if (door && door->getDoorId() != 0) {
+		stream.write<uint8_t>(ATTR_HOUSEDOORID);
+		stream.write<uint8_t>(door->getDoorId());
+	}
+
+	if (const DepotLocker* depotLocker = dynamic_cast<const DepotLocker*>(item)) {
+		stream.write<uint8_t>(ATTR_DEPOT_ID);
+		stream.write<uint16_t>(depotLocker->getDepotId());
+	}
+
+	if (const Container* container = item->getContainer()) {
+		stream.write<uint8_t>(ATTR_CONTAINER_ITEMS);
+		stream.write<uint32_t>(container->size());
+		for (const Item* containerItem : container->getItemList()) {
+			writeSnapshotItem(stream, containerItem);
+		}
+	}
+
+	stream.write<uint8_t>(0x00); // attr end
+}
+
+} // namespace
+
+std::vector<IOMap::SourceStamp> IOMap::getSourceStamps(const std::filesystem::path& fileName)
+{
+	std::vector<SourceStamp> sourceStamps;
+	for (const std::string& source :
+	     {fileName.string(), Item::items.getOtbFileName(), Item::items.getXmlFileName()}) {
+		sourceStamps.push_back({source, std::filesystem::file_size(source),
+		                        std::filesystem::last_write_time(source).time_since_epoch().count()});
+	}
+	return sourceStamps;
+}
+
+bool IOMap::isSnapshotUpToDate(const std::filesystem::path& snapshotFileName,
+                               const std::vector<SourceStamp>& sourceStamps)
+{
+	std::error_code ec;
+	if (!std::filesystem::exists(snapshotFileName, ec)) {
+		return false;
+	}
+
+	try {
+		boost::iostreams::mapped_file_source file{snapshotFileName.string()};
+
+		PropStream propStream;
+		propStream.init(file.data(), file.size());
+
+		OTB::Identifier identifier;
+		uint32_t version;
+		uint8_t sourceCount;
+		if (!propStream.read(identifier) || identifier != snapshotIdentifier || !propStream.read(version) ||
+		    version != snapshotVersion || !propStream.read(sourceCount) || sourceCount != sourceStamps.size()) {
+			return false;
+		}
+
+		for (const SourceStamp& sourceStamp : sourceStamps) {
+			auto [fileName, ok] = propStream.readString();
+			SourceStamp snapshotStamp{std::string{fileName}};
+			if (!ok || !propStream.read(snapshotStamp.size) || !propStream.read(snapshotStamp.modified) ||
+			    snapshotStamp != sourceStamp) {
+				return false;
+			}
+		}
+		return true;
+	} catch (const std::exception&) {
+		return false;
+	}
+}
+
+bool IOMap::loadSnapshot(Map& map, const std::filesystem::path& snapshotFileName)
+{
+	boost::iostreams::mapped_file_source file{snapshotFileName.string()};
+
+	PropStream propStream;
+	propStream.init(file.data(), file.size());
+
+	// the header was checked by isSnapshotUpToDate
+	OTB::Identifier identifier;
+	uint32_t version;
+	uint8_t sourceCount;
+	if (!propStream.read(identifier) || !propStream.read(version) || !propStream.read(sourceCount)) {
+		setLastErrorString("Could not read snapshot header.");
+		return false;
+	}
+
+	for (uint8_t i = 0; i < sourceCount; ++i) {
+		if (!propStream.readString().second ||
+		    !propStream.skip(sizeof(SourceStamp::size) + sizeof(SourceStamp::modified))) {
+			setLastErrorString("Could not read snapshot header.");
+			return false;
+		}
+	}
+
+	uint32_t width, height;
+	if (!propStream.read(width) || !propStream.read(height)) {
+		setLastErrorString("Could not read snapshot map size.");
+		return false;
+	}
+
+	std::cout << "> Map size: " << width << "x" << height << '.' << std::endl;
+	map.width = width;
+	map.height = height;
+
+	auto [spawnFile, spawnFileOk] = propStream.readString();
+	auto [houseFile, houseFileOk] = propStream.readString();
+	if (!spawnFileOk || !houseFileOk) {
+		setLastErrorString("Could not read snapshot spawn and house files.");
+		return false;
+	}
+
+	map.spawnfile = spawnFile;
+	map.housefile = houseFile;
+
+	uint32_t townCount;
+	if (!propStream.read(townCount)) {
+		setLastErrorString("Could not read snapshot towns.");
+		return false;
+	}
+
+	for (uint32_t i = 0; i < townCount; ++i) {
+		uint32_t townId;
+		if (!propStream.read(townId)) {
+			setLastErrorString("Could not read town id.");
+			return false;
+		}
+
+		auto [townName, ok] = propStream.readString();
+		OTBM_Destination_coords templePos;
+		if (!ok || !propStream.read(templePos)) {
+			setLastErrorString("Could not read town data.");
+			return false;
+		}
+
+		Town* town = new Town(townId);
+		town->setName(townName);
+		town->setTemplePos(Position(templePos.x, templePos.y, templePos.z));
+		if (!map.towns.addTown(townId, town)) {
+			delete town;
+		}
+	}
+
+	uint32_t waypointCount;
+	if (!propStream.read(waypointCount)) {
+		setLastErrorString("Could not read snapshot waypoints.");
+		return false;
+	}
+
+	for (uint32_t i = 0; i < waypointCount; ++i) {
+		auto [name, ok] = propStream.readString();
+		OTBM_Destination_coords waypointPos;
+		if (!ok || !propStream.read(waypointPos)) {
+			setLastErrorString("Could not read waypoint data.");
+			return false;
+		}
+
+		map.waypoints[std::string{name}] = Position(waypointPos.x, waypointPos.y, waypointPos.z);
+	}
+
+	uint32_t tileCount;
+	if (!propStream.read(tileCount)) {
+		setLastErrorString("Could not read snapshot tiles.");
+		return false;
+	}
+
+	// the items of a tile are read before the tile is built, so a broken record leaves nothing behind
+	std::vector<std::pair<Item*, bool>> tileItems;
+
+	std::function<Item*()> readItem = [&]() -> Item* {
+		uint16_t id;
+		if (!propStream.read<uint16_t>(id)) {
+			return nullptr;
+		}
+
+		std::unique_ptr<Item> item{Item::CreateItem(id)};
+		if (!item || !item->unserializeAttr(propStream)) {
+			return nullptr;
+		}
+
+		if (Container* container = item->getContainer()) {
+			for (; container->serializationCount > 0; --container->serializationCount) {
+				Item* containerItem = readItem();
+				if (!containerItem) {
+					return nullptr;
+				}
+
+				container->addItem(containerItem);
+				container->updateItemWeight(containerItem->getWeight());
+			}
+
+			uint8_t endAttr;
+			if (!propStream.read<uint8_t>(endAttr) || endAttr != 0) {
+				return nullptr;
+			}
+		}
+		return item.release();
+	};
+
+	for (uint32_t i = 0; i < tileCount; ++i) {
+		OTBM_Destination_coords tilePos;
+		uint8_t kind;
+		uint32_t zoneFlags;
+		uint16_t itemCount;
+		if (!propStream.read(tilePos) || !propStream.read(kind) || !propStream.read(zoneFlags) ||
+		    !propStream.read(itemCount)) {
+			setLastErrorString("Could not read snapshot tile.");
+			return false;
+		}
+
+		uint16_t x = tilePos.x;
+		uint16_t y = tilePos.y;
+		uint8_t z = tilePos.z;
+
+		uint32_t houseId = 0;
+		if (kind == SNAPSHOT_TILE_HOUSE && !propStream.read(houseId)) {
+			setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not read house id.", x, y, z));
+			return false;
+		}
+
+		for (uint16_t j = 0; j < itemCount; ++j) {
+			uint8_t loadedFromMap;
+			Item* item = propStream.read(loadedFromMap) ? readItem() : nullptr;
+			if (!item) {
+				for (const auto& tileItem : tileItems) {
+					delete tileItem.first;
+				}
+				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to load item.", x, y, z));
+				return false;
+			}
+			tileItems.emplace_back(item, loadedFromMap != 0);
+		}
+
+		Tile* tile;
+		if (kind == SNAPSHOT_TILE_HOUSE) {
+			House* house = map.houses.addHouse(houseId);
+			if (!house) {
+				for (const auto& tileItem : tileItems) {
+					delete tileItem.first;
+				}
+				setLastErrorString(
+				    fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not create house id: {:d}", x, y, z, houseId));
+				return false;
+			}
+
+			tile = new HouseTile(x, y, z, house);
+			house->addTile(static_cast<HouseTile*>(tile));
+		} else if (kind == SNAPSHOT_TILE_DYNAMIC) {
+			tile = new DynamicTile(x, y, z);
+		} else {
+			tile = new StaticTile(x, y, z);
+		}
+
+		// the items are stored in the order internalAddThing puts them back where they were
+		for (const auto& [item, loadedFromMap] : tileItems) {
+			tile->internalAddThing(item);
+			item->startDecaying();
+			item->setLoadedFromMap(loadedFromMap);
+		}
+		tileItems.clear();
+
+		tile->setFlag(zoneFlags);
+		map.setTile(x, y, z, tile);
+	}
+	return true;
+}
+
+bool IOMap::writeSnapshot(const Map& map, const std::filesystem::path& snapshotFileName,
+                          const std::vector<SourceStamp>& sourceStamps, std::vector<Position>& tiles)
+{
+	PropWriteStream stream;
+	stream.write(snapshotIdentifier);
+	stream.write(snapshotVersion);
+	stream.write<uint8_t>(sourceStamps.size());
+	for (const SourceStamp& sourceStamp : sourceStamps) {
+		stream.writeString(sourceStamp.fileName);
+		stream.write(sourceStamp.size);
+		stream.write(sourceStamp.modified);
+	}
+
+	stream.write(map.width);
+	stream.write(map.height);
+	stream.writeString(map.spawnfile.string());
+	stream.writeString(map.housefile.string());
+
+	const TownMap& towns = map.towns.getTowns();
+	stream.write<uint32_t>(towns.size());
+	for (const auto& [townId, town] : towns) {
+		const Position& templePos = town->getTemplePosition();
+		stream.write<uint32_t>(townId);
+		stream.writeString(town->getName());
+		stream.write(OTBM_Destination_coords{templePos.x, templePos.y, templePos.z});
+	}
+
+	stream.write<uint32_t>(map.waypoints.size());
+	for (const auto& [name, pos] : map.waypoints) {
+		stream.writeString(name);
+		stream.write(OTBM_Destination_coords{pos.x, pos.y, pos.z});
+	}
+
+	// a map may list a position more than once, Map::setTile merged those into one tile
+	std::sort(tiles.begin(), tiles.end());
+	tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+	std::erase_if(tiles, [&map](const Position& pos) { return !map.getTile(pos); });
+
+	stream.write<uint32_t>(tiles.size());
+	for (const Position& pos : tiles) {
+		const Tile* tile = map.getTile(pos);
+
+		uint8_t kind = SNAPSHOT_TILE_DYNAMIC;
+		if (dynamic_cast<const HouseTile*>(tile)) {
+			kind = SNAPSHOT_TILE_HOUSE;
+		} else if (dynamic_cast<const StaticTile*>(tile)) {
+			kind = SNAPSHOT_TILE_STATIC;
+		}
+
+		uint32_t zoneFlags = TILESTATE_NONE;
+		for (tileflags_t flag : snapshotZoneFlags) {
+			if (tile->hasFlag(flag)) {
+				zoneFlags |= flag;
+			}
+		}
+
+		// the ground first, then the items in the order internalAddThing rebuilds them: it puts every item that is
+		// not always on top in front of the others, so those are written last to first
+		std::vector<const Item*> items;
+		if (const Item* ground = tile->getGround()) {
+			items.push_back(ground);
+		}
+
+		if (const TileItemVector* tileItems = tile->getItemList()) {
+			items.insert(items.end(), std::make_reverse_iterator(tileItems->getEndDownItem()),
+			             std::make_reverse_iterator(tileItems->getBeginDownItem()));
+			items.insert(items.end(), tileItems->getBeginTopItem(), tileItems->getEndTopItem());
+		}
+
+		stream.write(OTBM_Destination_coords{pos.x, pos.y, pos.z});
+		stream.write(kind);
+		stream.write(zoneFlags);
+		stream.write<uint16_t>(items.size());
+		if (kind == SNAPSHOT_TILE_HOUSE) {
+			stream.write<uint32_t>(static_cast<const HouseTile*>(tile)->getHouse()->getId());
+		}
+
+		for (const Item* item : items) {
+			stream.write<uint8_t>(item->isLoadedFromMap());
+			writeSnapshotItem(stream, item);
+		}
+	}
+
+	// written aside and renamed, so a server stopped halfway never finds a truncated snapshot
+	std::filesystem::path tmpFileName = snapshotFileName;
+	tmpFileName += ".tmp";
+	{
+		std::string_view data = stream.getStream();
+		std::ofstream file{tmpFileName, std::ios::binary | std::ios::trunc};
+		if (!file.write(data.data(), data.size())) {
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmpFileName, snapshotFileName, ec);
+	return !ec;
+}
+
+IOMap::TileArea::~TileArea()
+{
+	// left over when loading stopped before the area was added to the map
+	for (Item* item : items) {
+		delete item;
+	}
+}
+
 bool IOMap::loadMap(Map* map, const std::filesystem::path& fileName)
 {
+	using namespace std::chrono;
+
 	int64_t start = OTSYS_TIME();
+	int64_t headerTime = 0, tileAreasTime = 0, addTilesTime = 0, townsTime = 0;
+	int64_t parseTime = 0;
+	size_t tileAreaCount = 0;
+
+	const size_t threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	// tile areas are parsed by workers and added to the map in file order by this thread,
+	// with at most a few areas per worker waiting so the parsed items do not pile up
+	const size_t maxPendingAreas = threadCount * 4;
+
+	std::mutex areasLock;
+	std::condition_variable areasSignal;
+	std::deque<TileArea*> areasToParse;
+	std::deque<std::unique_ptr<TileArea>> pendingAreas;
+	bool stopWorkers = false;
+
+	// the map is built from a snapshot instead of the OTBM while the map and items files are unchanged
+	std::filesystem::path snapshotFileName;
+	std::vector<SourceStamp> sourceStamps;
+	if (getBoolean(ConfigManager::MAP_SNAPSHOT)) {
+		try {
+			sourceStamps = getSourceStamps(fileName);
+			snapshotFileName = fileName;
+			snapshotFileName += ".snapshot";
+		} catch (const std::filesystem::filesystem_error& e) {
+			std::cout << "[Warning - IOMap::loadMap] Map snapshot disabled: " << e.what() << std::endl;
+		}
+	}
+
+	if (!snapshotFileName.empty() && isSnapshotUpToDate(snapshotFileName, sourceStamps)) {
+		std::cout << "> Loading map snapshot " << snapshotFileName.string() << std::endl;
+		try {
+			if (!loadSnapshot(*map, snapshotFileName)) {
+				return false;
+			}
+		} catch (const std::exception& e) {
+			setLastErrorString(e.what());
+			return false;
+		}
+
+		std::cout << "> Map loading time: " << (OTSYS_TIME() - start) / (1000.) << " seconds." << std::endl;
+		return true;
+	}
+
+	// the positions of the tiles added to the map, for the snapshot written after loading
+	std::vector<Position> addedTiles;
+
+	auto addNextTileArea = [&]() {
+		std::unique_ptr<TileArea> area;
+		{
+			std::unique_lock<std::mutex> lockGuard(areasLock);
+			areasSignal.wait(lockGuard, [&]() { return pendingAreas.front()->done; });
+			area = std::move(pendingAreas.front());
+			pendingAreas.pop_front();
+		}
+
+		parseTime += area->parseTime;
+
+		int64_t addStart = OTSYS_TIME();
+		bool ok = addTileArea(*area, *map, snapshotFileName.empty() ? nullptr : &addedTiles);
+		addTilesTime += OTSYS_TIME() - addStart;
+		return ok;
+	};
+
 	try {
 		OTB::Loader loader{fileName.string(), OTB::Identifier{{'O', 'T', 'B', 'M'}}};
-		auto& root = loader.parseTree();
+
+		TileAreaWorkers workers{[&]() {
+			{
+				std::lock_guard<std::mutex> lockGuard(areasLock);
+				stopWorkers = true;
+			}
+			areasSignal.notify_all();
+		}};
+
+		auto& root = loader.parseRoot();
 
 		PropStream propStream;
 		if (!loader.getProps(root, propStream)) {
@@ -90,14 +617,14 @@ bool IOMap::loadMap(Map* map, const std::filesystem::path& fileName)
 			return false;
 		}
 
-		if (root_header.majorVersionItems > Item::items.majorVersion) {
-			setLastErrorString(
-			    "The map was saved with a different items.otb version, an upgraded items.otb is required.");
+		if (root_header.minorVersionItems < CLIENT_VERSION_810) {
+			setLastErrorString("This map needs to be updated.");
 			return false;
 		}
 
-		if (root_header.minorVersionItems < CLIENT_VERSION_810) {
-			setLastErrorString("This map needs to be updated.");
+		if (root_header.majorVersionItems > Item::items.majorVersion) {
+			setLastErrorString(
+			    "The map was saved with a different items.otb version, an upgraded items.otb is required.");
 			return false;
 		}
 
@@ -109,22 +636,65 @@ bool IOMap::loadMap(Map* map, const std::filesystem::path& fileName)
 		map->width = root_header.width;
 		map->height = root_header.height;
 
-		if (root.children.size() != 1 || root.children[0].type != OTBM_MAP_DATA) {
+		OTB::ChildCursor rootCursor{loader, root};
+		OTB::Node mapNode;
+		if (!rootCursor.next(mapNode) || mapNode.type != OTBM_MAP_DATA) {
 			setLastErrorString("Could not read data node.");
 			return false;
 		}
 
-		auto& mapNode = root.children[0];
 		if (!parseMapDataAttributes(loader, mapNode, *map, fileName)) {
 			return false;
 		}
 
-		for (auto& mapDataNode : mapNode.children) {
+		headerTime = OTSYS_TIME() - start;
+		int64_t tileAreasStart = OTSYS_TIME();
+
+		workers.start(threadCount, [&]() {
+			std::unique_lock<std::mutex> lockGuard(areasLock);
+			while (true) {
+				areasSignal.wait(lockGuard, [&]() { return stopWorkers || !areasToParse.empty(); });
+				if (stopWorkers) {
+					return;
+				}
+
+				TileArea* area = areasToParse.front();
+				areasToParse.pop_front();
+
+				lockGuard.unlock();
+				auto parseStart = steady_clock::now();
+				readTileArea(loader, *area);
+				area->parseTime = duration_cast<microseconds>(steady_clock::now() - parseStart).count();
+				lockGuard.lock();
+
+				area->done = true;
+				areasSignal.notify_all();
+			}
+		});
+
+		OTB::ChildCursor mapCursor{loader, mapNode};
+		OTB::Node mapDataNode;
+		while (mapCursor.next(mapDataNode)) {
 			if (mapDataNode.type == OTBM_TILE_AREA) {
-				if (!parseTileArea(loader, mapDataNode, *map)) {
+				if (pendingAreas.size() >= maxPendingAreas && !addNextTileArea()) {
 					return false;
 				}
-			} else if (mapDataNode.type == OTBM_TOWNS) {
+
+				auto area = std::make_unique<TileArea>();
+				area->node = mapDataNode;
+				{
+					std::lock_guard<std::mutex> lockGuard(areasLock);
+					areasToParse.push_back(area.get());
+					pendingAreas.push_back(std::move(area));
+				}
+				areasSignal.notify_one();
+				++tileAreaCount;
+				continue;
+			}
+
+			int64_t townsStart = OTSYS_TIME();
+			loader.parseChildren(mapDataNode);
+			if (mapDataNode.type == OTBM_TOWNS) {
 				if (!parseTowns(loader, mapDataNode, *map)) {
 					return false;
 				}
@@ -136,12 +706,37 @@ bool IOMap::loadMap(Map* map, const std::filesystem::path& fileName)
 				setLastErrorString("Unknown map node.");
 				return false;
 			}
+			townsTime += OTSYS_TIME() - townsStart;
+		}
+
+		while (!pendingAreas.empty()) {
+			if (!addNextTileArea()) {
+				return false;
+			}
+		}
+
+		workers.join();
+		tileAreasTime = OTSYS_TIME() - tileAreasStart - townsTime;
+
+		if (!snapshotFileName.empty()) {
+			int64_t snapshotStart = OTSYS_TIME();
+			if (writeSnapshot(*map, snapshotFileName, sourceStamps, addedTiles)) {
+				std::cout << "> Map snapshot written to " << snapshotFileName.string() << " in "
+				          << (OTSYS_TIME() - snapshotStart) / 1000. << "s." << std::endl;
+			} else {
+				std::cout << "[Warning - IOMap::loadMap] Could not write map snapshot " << snapshotFileName.string()
+				          << '.' << std::endl;
+			}
 		}
 	} catch (const OTB::InvalidOTBFormat& err) {
 		setLastErrorString(err.what());
 		return false;
 	}
 
+	std::cout << "> Map header: " << headerTime / 1000. << "s, tile areas: " << tileAreasTime / 1000. << "s ("
+	          << tileAreaCount << " areas, " << parseTime / 1000000. << "s parsing on " << threadCount << " threads, "
+	          << addTilesTime / 1000. << "s adding tiles), towns and waypoints: " << townsTime / 1000. << "s."
+	          << std::endl;
 	std::cout << "> Map loading time: " << (OTSYS_TIME() - start) / (1000.) << " seconds." << std::endl;
 	return true;
 }
@@ -197,17 +792,17 @@ bool IOMap::parseMapDataAttributes(OTB::Loader& loader, const OTB::Node& mapNode
 	return true;
 }
 
-bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Map& map)
+bool IOMap::readTileArea(OTB::Loader& loader, TileArea& area)
 {
 	PropStream propStream;
-	if (!loader.getProps(tileAreaNode, propStream)) {
-		setLastErrorString("Invalid map node.");
+	if (!loader.getProps(area.node, propStream)) {
+		area.error = "Invalid map node.";
 		return false;
 	}
 
 	OTBM_Destination_coords area_coord;
 	if (!propStream.read(area_coord)) {
-		setLastErrorString("Invalid map node.");
+		area.error = "Invalid map node.";
 		return false;
 	}
 
@@ -215,49 +810,47 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 	uint16_t base_y = area_coord.y;
 	uint16_t z = area_coord.z;
 
-	for (auto& tileNode : tileAreaNode.children) {
+	try {
+		loader.parseChildren(area.node);
+	} catch (const OTB::InvalidOTBFormat& err) {
+		area.error = err.what();
+		return false;
+	}
+
+	area.tiles.reserve(area.node.children.size());
+
+	for (auto& tileNode : area.node.children) {
 		if (tileNode.type != OTBM_TILE && tileNode.type != OTBM_HOUSETILE) {
-			setLastErrorString("Unknown tile node.");
+			area.error = "Unknown tile node.";
 			return false;
 		}
 
 		if (!loader.getProps(tileNode, propStream)) {
-			setLastErrorString("Could not read node data.");
+			area.error = "Could not read node data.";
 			return false;
 		}
 
 		OTBM_Tile_coords tile_coord;
 		if (!propStream.read(tile_coord)) {
-			setLastErrorString("Could not read tile position.");
+			area.error = "Could not read tile position.";
 			return false;
 		}
 
-		uint16_t x = base_x + tile_coord.x;
-		uint16_t y = base_y + tile_coord.y;
+		auto& tile = area.tiles.emplace_back();
+		tile.x = base_x + tile_coord.x;
+		tile.y = base_y + tile_coord.y;
+		tile.z = z;
+		tile.firstItem = area.items.size();
 
-		bool isHouseTile = false;
-		House* house = nullptr;
-		Tile* tile = nullptr;
-		Item* ground_item = nullptr;
-		uint32_t tileflags = TILESTATE_NONE;
+		uint16_t x = tile.x;
+		uint16_t y = tile.y;
 
 		if (tileNode.type == OTBM_HOUSETILE) {
-			uint32_t houseId;
-			if (!propStream.read<uint32_t>(houseId)) {
-				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not read house id.", x, y, z));
+			if (!propStream.read<uint32_t>(tile.houseId)) {
+				area.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not read house id.", x, y, z);
 				return false;
 			}
-
-			house = map.houses.addHouse(houseId);
-			if (!house) {
-				setLastErrorString(
-				    fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not create house id: {:d}", x, y, z, houseId));
-				return false;
-			}
-
-			tile = new HouseTile(x, y, z, house);
-			house->addTile(static_cast<HouseTile*>(tile));
-			isHouseTile = true;
+			tile.isHouseTile = true;
 		}
 
 		uint8_t attribute;
@@ -267,20 +860,20 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 				case OTBM_ATTR_TILE_FLAGS: {
 					uint32_t flags;
 					if (!propStream.read<uint32_t>(flags)) {
-						setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to read tile flags.", x, y, z));
+						area.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to read tile flags.", x, y, z);
 						return false;
 					}
 
 					if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
-						tileflags |= TILESTATE_PROTECTIONZONE;
+						tile.flags |= TILESTATE_PROTECTIONZONE;
 					} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
-						tileflags |= TILESTATE_NOPVPZONE;
+						tile.flags |= TILESTATE_NOPVPZONE;
 					} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
-						tileflags |= TILESTATE_PVPZONE;
+						tile.flags |= TILESTATE_PVPZONE;
 					}
 
 					if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
-						tileflags |= TILESTATE_NOLOGOUT;
+						tile.flags |= TILESTATE_NOLOGOUT;
 					}
 					break;
 				}
@@ -288,91 +881,109 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 				case OTBM_ATTR_ITEM: {
 					Item* item = Item::CreateItem(propStream);
 					if (!item) {
-						setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z));
+						area.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z);
 						return false;
 					}
 
-					if (isHouseTile && item->isMoveable()) {
-						std::cout << "[Warning - IOMap::loadMap] Moveable item with ID: " << item->getID()
-						          << ", in house: " << house->getId() << ", at position [x: " << x << ", y: " << y
-						          << ", z: " << z << "]." << std::endl;
-						delete item;
-					} else {
-						if (item->getItemCount() == 0) {
-							item->setItemCount(1);
-						}
-
-						if (tile) {
-							tile->internalAddThing(item);
-							item->startDecaying();
-							item->setLoadedFromMap(true);
-						} else if (item->isGroundTile()) {
-							delete ground_item;
-							ground_item = item;
-						} else {
-							tile = createTile(ground_item, item, x, y, z);
-							tile->internalAddThing(item);
-							item->startDecaying();
-							item->setLoadedFromMap(true);
-						}
-					}
+					area.items.push_back(item);
 					break;
 				}
 
 				default:
-					setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown tile attribute.", x, y, z));
+					area.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown tile attribute.", x, y, z);
 					return false;
 			}
 		}
 
 		for (auto& itemNode : tileNode.children) {
 			if (itemNode.type != OTBM_ITEM) {
-				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown node type.", x, y, z));
+				area.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Unknown node type.", x, y, z);
 				return false;
 			}
 
 			PropStream stream;
 			if (!loader.getProps(itemNode, stream)) {
-				setLastErrorString("Invalid item node.");
+				area.error = "Invalid item node.";
 				return false;
 			}
 
 			Item* item = Item::CreateItem(stream);
 			if (!item) {
-				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z));
+				area.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to create item.", x, y, z);
 				return false;
 			}
 
 			if (!item->unserializeItemNode(loader, itemNode, stream)) {
-				setLastErrorString(
-				    fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to load item {:d}.", x, y, z, item->getID()));
+				area.error = fmt::format("[x:{:d}, y:{:d}, z:{:d}] Failed to load item {:d}.", x, y, z, item->getID());
 				delete item;
 				return false;
 			}
 
-			if (isHouseTile && item->isMoveable()) {
+			area.items.push_back(item);
+		}
+
+		tile.lastItem = area.items.size();
+	}
+
+	// the node tree of this area is no longer needed
+	OTB::Node::ChildrenVector().swap(area.node.children);
+	return true;
+}
+
+bool IOMap::addTileArea(TileArea& area, Map& map, std::vector<Position>* addedTiles)
+{
+	if (!area.error.empty()) {
+		setLastErrorString(area.error);
+		return false;
+	}
+
+	for (const auto& pendingTile : area.tiles) {
+		uint16_t x = pendingTile.x;
+		uint16_t y = pendingTile.y;
+		uint8_t z = pendingTile.z;
+
+		House* house = nullptr;
+		Tile* tile = nullptr;
+		Item* ground_item = nullptr;
+
+		if (pendingTile.isHouseTile) {
+			house = map.houses.addHouse(pendingTile.houseId);
+			if (!house) {
+				setLastErrorString(fmt::format("[x:{:d}, y:{:d}, z:{:d}] Could not create house id: {:d}", x, y, z,
+				                               pendingTile.houseId));
+				return false;
+			}
+
+			tile = new HouseTile(x, y, z, house);
+			house->addTile(static_cast<HouseTile*>(tile));
+		}
+
+		for (size_t i = pendingTile.firstItem; i < pendingTile.lastItem; ++i) {
+			Item* item = std::exchange(area.items[i], nullptr);
+			if (house && item->isMoveable()) {
 				std::cout << "[Warning - IOMap::loadMap] Moveable item with ID: " << item->getID()
 				          << ", in house: " << house->getId() << ", at position [x: " << x << ", y: " << y
 				          << ", z: " << z << "]." << std::endl;
 				delete item;
-			} else {
-				if (item->getItemCount() == 0) {
-					item->setItemCount(1);
-				}
+				continue;
+			}
 
-				if (tile) {
-					tile->internalAddThing(item);
-					item->startDecaying();
-					item->setLoadedFromMap(true);
-				} else if (item->isGroundTile()) {
-					delete ground_item;
-					ground_item = item;
-				} else {
-					tile = createTile(ground_item, item, x, y, z);
-					tile->internalAddThing(item);
-					item->startDecaying();
-					item->setLoadedFromMap(true);
-				}
+			if (item->getItemCount() == 0) {
+				item->setItemCount(1);
+			}
+
+			if (tile) {
+				tile->internalAddThing(item);
+				item->startDecaying();
+				item->setLoadedFromMap(true);
+			} else if (item->isGroundTile()) {
+				delete ground_item;
+				ground_item = item;
+			} else {
+				tile = createTile(ground_item, item, x, y, z);
+				tile->internalAddThing(item);
+				item->startDecaying();
+				item->setLoadedFromMap(true);
 			}
 		}
 
@@ -380,10 +991,15 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 			tile = createTile(ground_item, nullptr, x, y, z);
 		}
 
-		tile->setFlag(static_cast<tileflags_t>(tileflags));
+		tile->setFlag(static_cast<tileflags_t>(pendingTile.flags));
 
 		map.setTile(x, y, z, tile);
+		if (addedTiles) {
+			addedTiles->emplace_back(x, y, z);
+		}
 	}
+
+	area.items.clear();
 	return true;
 }
 
@@ -131,11 +131,56 @@ public:
 	void setLastErrorString(std::string error) { errorString = error; }
 
 private:
+	// size and modification time of a file the map is built from, a snapshot is only used while all of them match
+	struct SourceStamp
+	{
+		std::string fileName;
+		uint64_t size = 0;
+		int64_t modified = 0;
+
+		bool operator==(const SourceStamp&) const = default;
+	};
+
+	static std::vector<SourceStamp> getSourceStamps(const std::filesystem::path& fileName);
+	static bool isSnapshotUpToDate(const std::filesystem::path& snapshotFileName,
+	                               const std::vector<SourceStamp>& sourceStamps);
+
+	// a tile area read by a worker thread, its items are added to the map in file order
+	struct TileArea
+	{
+		struct PendingTile
+		{
+			uint32_t houseId = 0;
+			uint32_t flags = TILESTATE_NONE;
+			size_t firstItem = 0;
+			size_t lastItem = 0;
+			uint16_t x = 0;
+			uint16_t y = 0;
+			uint8_t z = 0;
+			bool isHouseTile = false;
+		};
+
+		~TileArea();
+
+		OTB::Node node;
+		std::vector<PendingTile> tiles;
+		std::vector<Item*> items;
+		std::string error;
+		int64_t parseTime = 0; // microseconds
+		bool done = false;
+	};
+
 	bool parseMapDataAttributes(OTB::Loader& loader, const OTB::Node& mapNode, Map& map,
 	                            const std::filesystem::path& fileName);
 	bool parseWaypoints(OTB::Loader& loader, const OTB::Node& waypointsNode, Map& map);
 	bool parseTowns(OTB::Loader& loader, const OTB::Node& townsNode, Map& map);
-	bool parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Map& map);
+	static bool readTileArea(OTB::Loader& loader, TileArea& area);
+	bool addTileArea(TileArea& area, Map& map, std::vector<Position>* addedTiles);
+
+	// a snapshot holds the map as it was built by a load from the OTBM, tiles and items included
+	bool loadSnapshot(Map& map, const std::filesystem::path& snapshotFileName);
+	static bool writeSnapshot(const Map& map, const std::filesystem::path& snapshotFileName,
+	                          const std::vector<SourceStamp>& sourceStamps, std::vector<Position>& tiles);
 	std::string errorString;
 };
 
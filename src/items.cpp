@@ -254,7 +254,7 @@ void Items::clear()
 bool Items::reload()
 {
 	clear();
-	loadFromOtb("data/items/items.otb");
+	loadFromOtb(otbFileName);
 
 	if (!loadFromXml()) {
 		return false;
@@ -270,6 +270,8 @@ constexpr auto OTBI = OTB::Identifier{{'O', 'T', 'B', 'I'}};
 
 bool Items::loadFromOtb(const std::string& file)
 {
+	otbFileName = file;
+
 	OTB::Loader loader{file, OTBI};
 
 	auto& root = loader.parseTree();
@@ -513,9 +515,9 @@ bool Items::loadFromOtb(const std::string& file)
 bool Items::loadFromXml()
 {
 	pugi::xml_document doc;
-	pugi::xml_parse_result result = doc.load_file("data/items/items.xml");
+	pugi::xml_parse_result result = doc.load_file(xmlFileName.c_str());
 	if (!result) {
-		printXMLError("Error - Items::loadFromXml", "data/items/items.xml", result);
+		printXMLError("Error - Items::loadFromXml", xmlFileName, result);
 		return false;
 	}
 
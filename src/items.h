@@ -376,6 +376,10 @@ public:
 
 	bool loadFromOtb(const std::string& file);
 
+	// the files the item types were read from, a map snapshot is only used while they are unchanged
+	const std::string& getOtbFileName() const { return otbFileName; }
+	const std::string& getXmlFileName() const { return xmlFileName; }
+
 	const ItemType& operator[](size_t id) const { return getItemType(id); }
 	const ItemType& getItemType(size_t id) const;
 	ItemType& getItemType(size_t id);
@@ -398,6 +402,8 @@ public:
 private:
 	std::vector<ItemType> items;
 	InventoryVector inventory;
+	std::string otbFileName;
+	std::string xmlFileName = "data/items/items.xml";
 	class ClientIdToServerIdMap
 	{
 	public:
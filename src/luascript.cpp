@@ -15,6 +15,7 @@
 #include "game.h"
 #include "globalevent.h"
 #include "housetile.h"
+#include "http/http.h"
 #include "inbox.h"
 #include "iologindata.h"
 #include "iomapserialize.h"
@@ -296,6 +297,15 @@ void pushSharedPtr(lua_State* L, T value)
 	new (lua_newuserdata(L, sizeof(T))) T(std::move(value));
 }
 
+// Queries a script gives the same key, e.g. a player guid, run one at a time in the order they were issued.
+uint64_t getScriptOrderKey(lua_State* L, int32_t arg, DatabaseTaskOrder_t keylessOrder)
+{
+	if (isNumber(L, arg)) {
+		return getDatabaseOrderKey(DATABASE_ORDER_SCRIPT_KEY, tfs::lua::getNumber<uint32_t>(L, arg));
+	}
+	return getDatabaseOrderKey(keylessOrder);
+}
+
 } // namespace
 
 ScriptEnvironment::ScriptEnvironment() { resetEnv(); }
@@ -2306,6 +2316,12 @@ void LuaScriptInterface::registerFunctions()
 
 	registerMethod(L, "Game", "getClientVersion", LuaScriptInterface::luaGameGetClientVersion);
 
+	registerMethod(L, "Game", "getSpectatorCacheStats", LuaScriptInterface::luaGameGetSpectatorCacheStats);
+	registerMethod(L, "Game", "getFlowFieldStats", LuaScriptInterface::luaGameGetFlowFieldStats);
+	registerMethod(L, "Game", "getHttpRequestStats", LuaScriptInterface::luaGameGetHttpRequestStats);
+	registerMethod(L, "Game", "getSchedulerStats", LuaScriptInterface::luaGameGetSchedulerStats);
+	registerMethod(L, "Game", "getDispatcherStats", LuaScriptInterface::luaGameGetDispatcherStats);
+
 	registerMethod(L, "Game", "reload", LuaScriptInterface::luaGameReload);
 
 	// Variant
@@ -4036,6 +4052,7 @@ const luaL_Reg LuaScriptInterface::luaDatabaseTable[] = {
     {"escapeBlob", LuaScriptInterface::luaDatabaseEscapeBlob},
     {"lastInsertId", LuaScriptInterface::luaDatabaseLastInsertId},
     {"tableExists", LuaScriptInterface::luaDatabaseTableExists},
+    {"getTaskStats", LuaScriptInterface::luaDatabaseGetTaskStats},
     {nullptr, nullptr}};
 
 int LuaScriptInterface::luaDatabaseExecute(lua_State* L)
@@ -4047,9 +4064,10 @@ int LuaScriptInterface::luaDatabaseExecute(lua_State* L)
 
 int LuaScriptInterface::luaDatabaseAsyncExecute(lua_State* L)
 {
-	// db.asyncQuery(query, callback)
+	// db.asyncQuery(query[, callback[, orderKey]])
 	std::function<void(const DBResult_ptr&, bool)> callback;
-	if (lua_gettop(L) > 1) {
+	if (lua_isfunction(L, 2)) {
+		lua_pushvalue(L, 2);
 		int32_t ref = luaL_ref(L, LUA_REGISTRYINDEX);
 		auto scriptId = tfs::lua::getScriptEnv()->getScriptId();
 		callback = [ref, scriptId](const DBResult_ptr&, bool success) {
@@ -4072,7 +4090,9 @@ int LuaScriptInterface::luaDatabaseAsyncExecute(lua_State* L)
 			luaL_unref(L, LUA_REGISTRYINDEX, ref);
 		};
 	}
-	g_databaseTasks.addTask(tfs::lua::getString(L, -1), callback);
+	// writes without a key stay in the order they were issued
+	g_databaseTasks.addTask(tfs::lua::getString(L, 1), callback, false,
+	                        getScriptOrderKey(L, 3, DATABASE_ORDER_SCRIPT));
 	return 0;
 }
 
@@ -4089,9 +4109,10 @@ int LuaScriptInterface::luaDatabaseStoreQuery(lua_State* L)
 
 int LuaScriptInterface::luaDatabaseAsyncStoreQuery(lua_State* L)
 {
-	// db.asyncStoreQuery(query, callback)
+	// db.asyncStoreQuery(query[, callback[, orderKey]])
 	std::function<void(const DBResult_ptr&, bool)> callback;
-	if (lua_gettop(L) > 1) {
+	if (lua_isfunction(L, 2)) {
+		lua_pushvalue(L, 2);
 		int32_t ref = luaL_ref(L, LUA_REGISTRYINDEX);
 		auto scriptId = tfs::lua::getScriptEnv()->getScriptId();
 		callback = [ref, scriptId](const DBResult_ptr& result, bool) {
@@ -4118,7 +4139,9 @@ int LuaScriptInterface::luaDatabaseAsyncStoreQuery(lua_State* L)
 			luaL_unref(L, LUA_REGISTRYINDEX, ref);
 		};
 	}
-	g_databaseTasks.addTask(tfs::lua::getString(L, -1), callback, true);
+	// reads without a key do not wait behind the writes, a read that has to see a write is given the same key
+	g_databaseTasks.addTask(tfs::lua::getString(L, 1), callback, true,
+	                        getScriptOrderKey(L, 3, DATABASE_ORDER_SCRIPT_READ));
 	return 0;
 }
 
@@ -4151,6 +4174,21 @@ int LuaScriptInterface::luaDatabaseTableExists(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaDatabaseGetTaskStats(lua_State* L)
+{
+	// db.getTaskStats()
+	DatabaseTaskStats stats = g_databaseTasks.getStats();
+	lua_createtable(L, 0, 7);
+	setField(L, "completed", stats.completed);
+	setField(L, "queued", stats.queued);
+	setField(L, "maxQueued", stats.maxQueued);
+	setField(L, "totalWaitTime", stats.totalWaitTime);
+	setField(L, "maxWaitTime", stats.maxWaitTime);
+	setField(L, "totalRunTime", stats.totalRunTime);
+	setField(L, "maxRunTime", stats.maxRunTime);
+	return 1;
+}
+
 const luaL_Reg LuaScriptInterface::luaResultTable[] = {
     {"getNumber", LuaScriptInterface::luaResultGetNumber}, {"getString", LuaScriptInterface::luaResultGetString},
     {"getStream", LuaScriptInterface::luaResultGetStream}, {"next", LuaScriptInterface::luaResultNext},
@@ -4933,6 +4971,73 @@ int LuaScriptInterface::luaGameGetClientVersion(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaGameGetSpectatorCacheStats(lua_State* L)
+{
+	// Game.getSpectatorCacheStats()
+	const SpectatorCacheStats& stats = g_game.map.getSpectatorCacheStats();
+	lua_createtable(L, 0, 3);
+	setField(L, "hits", stats.hits);
+	setField(L, "misses", stats.misses);
+	setField(L, "invalidations", stats.invalidations);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetFlowFieldStats(lua_State* L)
+{
+	// Game.getFlowFieldStats()
+	const FlowFieldStats& stats = g_game.map.getFlowFieldStats();
+	lua_createtable(L, 0, 4);
+	setField(L, "builds", stats.builds);
+	setField(L, "reads", stats.reads);
+	setField(L, "misses", stats.misses);
+	setField(L, "invalidations", stats.invalidations);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetHttpRequestStats(lua_State* L)
+{
+	// Game.getHttpRequestStats()
+	auto stats = tfs::http::get_request_stats();
+	lua_createtable(L, 0, stats.size());
+	for (const auto& requestStats : stats) {
+		lua_createtable(L, 0, 3);
+		setField(L, "count", requestStats.count);
+		setField(L, "time", requestStats.time);
+
+		lua_createtable(L, requestStats.buckets.size(), 0);
+		for (size_t i = 0; i < requestStats.buckets.size(); ++i) {
+			lua_pushnumber(L, requestStats.buckets[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+		lua_setfield(L, -2, "buckets");
+
+		lua_setfield(L, -2, std::string{requestStats.type}.c_str());
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetSchedulerStats(lua_State* L)
+{
+	// Game.getSchedulerStats()
+	lua_createtable(L, 0, 4);
+	setField(L, "pendingEvents", g_scheduler.getPendingEvents());
+	setField(L, "expiredEvents", g_scheduler.getExpiredEvents());
+	setField(L, "totalLateness", g_scheduler.getTotalLateness());
+	setField(L, "maxLateness", g_scheduler.getMaxLateness());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetDispatcherStats(lua_State* L)
+{
+	// Game.getDispatcherStats()
+	lua_createtable(L, 0, 4);
+	setField(L, "cycle", g_dispatcher.getDispatcherCycle());
+	setField(L, "queueSize", g_dispatcher.getTaskQueueSize());
+	setField(L, "lastCycleTime", g_dispatcher.getLastCycleTime());
+	setField(L, "maxCycleTime", g_dispatcher.getMaxCycleTime());
+	return 1;
+}
+
 int LuaScriptInterface::luaGameReload(lua_State* L)
 {
 	// Game.reload(reloadType)
@@ -152,7 +152,7 @@ public:
 	static const luaL_Reg luaBitReg[7];
 #endif
 	static const luaL_Reg luaConfigManagerTable[4];
-	static const luaL_Reg luaDatabaseTable[9];
+	static const luaL_Reg luaDatabaseTable[10];
 	static const luaL_Reg luaResultTable[6];
 
 	//
@@ -236,6 +236,7 @@ private:
 	static int luaDatabaseEscapeBlob(lua_State* L);
 	static int luaDatabaseLastInsertId(lua_State* L);
 	static int luaDatabaseTableExists(lua_State* L);
+	static int luaDatabaseGetTaskStats(lua_State* L);
 
 	static int luaResultGetNumber(lua_State* L);
 	static int luaResultGetString(lua_State* L);
@@ -312,6 +313,12 @@ private:
 
 	static int luaGameGetClientVersion(lua_State* L);
 
+	static int luaGameGetSpectatorCacheStats(lua_State* L);
+	static int luaGameGetFlowFieldStats(lua_State* L);
+	static int luaGameGetHttpRequestStats(lua_State* L);
+	static int luaGameGetSchedulerStats(lua_State* L);
+	static int luaGameGetDispatcherStats(lua_State* L);
+
 	static int luaGameReload(lua_State* L);
 
 	// Variant
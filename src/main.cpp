@@ -26,6 +26,7 @@
 #include <client/localplayer.h>
 #include <framework/core/application.h>
 #include <framework/core/resourcemanager.h>
+#include <framework/graphics/drawpoolmanager.h>
 #include <framework/luaengine/luainterface.h>
 
 #ifndef ANDROID
@@ -38,6 +39,10 @@
 #include <framework/net/protocolhttp.h>
 #endif
 
+#ifdef CLIENT_CHECKS
+#include <client/clientchecks.h>
+#endif
+
 #ifdef ANDROID
 extern "C" {
 #endif
@@ -98,6 +103,13 @@ extern "C" {
 #endif
 #endif
 
+#ifdef CLIENT_CHECKS
+        // the checks run on the null render backend, it is chosen before the application creates the draw pools
+        const bool runCheck = ClientChecks::requested(args);
+        if (runCheck)
+            g_drawPool.setNullBackend(true);
+#endif
+
         // initialize application framework and otclient
         g_app.init(args, new GraphicalApplicationContext(g_gameConfig.getSpriteSize(), ApplicationDrawEventsPtr(&g_client)));
         g_client.init(args);
@@ -105,9 +117,16 @@ extern "C" {
         g_http.init();
 #endif
 
-        if (!g_lua.safeRunScript("init.lua"))
+        // the modules need the window, the checks on the null render backend need none of them
+        if (!g_drawPool.isNullBackend() && !g_lua.safeRunScript("init.lua"))
             g_logger.fatal("Unable to run script init.lua!");
 
+        int exitCode = 0;
+#ifdef CLIENT_CHECKS
+        if (runCheck)
+            exitCode = ClientChecks::run(args);
+        else
+#endif
         // the run application main loop
         g_app.run();
 
@@ -120,7 +139,7 @@ extern "C" {
 #ifdef FRAMEWORK_NET
         g_http.terminate();
 #endif
-        return 0;
+        return exitCode;
     }
 #ifdef ANDROID
 }
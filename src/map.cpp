@@ -6,6 +6,7 @@
 #include "map.h"
 
 #include "combat.h"
+#include "configmanager.h"
 #include "creature.h"
 #include "game.h"
 #include "iomap.h"
@@ -13,6 +14,8 @@
 #include "monster.h"
 #include "spectators.h"
 
+#include <queue>
+
 extern Game g_game;
 
 bool Map::loadMap(const std::string& identifier, bool loadHouses)
@@ -80,6 +83,57 @@ Tile* Map::getTile(uint16_t x, uint16_t y, uint8_t z) const
 	return floor->tiles[x & FLOOR_MASK][y & FLOOR_MASK];
 }
 
+void Map::getFloorTiles(int32_t x, int32_t y, uint8_t z, int32_t width, int32_t height, Tile** tiles) const
+{
+	std::fill_n(tiles, width * height, nullptr);
+	if (z >= MAP_MAX_LAYERS) {
+		return;
+	}
+
+	int32_t startx = std::max<int32_t>(x, 0);
+	int32_t starty = std::max<int32_t>(y, 0);
+	int32_t endx = std::min<int32_t>(x + width, 0x10000);
+	int32_t endy = std::min<int32_t>(y + height, 0x10000);
+	if (startx >= endx || starty >= endy) {
+		return;
+	}
+
+	int32_t startx1 = startx & ~FLOOR_MASK;
+	int32_t starty1 = starty & ~FLOOR_MASK;
+
+	const QTreeLeafNode* leafS =
+	    QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, starty1);
+	const QTreeLeafNode* leafE;
+
+	for (int32_t ny = starty1; ny < endy; ny += FLOOR_SIZE) {
+		leafE = leafS;
+		for (int32_t nx = startx1; nx < endx; nx += FLOOR_SIZE) {
+			if (leafE) {
+				if (const Floor* floor = leafE->getFloor(z)) {
+					// the part of this 8x8 block inside the area
+					int32_t blockEndX = std::min<int32_t>(nx + FLOOR_SIZE, endx);
+					int32_t blockEndY = std::min<int32_t>(ny + FLOOR_SIZE, endy);
+					for (int32_t tx = std::max<int32_t>(nx, startx); tx < blockEndX; ++tx) {
+						Tile** column = tiles + (tx - x) * height;
+						for (int32_t ty = std::max<int32_t>(ny, starty); ty < blockEndY; ++ty) {
+							column[ty - y] = floor->tiles[tx & FLOOR_MASK][ty & FLOOR_MASK];
+						}
+					}
+				}
+				leafE = leafE->leafE;
+			} else if (nx + FLOOR_SIZE < endx) {
+				leafE = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, nx + FLOOR_SIZE, ny);
+			}
+		}
+
+		if (leafS) {
+			leafS = leafS->leafS;
+		} else if (ny + FLOOR_SIZE < endy) {
+			leafS = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, ny + FLOOR_SIZE);
+		}
+	}
+}
+
 void Map::setTile(uint16_t x, uint16_t y, uint8_t z, Tile* newTile)
 {
 	if (z >= MAP_MAX_LAYERS) {
@@ -389,6 +443,48 @@ void Map::getSpectatorsInternal(SpectatorVec& spectators, const Position& center
 	}
 }
 
+namespace {
+
+// largest floor difference a multifloor spectator scan can span (surface centers see floors 0-7/8/9)
+constexpr int32_t maxSpectatorOffsetZ = 7;
+
+void getSpectatorRangeZ(const Position& centerPos, bool multifloor, int32_t& minRangeZ, int32_t& maxRangeZ)
+{
+	if (!multifloor) {
+		minRangeZ = centerPos.z;
+		maxRangeZ = centerPos.z;
+	} else if (centerPos.z > 7) {
+		// underground (8->15)
+		minRangeZ = std::max(centerPos.getZ() - 2, 0);
+		maxRangeZ = std::min(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
+	} else if (centerPos.z == 6) {
+		minRangeZ = 0;
+		maxRangeZ = 8;
+	} else if (centerPos.z == 7) {
+		minRangeZ = 0;
+		maxRangeZ = 9;
+	} else {
+		minRangeZ = 0;
+		maxRangeZ = 7;
+	}
+}
+
+// whether a cached (full viewport, multifloor) spectator list centered at centerPos may contain a creature at pos
+bool isInSpectatorCacheRange(const Position& centerPos, const Position& pos)
+{
+	int32_t minRangeZ, maxRangeZ;
+	getSpectatorRangeZ(centerPos, true, minRangeZ, maxRangeZ);
+	if (pos.z < minRangeZ || pos.z > maxRangeZ) {
+		return false;
+	}
+
+	int32_t offsetZ = centerPos.getOffsetZ(pos);
+	return pos.x >= centerPos.x - Map::maxViewportX + offsetZ && pos.x <= centerPos.x + Map::maxViewportX + offsetZ &&
+	       pos.y >= centerPos.y - Map::maxViewportY + offsetZ && pos.y <= centerPos.y + Map::maxViewportY + offsetZ;
+}
+
+} // namespace
+
 void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, bool multifloor /*= false*/,
                         bool onlyPlayers /*= false*/, int32_t minRangeX /*= 0*/, int32_t maxRangeX /*= 0*/,
                         int32_t minRangeY /*= 0*/, int32_t maxRangeY /*= 0*/)
@@ -398,7 +494,7 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 	}
 
 	bool foundCache = false;
-	bool cacheResult = false;
+	QTreeLeafNode* cacheLeaf = nullptr;
 
 	minRangeX = (minRangeX == 0 ? -maxViewportX : -minRangeX);
 	maxRangeX = (maxRangeX == 0 ? maxViewportX : maxRangeX);
@@ -407,9 +503,13 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 
 	if (minRangeX == -maxViewportX && maxRangeX == maxViewportX && minRangeY == -maxViewportY &&
 	    maxRangeY == maxViewportY && multifloor) {
+		cacheLeaf = getQTNode(centerPos.x, centerPos.y);
+	}
+
+	if (cacheLeaf) {
 		if (onlyPlayers) {
-			auto it = playersSpectatorCache.find(centerPos);
-			if (it != playersSpectatorCache.end()) {
+			auto it = cacheLeaf->playersSpectatorCache.find(centerPos);
+			if (it != cacheLeaf->playersSpectatorCache.end()) {
 				if (!spectators.empty()) {
 					spectators.addSpectators(it->second);
 				} else {
@@ -421,8 +521,8 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 		}
 
 		if (!foundCache) {
-			auto it = spectatorCache.find(centerPos);
-			if (it != spectatorCache.end()) {
+			auto it = cacheLeaf->spectatorCache.find(centerPos);
+			if (it != cacheLeaf->spectatorCache.end()) {
 				if (!onlyPlayers) {
 					if (!spectators.empty()) {
 						const SpectatorVec& cachedSpectators = it->second;
@@ -440,52 +540,76 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 				}
 
 				foundCache = true;
-			} else {
-				cacheResult = true;
 			}
 		}
+
+		if (foundCache) {
+			++spectatorCacheStats.hits;
+		} else {
+			++spectatorCacheStats.misses;
+		}
 	}
 
 	if (!foundCache) {
 		int32_t minRangeZ;
 		int32_t maxRangeZ;
-
-		if (multifloor) {
-			if (centerPos.z > 7) {
-				// underground (8->15)
-				minRangeZ = std::max(centerPos.getZ() - 2, 0);
-				maxRangeZ = std::min(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
-			} else if (centerPos.z == 6) {
-				minRangeZ = 0;
-				maxRangeZ = 8;
-			} else if (centerPos.z == 7) {
-				minRangeZ = 0;
-				maxRangeZ = 9;
-			} else {
-				minRangeZ = 0;
-				maxRangeZ = 7;
-			}
-		} else {
-			minRangeZ = centerPos.z;
-			maxRangeZ = centerPos.z;
-		}
+		getSpectatorRangeZ(centerPos, multifloor, minRangeZ, maxRangeZ);
 
 		getSpectatorsInternal(spectators, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY, minRangeZ, maxRangeZ,
 		                      onlyPlayers);
 
-		if (cacheResult) {
+		if (cacheLeaf) {
 			if (onlyPlayers) {
-				playersSpectatorCache[centerPos] = spectators;
+				cacheLeaf->playersSpectatorCache[centerPos] = spectators;
 			} else {
-				spectatorCache[centerPos] = spectators;
+				cacheLeaf->spectatorCache[centerPos] = spectators;
 			}
 		}
 	}
 }
 
-void Map::clearSpectatorCache() { spectatorCache.clear(); }
+void Map::clearSpectatorCache(const Position& pos) { clearSpectatorCacheInternal(pos, false); }
 
-void Map::clearPlayersSpectatorCache() { playersSpectatorCache.clear(); }
+void Map::clearPlayersSpectatorCache(const Position& pos) { clearSpectatorCacheInternal(pos, true); }
+
+void Map::clearSpectatorCacheInternal(const Position& pos, bool onlyPlayers)
+{
+	// only leaves holding a center whose viewport can reach pos need to be visited
+	int32_t x1 = std::max<int32_t>(0, pos.x - maxViewportX - maxSpectatorOffsetZ);
+	int32_t y1 = std::max<int32_t>(0, pos.y - maxViewportY - maxSpectatorOffsetZ);
+	int32_t x2 = std::min<int32_t>(0xFFFF, pos.x + maxViewportX + maxSpectatorOffsetZ);
+	int32_t y2 = std::min<int32_t>(0xFFFF, pos.y + maxViewportY + maxSpectatorOffsetZ);
+
+	int32_t startx1 = x1 - (x1 % FLOOR_SIZE);
+	int32_t starty1 = y1 - (y1 % FLOOR_SIZE);
+	int32_t endx2 = x2 - (x2 % FLOOR_SIZE);
+	int32_t endy2 = y2 - (y2 % FLOOR_SIZE);
+
+	QTreeLeafNode* leafS = QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, startx1, starty1);
+	QTreeLeafNode* leafE;
+
+	for (int_fast32_t ny = starty1; ny <= endy2; ny += FLOOR_SIZE) {
+		leafE = leafS;
+		for (int_fast32_t nx = startx1; nx <= endx2; nx += FLOOR_SIZE) {
+			if (leafE) {
+				SpectatorCache& cache = (onlyPlayers ? leafE->playersSpectatorCache : leafE->spectatorCache);
+				if (!cache.empty()) {
+					spectatorCacheStats.invalidations += std::erase_if(
+					    cache, [&pos](const auto& it) { return isInSpectatorCacheRange(it.first, pos); });
+				}
+				leafE = leafE->leafE;
+			} else {
+				leafE = QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, nx + FLOOR_SIZE, ny);
+			}
+		}
+
+		if (leafS) {
+			leafS = leafS->leafS;
+		} else {
+			leafS = QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, startx1, ny + FLOOR_SIZE);
+		}
+	}
+}
 
 bool Map::canThrowObjectTo(const Position& fromPos, const Position& toPos, bool checkLineOfSight /*= true*/,
                            bool sameFloor /*= false*/, int32_t rangex /*= Map::maxClientViewportX*/,
@@ -663,7 +787,8 @@ bool Map::getPathMatching(const Creature& creature, std::vector<Direction>& dirL
 	Position pos = creature.getPosition();
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y);
+	AStarNodes& nodes =
+	    AStarNodes::acquire(pos.x, pos.y, std::max(ConfigManager::getNumber(ConfigManager::PATHFINDING_MAX_NODES), 1));
 
 	int32_t bestMatch = 0;
 
@@ -827,76 +952,271 @@ bool Map::getPathMatching(const Creature& creature, std::vector<Direction>& dirL
 	return true;
 }
 
+bool Map::getFlowFieldPath(const Creature& creature, const Creature& target, std::vector<Direction>& dirList)
+{
+	const Position& targetPos = target.getPosition();
+	Position pos = creature.getPosition();
+	if (pos.z != targetPos.z) {
+		++flowFieldStats.misses;
+		return false;
+	}
+
+	FlowField& field = flowFields[target.getID()];
+	if (!field.isValidFor(targetPos)) {
+		const int32_t radius = std::max(ConfigManager::getNumber(ConfigManager::PATHFINDING_FLOW_FIELD_RADIUS), 1);
+		field.build(targetPos, radius, [this, z = targetPos.z](uint16_t x, uint16_t y) -> int32_t {
+			// only what a monster can never cross blocks the field, the rest is checked per step
+			const Tile* tile = getTile(x, y, z);
+			if (!tile || !tile->getGround() ||
+			    tile->hasFlag(TILESTATE_PROTECTIONZONE | (TILESTATE_FLOWFIELD & ~TILESTATE_MAGICFIELD))) {
+				return -1;
+			}
+			return tile->hasFlag(TILESTATE_MAGICFIELD) ? MAP_NORMALWALKCOST * 18 : 0;
+		});
+		++flowFieldStats.builds;
+	}
+
+	++flowFieldStats.reads;
+
+	int32_t cost = field.getCost(pos);
+	if (cost == FlowField::UNREACHABLE) {
+		++flowFieldStats.misses;
+		return false;
+	}
+
+	static constexpr int32_t neighbors[8][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+	// walk downhill until adjacent, stopping early where another creature is in the way
+	while (std::max(targetPos.getDistanceX(pos), targetPos.getDistanceY(pos)) > 1) {
+		Position bestPos;
+		int32_t bestCost = cost;
+		for (const auto& [dx, dy] : neighbors) {
+			Position nextPos(pos.x + dx, pos.y + dy, pos.z);
+			int32_t nextCost = field.getCost(nextPos);
+			if (nextCost < bestCost && canWalkTo(creature, nextPos)) {
+				bestPos = nextPos;
+				bestCost = nextCost;
+			}
+		}
+
+		if (bestCost == cost) {
+			break;
+		}
+
+		dirList.push_back(getDirectionTo(pos, bestPos));
+		pos = bestPos;
+		cost = bestCost;
+	}
+
+	if (dirList.empty() && std::max(targetPos.getDistanceX(pos), targetPos.getDistanceY(pos)) > 1) {
+		++flowFieldStats.misses;
+		return false;
+	}
+	return true;
+}
+
+void Map::clearFlowFields(const Position& pos)
+{
+	for (auto& it : flowFields) {
+		FlowField& field = it.second;
+		if (field.isValid() && field.covers(pos)) {
+			field.invalidate();
+			++flowFieldStats.invalidations;
+		}
+	}
+}
+
+// FlowField
+
+void FlowField::build(const Position& target, int32_t radius,
+                      const std::function<int32_t(uint16_t x, uint16_t y)>& tileCost)
+{
+	this->target = target;
+	this->radius = radius;
+	valid = true;
+
+	const int32_t side = radius * 2 + 1;
+	costs.assign(side * side, UNREACHABLE);
+
+	const int32_t originX = target.x - radius;
+	const int32_t originY = target.y - radius;
+
+	// per tile entry cost, computed at most once
+	static constexpr int32_t UNKNOWN = -2;
+	std::vector<int32_t> entryCosts(side * side, UNKNOWN);
+
+	using QueueEntry = std::pair<int32_t, int32_t>;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+
+	const int32_t start = radius * side + radius;
+	costs[start] = 0;
+	queue.emplace(0, start);
+
+	while (!queue.empty()) {
+		const auto [cost, index] = queue.top();
+		queue.pop();
+		if (cost > costs[index]) {
+			continue;
+		}
+
+		const int32_t x = index % side;
+		const int32_t y = index / side;
+
+		// followers step from a neighbor onto this tile, so it is this tile's cost they pay
+		int32_t enterCost = 0;
+		if (index != start) {
+			enterCost = entryCosts[index];
+		}
+
+		for (int32_t dy = -1; dy <= 1; ++dy) {
+			for (int32_t dx = -1; dx <= 1; ++dx) {
+				const int32_t nx = x + dx;
+				const int32_t ny = y + dy;
+				if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= side || ny >= side) {
+					continue;
+				}
+
+				const int32_t neighbor = ny * side + nx;
+				int32_t& neighborEntryCost = entryCosts[neighbor];
+				if (neighborEntryCost == UNKNOWN) {
+					const int32_t mapX = originX + nx;
+					const int32_t mapY = originY + ny;
+					if (mapX < 0 || mapY < 0 || mapX > std::numeric_limits<uint16_t>::max() ||
+					    mapY > std::numeric_limits<uint16_t>::max()) {
+						neighborEntryCost = -1;
+					} else {
+						neighborEntryCost = tileCost(mapX, mapY);
+					}
+				}
+
+				if (neighborEntryCost < 0) {
+					continue;
+				}
+
+				const int32_t newCost =
+				    cost + enterCost + (dx != 0 && dy != 0 ? MAP_DIAGONALWALKCOST : MAP_NORMALWALKCOST);
+				if (newCost < costs[neighbor]) {
+					costs[neighbor] = newCost;
+					queue.emplace(newCost, neighbor);
+				}
+			}
+		}
+	}
+}
+
+int32_t FlowField::getCost(const Position& pos) const
+{
+	if (!covers(pos)) {
+		return UNREACHABLE;
+	}
+
+	const int32_t side = radius * 2 + 1;
+	return costs[(pos.y - target.y + radius) * side + (pos.x - target.x + radius)];
+}
+
 // AStarNodes
 
-AStarNodes::AStarNodes(uint32_t x, uint32_t y) : nodes(), openNodes()
+AStarNodes& AStarNodes::acquire(uint32_t x, uint32_t y, size_t maxNodes)
 {
-	curNode = 1;
+	static thread_local AStarNodes instance;
+	instance.reset(x, y, maxNodes);
+	return instance;
+}
+
+void AStarNodes::reset(uint32_t x, uint32_t y, size_t maxNodes)
+{
+	if (nodes.size() != maxNodes) {
+		// nodes are linked through raw parent pointers, so the storage is sized once up front
+		nodes.resize(maxNodes);
+		heapPos.resize(maxNodes);
+		openHeap.reserve(maxNodes);
+
+		size_t tableSize = 1;
+		nodeTableShift = 32;
+		while (tableSize < maxNodes * 2) {
+			tableSize <<= 1;
+			--nodeTableShift;
+		}
+		nodeTable.assign(tableSize, NodeTableEntry{});
+		generation = 0;
+	}
+
+	// bumping the generation empties the node table without touching it
+	if (++generation == 0) {
+		std::fill(nodeTable.begin(), nodeTable.end(), NodeTableEntry{});
+		generation = 1;
+	}
+
+	openHeap.clear();
+	curNode = 0;
 	closedNodes = 0;
-	openNodes[0] = true;
-
-	AStarNode& startNode = nodes[0];
-	startNode.parent = nullptr;
-	startNode.x = x;
-	startNode.y = y;
-	startNode.f = 0;
-	nodeTable[(x << 16) | y] = nodes;
+	createOpenNode(nullptr, x, y, 0);
+}
+
+AStarNodes::NodeTableEntry& AStarNodes::findEntry(uint32_t key)
+{
+	// fibonacci hashing with linear probing, the table is kept at most half full
+	const size_t mask = nodeTable.size() - 1;
+	size_t i = nodeTableShift < 32 ? (key * 2654435769u) >> nodeTableShift : 0;
+	while (true) {
+		NodeTableEntry& entry = nodeTable[i];
+		if (entry.generation != generation || entry.key == key) {
+			return entry;
+		}
+		i = (i + 1) & mask;
+	}
 }
 
 AStarNode* AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f)
 {
-	if (curNode >= MAX_NODES) {
+	if (curNode >= nodes.size()) {
 		return nullptr;
 	}
 
-	size_t retNode = curNode++;
-	openNodes[retNode] = true;
+	uint32_t retNode = curNode++;
+
+	NodeTableEntry& entry = findEntry((x << 16) | y);
+	entry.key = (x << 16) | y;
+	entry.generation = generation;
+	entry.index = retNode;
 
-	AStarNode* node = nodes + retNode;
-	nodeTable[(x << 16) | y] = node;
+	AStarNode* node = &nodes[retNode];
 	node->parent = parent;
 	node->x = x;
 	node->y = y;
 	node->f = f;
+	pushOpen(retNode);
 	return node;
 }
 
 AStarNode* AStarNodes::getBestNode()
 {
-	if (curNode == 0) {
+	if (openHeap.empty()) {
 		return nullptr;
 	}
-
-	int32_t best_node_f = std::numeric_limits<int32_t>::max();
-	int32_t best_node = -1;
-	for (size_t i = 0; i < curNode; i++) {
-		if (openNodes[i] && nodes[i].f < best_node_f) {
-			best_node_f = nodes[i].f;
-			best_node = i;
-		}
-	}
-
-	if (best_node >= 0) {
-		return nodes + best_node;
-	}
-	return nullptr;
+	return &nodes[openHeap.front()];
 }
 
 void AStarNodes::closeNode(AStarNode* node)
 {
-	size_t index = node - nodes;
-	assert(index < MAX_NODES);
-	openNodes[index] = false;
+	size_t index = node - nodes.data();
+	assert(index < curNode);
+	if (heapPos[index] != -1) {
+		removeOpen(index);
+	}
 	++closedNodes;
 }
 
 void AStarNodes::openNode(AStarNode* node)
 {
-	size_t index = node - nodes;
-	assert(index < MAX_NODES);
-	if (!openNodes[index]) {
-		openNodes[index] = true;
+	size_t index = node - nodes.data();
+	assert(index < curNode);
+	if (heapPos[index] == -1) {
+		pushOpen(index);
 		--closedNodes;
+	} else {
+		// the cost of an open node can only go down
+		siftUp(heapPos[index]);
 	}
 }
 
@@ -904,11 +1224,78 @@ int_fast32_t AStarNodes::getClosedNodes() const { return closedNodes; }
 
 AStarNode* AStarNodes::getNodeByPosition(uint32_t x, uint32_t y)
 {
-	auto it = nodeTable.find((x << 16) | y);
-	if (it == nodeTable.end()) {
+	const NodeTableEntry& entry = findEntry((x << 16) | y);
+	if (entry.generation != generation) {
 		return nullptr;
 	}
-	return it->second;
+	return &nodes[entry.index];
+}
+
+void AStarNodes::pushOpen(uint32_t index)
+{
+	heapPos[index] = openHeap.size();
+	openHeap.push_back(index);
+	siftUp(openHeap.size() - 1);
+}
+
+void AStarNodes::removeOpen(uint32_t index)
+{
+	size_t pos = heapPos[index];
+	heapPos[index] = -1;
+
+	uint32_t last = openHeap.back();
+	openHeap.pop_back();
+	if (pos == openHeap.size()) {
+		return;
+	}
+
+	openHeap[pos] = last;
+	heapPos[last] = pos;
+	siftDown(pos);
+	siftUp(heapPos[last]);
+}
+
+void AStarNodes::siftUp(size_t pos)
+{
+	uint32_t index = openHeap[pos];
+	while (pos > 0) {
+		size_t parent = (pos - 1) / 2;
+		if (!isBetter(index, openHeap[parent])) {
+			break;
+		}
+
+		openHeap[pos] = openHeap[parent];
+		heapPos[openHeap[pos]] = pos;
+		pos = parent;
+	}
+	openHeap[pos] = index;
+	heapPos[index] = pos;
+}
+
+void AStarNodes::siftDown(size_t pos)
+{
+	uint32_t index = openHeap[pos];
+	const size_t size = openHeap.size();
+	while (true) {
+		size_t child = pos * 2 + 1;
+		if (child >= size) {
+			break;
+		}
+
+		if (child + 1 < size && isBetter(openHeap[child + 1], openHeap[child])) {
+			++child;
+		}
+
+		if (!isBetter(openHeap[child], index)) {
+			break;
+		}
+
+		openHeap[pos] = openHeap[child];
+		heapPos[openHeap[pos]] = pos;
+		pos = child;
+	}
+	openHeap[pos] = index;
+	heapPos[index] = pos;
 }
 
 int_fast32_t AStarNodes::getMapWalkCost(AStarNode* node, const Position& neighborPos)
@@ -22,15 +22,18 @@ struct AStarNode
 	uint16_t x, y;
 };
 
-static constexpr int32_t MAX_NODES = 512;
-
 static constexpr int32_t MAP_NORMALWALKCOST = 10;
 static constexpr int32_t MAP_DIAGONALWALKCOST = 25;
 
 class AStarNodes
 {
 public:
-	AStarNodes(uint32_t x, uint32_t y);
+	/**
+	 * Returns the node arena of the calling thread, reset for a new search
+	 * starting at (x, y). The arena is reused between searches so nothing is
+	 * allocated unless maxNodes grows.
+	 */
+	static AStarNodes& acquire(uint32_t x, uint32_t y, size_t maxNodes);
 
 	AStarNode* createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f);
 	AStarNode* getBestNode();
@@ -43,15 +46,91 @@ public:
 	static int_fast32_t getTileWalkCost(const Creature& creature, const Tile* tile);
 
 private:
-	AStarNode nodes[MAX_NODES];
-	bool openNodes[MAX_NODES];
-	std::unordered_map<uint32_t, AStarNode*> nodeTable;
-	size_t curNode;
-	int_fast32_t closedNodes;
+	struct NodeTableEntry
+	{
+		uint32_t key;
+		uint32_t generation;
+		uint32_t index;
+	};
+
+	AStarNodes() = default;
+
+	void reset(uint32_t x, uint32_t y, size_t maxNodes);
+	NodeTableEntry& findEntry(uint32_t key);
+
+	// open list ordering, ties go to the oldest node
+	bool isBetter(uint32_t lhs, uint32_t rhs) const
+	{
+		return nodes[lhs].f < nodes[rhs].f || (nodes[lhs].f == nodes[rhs].f && lhs < rhs);
+	}
+	void pushOpen(uint32_t index);
+	void removeOpen(uint32_t index);
+	void siftUp(size_t pos);
+	void siftDown(size_t pos);
+
+	std::vector<AStarNode> nodes;
+	std::vector<int32_t> heapPos; // index of each node in openHeap, -1 when closed
+	std::vector<uint32_t> openHeap;
+	std::vector<NodeTableEntry> nodeTable;
+	uint32_t nodeTableShift = 32;
+	uint32_t generation = 0;
+	size_t curNode = 0;
+	int_fast32_t closedNodes = 0;
+};
+
+/**
+ * Walk cost toward one followed creature from every tile of a square around
+ * it, shared by all monsters chasing that creature. Creatures on the way are
+ * ignored, so the field stays valid until the target moves or a tile in range
+ * changes its blocking flags.
+ */
+class FlowField
+{
+public:
+	static constexpr int32_t UNREACHABLE = std::numeric_limits<int32_t>::max();
+
+	/**
+	 * Runs a Dijkstra search outward from target. tileCost returns the extra
+	 * cost of entering the tile at (x, y), or -1 when it cannot be entered.
+	 */
+	void build(const Position& target, int32_t radius,
+	           const std::function<int32_t(uint16_t x, uint16_t y)>& tileCost);
+	void invalidate() { valid = false; }
+
+	bool isValid() const { return valid; }
+	bool isValidFor(const Position& pos) const { return valid && target == pos; }
+	bool covers(const Position& pos) const
+	{
+		return pos.z == target.z && target.getDistanceX(pos) <= radius && target.getDistanceY(pos) <= radius;
+	}
+
+	const Position& getTarget() const { return target; }
+	int32_t getCost(const Position& pos) const;
+
+private:
+	std::vector<int32_t> costs;
+	Position target;
+	int32_t radius = 0;
+	bool valid = false;
+};
+
+struct FlowFieldStats
+{
+	uint64_t builds = 0;
+	uint64_t reads = 0;
+	uint64_t misses = 0;
+	uint64_t invalidations = 0;
 };
 
 using SpectatorCache = std::map<Position, SpectatorVec>;
 
+struct SpectatorCacheStats
+{
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t invalidations = 0;
+};
+
 static constexpr int32_t FLOOR_BITS = 3;
 static constexpr int32_t FLOOR_SIZE = (1 << FLOOR_BITS);
 static constexpr int32_t FLOOR_MASK = (FLOOR_SIZE - 1);
@@ -139,6 +218,10 @@ private:
 	CreatureVector creature_list;
 	CreatureVector player_list;
 
+	// spectator results cached by center position, for centers inside this leaf
+	SpectatorCache spectatorCache;
+	SpectatorCache playersSpectatorCache;
+
 	friend class Map;
 	friend class QTreeNode;
 };
@@ -177,6 +260,14 @@ public:
 	Tile* getTile(uint16_t x, uint16_t y, uint8_t z) const;
 	Tile* getTile(const Position& pos) const { return getTile(pos.x, pos.y, pos.z); }
 
+	/**
+	 * Get the tiles of an area of a floor, walking the quadtree once per 8x8
+	 * block instead of once per tile.
+	 * \param tiles receives width * height tiles, column by column, nullptr
+	 * where there is no tile or the position is outside the map
+	 */
+	void getFloorTiles(int32_t x, int32_t y, uint8_t z, int32_t width, int32_t height, Tile** tiles) const;
+
 	/**
 	 * Set a single tile.
 	 */
@@ -206,8 +297,14 @@ public:
 	                   bool onlyPlayers = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0,
 	                   int32_t maxRangeY = 0);
 
-	void clearSpectatorCache();
-	void clearPlayersSpectatorCache();
+	/**
+	 * Drops the cached spectator lists whose viewport covers a position.
+	 * Must be called whenever a creature enters or leaves the tile at pos.
+	 */
+	void clearSpectatorCache(const Position& pos);
+	void clearPlayersSpectatorCache(const Position& pos);
+
+	const SpectatorCacheStats& getSpectatorCacheStats() const { return spectatorCacheStats; }
 
 	/**
 	 * Checks if you can throw an object to that position
@@ -245,6 +342,23 @@ public:
 	bool getPathMatching(const Creature& creature, std::vector<Direction>& dirList,
 	                     const FrozenPathingConditionCall& pathCondition, const FindPathParams& fpp) const;
 
+	/**
+	 * Follows the shared flow field of target from the creature's position
+	 * until it is next to the target, building the field first if the target
+	 * moved. Returns false when the creature is outside the field or cannot take
+	 * a single step, so the caller can fall back to getPathMatching.
+	 */
+	bool getFlowFieldPath(const Creature& creature, const Creature& target, std::vector<Direction>& dirList);
+
+	/**
+	 * Invalidates the flow fields covering a position.
+	 * Must be called whenever the walkability of the tile at pos changes.
+	 */
+	void clearFlowFields(const Position& pos);
+	void removeFlowField(uint32_t targetId) { flowFields.erase(targetId); }
+
+	const FlowFieldStats& getFlowFieldStats() const { return flowFieldStats; }
+
 	std::map<std::string, Position> waypoints;
 
 	QTreeLeafNode* getQTNode(uint16_t x, uint16_t y)
@@ -257,8 +371,10 @@ public:
 	Houses houses;
 
 private:
-	SpectatorCache spectatorCache;
-	SpectatorCache playersSpectatorCache;
+	SpectatorCacheStats spectatorCacheStats;
+
+	std::map<uint32_t, FlowField> flowFields;
+	FlowFieldStats flowFieldStats;
 
 	QTreeNode root;
 
@@ -273,6 +389,8 @@ private:
 	                           int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ,
 	                           int32_t maxRangeZ, bool onlyPlayers) const;
 
+	void clearSpectatorCacheInternal(const Position& pos, bool onlyPlayers);
+
 	friend class Game;
 	friend class IOMap;
 };
@@ -48,6 +48,7 @@
 #include <valarray>
 #include <variant>
 #include <vector>
+#include <zlib.h>
 
 #if __has_include("luajit/lua.hpp")
 #include <luajit/lua.hpp>
@@ -21,17 +21,31 @@ public:
 
 	void writeMessageLength() { add_header(info.length); }
 
-	void addCryptoHeader(checksumMode_t mode, uint32_t& sequence)
+	void addCryptoHeader(checksumMode_t mode, uint32_t& sequence, bool compressed = false)
 	{
 		if (mode == CHECKSUM_ADLER) {
 			add_header(adlerChecksum(&buffer[outputBufferStart], info.length));
 		} else if (mode == CHECKSUM_SEQUENCE) {
-			add_header(sequence++);
+			// the highest bit of the sequence flags a compressed body
+			uint32_t header = sequence++ & 0x7FFFFFFF;
+			if (compressed) {
+				header |= 1u << 31;
+			}
+			add_header(header);
 		}
 
 		writeMessageLength();
 	}
 
+	// replaces the whole body, must be called before any header is added
+	void setBody(const uint8_t* data, MsgSize_t length)
+	{
+		assert(outputBufferStart == INITIAL_BUFFER_POSITION);
+		std::memcpy(buffer.data() + outputBufferStart, data, length);
+		info.length = length;
+		info.position = outputBufferStart + length;
+	}
+
 	void append(const NetworkMessage& msg)
 	{
 		auto msgLen = msg.getLength();
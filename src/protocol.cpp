@@ -5,6 +5,7 @@
 
 #include "protocol.h"
 
+#include "configmanager.h"
 #include "outputmessage.h"
 #include "rsa.h"
 #include "xtea.h"
@@ -43,18 +44,70 @@ bool XTEA_decrypt(NetworkMessage& msg, const xtea::round_keys& key)
 
 } // namespace
 
+Protocol::~Protocol()
+{
+	if (compressionEnabled) {
+		deflateEnd(&zstream);
+	}
+}
+
 void Protocol::onSendMessage(const OutputMessage_ptr& msg)
 {
 	if (!rawMessages) {
+		bool compressed = compressionEnabled && compress(*msg);
 		msg->writeMessageLength();
 
 		if (encryptionEnabled) {
 			XTEA_encrypt(*msg, key);
-			msg->addCryptoHeader(checksumMode, sequenceNumber);
+			msg->addCryptoHeader(checksumMode, sequenceNumber, compressed);
 		}
 	}
 }
 
+void Protocol::enableCompression()
+{
+	// the compressed flag is carried by the sequence header
+	if (compressionEnabled || checksumMode != CHECKSUM_SEQUENCE) {
+		return;
+	}
+
+	int32_t level = std::clamp(ConfigManager::getNumber(ConfigManager::PACKET_COMPRESSION_LEVEL), 1, 9);
+	// negative window bits, the client inflates raw deflate streams
+	if (deflateInit2(&zstream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		std::cout << "[Warning - Protocol::enableCompression] Failed to initialize zlib stream." << std::endl;
+		return;
+	}
+
+	compressionEnabled = true;
+}
+
+bool Protocol::compress(OutputMessage& msg)
+{
+	if (msg.getLength() < ConfigManager::getNumber(ConfigManager::PACKET_COMPRESSION_THRESHOLD)) {
+		return false;
+	}
+
+	// messages are sent from the dispatcher and the network threads
+	static thread_local std::array<uint8_t, NETWORKMESSAGE_MAXSIZE> buffer;
+
+	zstream.next_in = msg.getOutputBuffer();
+	zstream.avail_in = msg.getLength();
+	zstream.next_out = buffer.data();
+	zstream.avail_out = buffer.size();
+
+	int ret = deflate(&zstream, Z_FINISH);
+	size_t totalSize = zstream.total_out;
+	deflateReset(&zstream);
+
+	// not worth it if it didn't shrink
+	if (ret != Z_STREAM_END || totalSize >= msg.getLength()) {
+		return false;
+	}
+
+	msg.setBody(buffer.data(), totalSize);
+	return true;
+}
+
 void Protocol::onRecvMessage(NetworkMessage& msg)
 {
 	if (encryptionEnabled && !XTEA_decrypt(msg, key)) {
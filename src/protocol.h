@@ -11,7 +11,7 @@ class Protocol : public std::enable_shared_from_this<Protocol>
 {
 public:
 	explicit Protocol(Connection_ptr connection) : connection(connection) {}
-	virtual ~Protocol() = default;
+	virtual ~Protocol();
 
 	// non-copyable
 	Protocol(const Protocol&) = delete;
@@ -54,6 +54,8 @@ protected:
 	void enableXTEAEncryption() { encryptionEnabled = true; }
 	void setXTEAKey(const xtea::key& key) { this->key = xtea::expand_key(key); }
 	void setChecksumMode(checksumMode_t newMode) { checksumMode = newMode; }
+	// raw deflate of large outgoing messages, requires the sequence checksum mode the client inflates with
+	void enableCompression();
 
 	static bool RSA_decrypt(NetworkMessage& msg);
 
@@ -64,6 +66,8 @@ protected:
 private:
 	friend class Connection;
 
+	bool compress(OutputMessage& msg);
+
 	OutputMessage_ptr outputBuffer;
 
 	const ConnectionWeak_ptr connection;
@@ -72,6 +76,8 @@ private:
 	bool encryptionEnabled = false;
 	checksumMode_t checksumMode = CHECKSUM_ADLER;
 	bool rawMessages = false;
+	bool compressionEnabled = false;
+	z_stream zstream = {};
 };
 
 #endif // FS_PROTOCOL_H
@@ -59,6 +59,11 @@ constexpr int64_t getTimeout(std::size_t slot)
 	return getWaitTime(slot) + 15;
 }
 
+// sent after the login challenge by OTClients that take sequenced, possibly compressed packets. Its first two bytes
+// read as a string length longer than the RSA block, so it is never the start of extended login data, and zero
+// padding never matches it
+constexpr uint32_t packetCompressionMagic = 0x5A43FFFF;
+
 std::size_t clientLogin(const Player& player)
 {
 	if (player.hasFlag(PlayerFlag_CanAlwaysLogin) || player.getAccountType() >= ACCOUNT_TYPE_GAMEMASTER) {
@@ -104,6 +109,76 @@ std::size_t clientLogin(const Player& player)
 	return waitList.size();
 }
 
+// the items of a tile as every client is sent them, the creatures in between are written per protocol
+struct EncodedTile
+{
+	uint32_t version = 0;
+	// the ground and top items, sent before the creatures
+	int32_t topCount = 0;
+	size_t topSize = 0;
+	// the top items followed by the down items
+	std::string bytes;
+	// where each down item ends in bytes
+	std::vector<size_t> downItemEnds;
+};
+
+// tiles are only described on the dispatcher thread
+constexpr size_t maxEncodedTiles = 65536;
+std::unordered_map<const Tile*, EncodedTile> encodedTiles;
+
+void encodeTile(const Tile* tile, EncodedTile& encoded)
+{
+	static NetworkMessage msg;
+	msg.reset();
+
+	int32_t count = 0;
+	if (const Item* ground = tile->getGround()) {
+		msg.addItem(ground);
+		count = 1;
+	}
+
+	const TileItemVector* items = tile->getItemList();
+	if (items) {
+		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+			msg.addItem(*it);
+
+			if (++count == MAX_STACKPOS) {
+				break;
+			}
+		}
+	}
+
+	const size_t start = NetworkMessage::INITIAL_BUFFER_POSITION;
+	encoded.topCount = count;
+	encoded.topSize = msg.getBufferPosition() - start;
+	encoded.downItemEnds.clear();
+
+	// with no creatures on the tile at most this many down items are sent
+	if (items) {
+		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end && count < MAX_STACKPOS;
+		     ++it, ++count) {
+			msg.addItem(*it);
+			encoded.downItemEnds.push_back(msg.getBufferPosition() - start);
+		}
+	}
+
+	encoded.bytes.assign(reinterpret_cast<const char*>(msg.getBuffer()) + start, msg.getBufferPosition() - start);
+	encoded.version = tile->getVersion();
+}
+
+const EncodedTile& getEncodedTile(const Tile* tile)
+{
+	if (encodedTiles.size() >= maxEncodedTiles) {
+		encodedTiles.clear();
+	}
+
+	auto [it, inserted] = encodedTiles.try_emplace(tile);
+	if (inserted || it->second.version != tile->getVersion()) {
+		encodeTile(tile, it->second);
+	}
+	return it->second;
+}
+
 } // namespace
 
 void ProtocolGame::release()
@@ -337,14 +412,22 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage& msg)
 	auto accountName = msg.getString();
 	auto characterName = msg.getString();
 	auto password = msg.getString();
+	uint32_t timeStamp = msg.get<uint32_t>();
+	uint8_t randNumber = msg.getByte();
+
+	// OTClients with the GamePacketCompression feature read sequenced packets and say so after the challenge
+	if (operatingSystem >= CLIENTOS_OTCLIENT_LINUX && msg.get<uint32_t>() == packetCompressionMagic) {
+		setChecksumMode(CHECKSUM_SEQUENCE);
+		if (ConfigManager::getBoolean(ConfigManager::PACKET_COMPRESSION)) {
+			enableCompression();
+		}
+	}
 
 	if (accountName.empty()) {
 		disconnectClient("You must enter your account name.");
 		return;
 	}
 
-	uint32_t timeStamp = msg.get<uint32_t>();
-	uint8_t randNumber = msg.getByte();
 	if (challengeTimestamp != timeStamp || challengeRandom != randNumber) {
 		disconnect();
 		return;
@@ -697,25 +780,9 @@ void ProtocolGame::parsePacket(NetworkMessage& msg)
 
 void ProtocolGame::GetTileDescription(const Tile* tile, NetworkMessage& msg)
 {
-	int32_t count;
-	Item* ground = tile->getGround();
-	if (ground) {
-		msg.addItem(ground);
-		count = 1;
-	} else {
-		count = 0;
-	}
-
-	const TileItemVector* items = tile->getItemList();
-	if (items) {
-		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			msg.addItem(*it);
-
-			if (++count == MAX_STACKPOS) {
-				break;
-			}
-		}
-	}
+	const EncodedTile& encoded = getEncodedTile(tile);
+	msg.addBytes(encoded.bytes.data(), encoded.topSize);
+	int32_t count = encoded.topCount;
 
 	const CreatureVector* creatures = tile->getCreatures();
 	if (creatures) {
@@ -733,14 +800,9 @@ void ProtocolGame::GetTileDescription(const Tile* tile, NetworkMessage& msg)
 		}
 	}
 
-	if (items && count < MAX_STACKPOS) {
-		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
-			msg.addItem(*it);
-
-			if (++count == MAX_STACKPOS) {
-				return;
-			}
-		}
+	if (count < MAX_STACKPOS && !encoded.downItemEnds.empty()) {
+		size_t downItems = std::min<size_t>(encoded.downItemEnds.size(), MAX_STACKPOS - count);
+		msg.addBytes(encoded.bytes.data() + encoded.topSize, encoded.downItemEnds[downItems - 1] - encoded.topSize);
 	}
 }
 
@@ -773,24 +835,27 @@ void ProtocolGame::GetMapDescription(int32_t x, int32_t y, int32_t z, int32_t wi
 void ProtocolGame::GetFloorDescription(NetworkMessage& msg, int32_t x, int32_t y, int32_t z, int32_t width,
                                        int32_t height, int32_t offset, int32_t& skip)
 {
-	for (int32_t nx = 0; nx < width; nx++) {
-		for (int32_t ny = 0; ny < height; ny++) {
-			Tile* tile = g_game.map.getTile(x + nx + offset, y + ny + offset, z);
-			if (tile) {
-				if (skip >= 0) {
-					msg.addByte(skip);
-					msg.addByte(0xFF);
-				}
+	// the largest area sent is the whole client viewport
+	std::array<Tile*, (Map::maxClientViewportX * 2 + 2) * (Map::maxClientViewportY * 2 + 2)> tiles;
+	assert(width * height <= static_cast<int32_t>(tiles.size()));
+	g_game.map.getFloorTiles(x + offset, y + offset, z, width, height, tiles.data());
 
-				skip = 0;
-				GetTileDescription(tile, msg);
-			} else if (skip == 0xFE) {
+	for (int32_t i = 0, size = width * height; i < size; ++i) {
+		Tile* tile = tiles[i];
+		if (tile) {
+			if (skip >= 0) {
+				msg.addByte(skip);
 				msg.addByte(0xFF);
-				msg.addByte(0xFF);
-				skip = -1;
-			} else {
-				++skip;
 			}
+
+			skip = 0;
+			GetTileDescription(tile, msg);
+		} else if (skip == 0xFE) {
+			msg.addByte(0xFF);
+			msg.addByte(0xFF);
+			skip = -1;
+		} else {
+			++skip;
 		}
 	}
 }
@@ -5,33 +5,77 @@
 
 #include "scheduler.h"
 
+#include "lockfree.h"
+
+namespace {
+
+const uint16_t SCHEDULER_TASK_FREE_LIST_CAPACITY = 4096;
+
+// event ids are (generation << EVENT_INDEX_BITS) | (entry index + 1), so 0 is never a valid id
+constexpr uint32_t EVENT_INDEX_BITS = 20;
+constexpr uint32_t EVENT_INDEX_MASK = (1 << EVENT_INDEX_BITS) - 1;
+constexpr uint32_t EVENT_GENERATION_MASK = (1 << (32 - EVENT_INDEX_BITS)) - 1;
+constexpr uint32_t MAX_EVENTS = EVENT_INDEX_MASK;
+
+uint32_t makeEventId(uint32_t index, uint16_t generation)
+{
+	return ((generation & EVENT_GENERATION_MASK) << EVENT_INDEX_BITS) | (index + 1);
+}
+
+} // namespace
+
+void* SchedulerTask::operator new(size_t size)
+{
+	assert(size == sizeof(SchedulerTask));
+	return LockfreePoolingAllocator<SchedulerTask, SCHEDULER_TASK_FREE_LIST_CAPACITY>().allocate(1);
+}
+
+void SchedulerTask::operator delete(void* p, size_t size)
+{
+	assert(size == sizeof(SchedulerTask));
+	LockfreePoolingAllocator<SchedulerTask, SCHEDULER_TASK_FREE_LIST_CAPACITY>().deallocate(
+	    static_cast<SchedulerTask*>(p), 1);
+}
+
 uint32_t Scheduler::addEvent(SchedulerTask* task)
 {
-	// check if the event has a valid id
-	if (task->getEventId() == 0) {
-		task->setEventId(++lastEventId);
+	std::unique_lock<std::mutex> eventLockUnique(eventLock);
+
+	if (getState() == THREAD_STATE_TERMINATED) {
+		eventLockUnique.unlock();
+		delete task;
+		return 0;
 	}
 
-	boost::asio::post(io_context, [this, task]() {
-		// insert the event id in the list of active events
-		auto it = eventIdTimerMap.emplace(task->getEventId(), boost::asio::steady_timer{io_context});
-		auto& timer = it.first->second;
+	uint32_t index = allocateEntry();
+	if (index == INVALID_ENTRY) {
+		eventLockUnique.unlock();
+		std::cout << "[Error - Scheduler::addEvent] Too many pending events." << std::endl;
+		delete task;
+		return 0;
+	}
 
-		timer.expires_after(std::chrono::milliseconds(task->getDelay()));
-		timer.async_wait([this, task](const boost::system::error_code& error) {
-			eventIdTimerMap.erase(task->getEventId());
+	TimerEntry& entry = entries[index];
+	entry.task = task;
+	// the wheel can't go back in time, events due before the next processed tick run on that tick
+	entry.expiration = std::max(getTick() + task->getDelay(), currentTick);
+	task->setEventId(makeEventId(index, entry.generation));
+	link(index);
+	pendingEvents.fetch_add(1, std::memory_order_relaxed);
 
-			if (error == boost::asio::error::operation_aborted || getState() == THREAD_STATE_TERMINATED) {
-				// the timer has been manually canceled(timer->cancel()) or Scheduler::shutdown has been called
-				delete task;
-				return;
-			}
+	// wake up the scheduler thread only if this event is due before it would wake up anyway
+	bool doSignal = entry.expiration < wakeupTick;
+	if (doSignal) {
+		wakeupTick = entry.expiration;
+	}
 
-			g_dispatcher.addTask(task);
-		});
-	});
+	uint32_t eventId = task->getEventId();
+	eventLockUnique.unlock();
 
-	return task->getEventId();
+	if (doSignal) {
+		eventSignal.notify_one();
+	}
+	return eventId;
 }
 
 void Scheduler::stopEvent(uint32_t eventId)
@@ -40,26 +84,228 @@ void Scheduler::stopEvent(uint32_t eventId)
 		return;
 	}
 
-	boost::asio::post(io_context, [this, eventId]() {
-		// search the event id
-		auto it = eventIdTimerMap.find(eventId);
-		if (it != eventIdTimerMap.end()) {
-			it->second.cancel();
+	SchedulerTask* task;
+	{
+		std::lock_guard<std::mutex> lockClass(eventLock);
+
+		uint32_t index = (eventId & EVENT_INDEX_MASK) - 1;
+		if (index >= entries.size()) {
+			return;
 		}
-	});
+
+		TimerEntry& entry = entries[index];
+		if (!entry.task || (entry.generation & EVENT_GENERATION_MASK) != (eventId >> EVENT_INDEX_BITS)) {
+			// the event already expired or was stopped
+			return;
+		}
+
+		task = entry.task;
+		unlink(index);
+		freeEntry(index);
+		pendingEvents.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	delete task;
 }
 
 void Scheduler::shutdown()
 {
+	std::lock_guard<std::mutex> lockClass(eventLock);
 	setState(THREAD_STATE_TERMINATED);
-	boost::asio::post(io_context, [this]() {
-		// cancel all active timers
-		for (auto& it : eventIdTimerMap) {
-			it.second.cancel();
+	eventSignal.notify_one();
+}
+
+void Scheduler::threadMain()
+{
+	std::vector<Task*> expiredTasks;
+	std::unique_lock<std::mutex> eventLockUnique(eventLock);
+
+	while (getState() != THREAD_STATE_TERMINATED) {
+		// events added while expired ones are handed off don't need to signal
+		wakeupTick = 0;
+		advance(getTick(), expiredTasks);
+
+		if (!expiredTasks.empty()) {
+			eventLockUnique.unlock();
+			g_dispatcher.addTasks(expiredTasks);
+			eventLockUnique.lock();
+			continue;
+		}
+
+		wakeupTick = getNextExpiration();
+		if (wakeupTick == std::numeric_limits<uint64_t>::max()) {
+			eventSignal.wait(eventLockUnique);
+		} else {
+			eventSignal.wait_until(eventLockUnique, startTime + std::chrono::milliseconds(wakeupTick));
+		}
+	}
+
+	// events still pending on shutdown are never executed
+	for (TimerEntry& entry : entries) {
+		delete entry.task;
+		entry.task = nullptr;
+	}
+}
+
+uint64_t Scheduler::getTick() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime)
+	    .count();
+}
+
+uint32_t Scheduler::allocateEntry()
+{
+	// free entries are reused in FIFO order so a stale event id takes as long as possible to become valid again
+	if (!freeEntries.empty()) {
+		uint32_t index = freeEntries.front();
+		freeEntries.pop_front();
+		return index;
+	}
+
+	if (entries.size() >= MAX_EVENTS) {
+		return INVALID_ENTRY;
+	}
+
+	entries.emplace_back();
+	return entries.size() - 1;
+}
+
+void Scheduler::freeEntry(uint32_t index)
+{
+	TimerEntry& entry = entries[index];
+	entry.task = nullptr;
+	++entry.generation;
+	freeEntries.push_back(index);
+}
+
+void Scheduler::link(uint32_t index)
+{
+	TimerEntry& entry = entries[index];
+
+	uint64_t expiration = entry.expiration;
+	uint64_t delta = expiration - currentTick;
+
+	uint32_t slot;
+	if (delta < (1 << ROOT_BITS)) {
+		slot = expiration & ((1 << ROOT_BITS) - 1);
+	} else {
+		uint32_t level = 0;
+		while (level < LEVELS - 1 && delta >= (1ull << (ROOT_BITS + (level + 1) * LEVEL_BITS))) {
+			++level;
+		}
+
+		if (delta >= (1ull << (ROOT_BITS + LEVELS * LEVEL_BITS))) {
+			// beyond the range of the wheel, park it in the furthest slot and let cascading bring it back
+			expiration = currentTick + (1ull << (ROOT_BITS + LEVELS * LEVEL_BITS)) - 1;
+		}
+
+		uint32_t shift = ROOT_BITS + level * LEVEL_BITS;
+		slot = (1 << ROOT_BITS) + level * (1 << LEVEL_BITS) + ((expiration >> shift) & ((1 << LEVEL_BITS) - 1));
+	}
+
+	TimerSlot& timerSlot = wheel[slot];
+	entry.slot = slot;
+	entry.next = INVALID_ENTRY;
+	entry.prev = timerSlot.tail;
+	if (timerSlot.tail != INVALID_ENTRY) {
+		entries[timerSlot.tail].next = index;
+	} else {
+		timerSlot.head = index;
+	}
+	timerSlot.tail = index;
+}
+
+void Scheduler::unlink(uint32_t index)
+{
+	TimerEntry& entry = entries[index];
+	TimerSlot& timerSlot = wheel[entry.slot];
+
+	if (entry.prev != INVALID_ENTRY) {
+		entries[entry.prev].next = entry.next;
+	} else {
+		timerSlot.head = entry.next;
+	}
+
+	if (entry.next != INVALID_ENTRY) {
+		entries[entry.next].prev = entry.prev;
+	} else {
+		timerSlot.tail = entry.prev;
+	}
+}
+
+uint32_t Scheduler::cascade(uint32_t level)
+{
+	uint32_t index = (currentTick >> (ROOT_BITS + level * LEVEL_BITS)) & ((1 << LEVEL_BITS) - 1);
+	TimerSlot& timerSlot = wheel[(1 << ROOT_BITS) + level * (1 << LEVEL_BITS) + index];
+
+	// move every event of the slot one or more levels down, in their original order
+	uint32_t entryIndex = timerSlot.head;
+	timerSlot.head = INVALID_ENTRY;
+	timerSlot.tail = INVALID_ENTRY;
+	while (entryIndex != INVALID_ENTRY) {
+		uint32_t next = entries[entryIndex].next;
+		link(entryIndex);
+		entryIndex = next;
+	}
+	return index;
+}
+
+uint64_t Scheduler::getNextExpiration() const
+{
+	if (pendingEvents.load(std::memory_order_relaxed) == 0) {
+		return std::numeric_limits<uint64_t>::max();
+	}
+
+	// either an event of the root wheel or the next cascade, whichever comes first
+	for (uint64_t tick = currentTick; tick < currentTick + (1 << ROOT_BITS); ++tick) {
+		uint32_t index = tick & ((1 << ROOT_BITS) - 1);
+		if (index == 0 || wheel[index].head != INVALID_ENTRY) {
+			return tick;
 		}
+	}
+	return currentTick + (1 << ROOT_BITS);
+}
 
-		io_context.stop();
-	});
+void Scheduler::advance(uint64_t now, std::vector<Task*>& expiredTasks)
+{
+	uint64_t lateness = 0;
+	while (currentTick <= now) {
+		uint32_t index = currentTick & ((1 << ROOT_BITS) - 1);
+		if (index == 0) {
+			for (uint32_t level = 0; level < LEVELS; ++level) {
+				if (cascade(level) != 0) {
+					break;
+				}
+			}
+		}
+
+		TimerSlot& timerSlot = wheel[index];
+		uint32_t entryIndex = timerSlot.head;
+		timerSlot.head = INVALID_ENTRY;
+		timerSlot.tail = INVALID_ENTRY;
+		while (entryIndex != INVALID_ENTRY) {
+			TimerEntry& entry = entries[entryIndex];
+			uint32_t next = entry.next;
+
+			uint64_t eventLateness = now - entry.expiration;
+			totalLateness.fetch_add(eventLateness, std::memory_order_relaxed);
+			lateness = std::max(lateness, eventLateness);
+
+			expiredTasks.push_back(entry.task);
+			freeEntry(entryIndex);
+			entryIndex = next;
+		}
+
+		++currentTick;
+	}
+
+	if (!expiredTasks.empty()) {
+		pendingEvents.fetch_sub(expiredTasks.size(), std::memory_order_relaxed);
+		expiredEvents.fetch_add(expiredTasks.size(), std::memory_order_relaxed);
+		if (lateness > maxLateness.load(std::memory_order_relaxed)) {
+			maxLateness.store(lateness, std::memory_order_relaxed);
+		}
+	}
 }
 
 SchedulerTask* createSchedulerTask(uint32_t delay, TaskFunc&& f) { return new SchedulerTask(delay, std::move(f)); }
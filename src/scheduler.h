@@ -17,6 +17,9 @@ public:
 
 	uint32_t getDelay() const { return delay; }
 
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size);
+
 private:
 	SchedulerTask(uint32_t delay, TaskFunc&& f) : Task(std::move(f)), delay(delay) {}
 
@@ -28,6 +31,11 @@ private:
 
 SchedulerTask* createSchedulerTask(uint32_t delay, TaskFunc&& f);
 
+/**
+ * Hierarchical timing wheel with a resolution of one millisecond.
+ * Event ids encode the slot of the event, so adding and stopping an event
+ * are both constant time operations done directly by the calling thread.
+ */
 class Scheduler : public ThreadHolder<Scheduler>
 {
 public:
@@ -36,13 +44,61 @@ public:
 
 	void shutdown();
 
-	void threadMain() { io_context.run(); }
+	void threadMain();
+
+	uint32_t getPendingEvents() const { return pendingEvents.load(std::memory_order_relaxed); }
+	uint64_t getExpiredEvents() const { return expiredEvents.load(std::memory_order_relaxed); }
+	// lateness is the time in milliseconds between the expiration of an event and its hand-off to the dispatcher
+	uint64_t getTotalLateness() const { return totalLateness.load(std::memory_order_relaxed); }
+	uint64_t getMaxLateness() const { return maxLateness.load(std::memory_order_relaxed); }
 
 private:
-	std::atomic<uint32_t> lastEventId{0};
-	std::unordered_map<uint32_t, boost::asio::steady_timer> eventIdTimerMap;
-	boost::asio::io_context io_context;
-	boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work{io_context.get_executor()};
+	struct TimerEntry
+	{
+		SchedulerTask* task = nullptr;
+		uint64_t expiration = 0;
+		uint32_t prev = 0;
+		uint32_t next = 0;
+		uint32_t slot = 0;
+		uint16_t generation = 0;
+	};
+
+	static constexpr uint32_t INVALID_ENTRY = std::numeric_limits<uint32_t>::max();
+
+	struct TimerSlot
+	{
+		uint32_t head = INVALID_ENTRY;
+		uint32_t tail = INVALID_ENTRY;
+	};
+
+	static constexpr uint32_t ROOT_BITS = 8;
+	static constexpr uint32_t LEVEL_BITS = 6;
+	static constexpr uint32_t LEVELS = 4;
+	static constexpr uint32_t WHEEL_SIZE = (1 << ROOT_BITS) + LEVELS * (1 << LEVEL_BITS);
+
+	uint64_t getTick() const;
+	uint32_t allocateEntry();
+	void freeEntry(uint32_t index);
+	void link(uint32_t index);
+	void unlink(uint32_t index);
+	uint32_t cascade(uint32_t level);
+	uint64_t getNextExpiration() const;
+	void advance(uint64_t now, std::vector<Task*>& expiredTasks);
+
+	std::mutex eventLock;
+	std::condition_variable eventSignal;
+
+	std::vector<TimerEntry> entries;
+	std::deque<uint32_t> freeEntries;
+	std::array<TimerSlot, WHEEL_SIZE> wheel;
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	uint64_t currentTick = 0;
+	uint64_t wakeupTick = std::numeric_limits<uint64_t>::max();
+
+	std::atomic<uint32_t> pendingEvents{0};
+	std::atomic<uint64_t> expiredEvents{0};
+	std::atomic<uint64_t> totalLateness{0};
+	std::atomic<uint64_t> maxLateness{0};
 };
 
 extern Scheduler g_scheduler;
@@ -7,71 +7,164 @@
 
 #include "enums.h"
 #include "game.h"
+#include "lockfree.h"
 
 extern Game g_game;
 
+namespace {
+
+const uint16_t TASK_FREE_LIST_CAPACITY = 4096;
+
+} // namespace
+
+void* Task::operator new(size_t size)
+{
+	assert(size == sizeof(Task));
+	return LockfreePoolingAllocator<Task, TASK_FREE_LIST_CAPACITY>().allocate(1);
+}
+
+void Task::operator delete(void* p, size_t size)
+{
+	assert(size == sizeof(Task));
+	LockfreePoolingAllocator<Task, TASK_FREE_LIST_CAPACITY>().deallocate(static_cast<Task*>(p), 1);
+}
+
 Task* createTask(TaskFunc&& f) { return new Task(std::move(f)); }
 
 Task* createTask(uint32_t expiration, TaskFunc&& f) { return new Task(expiration, std::move(f)); }
 
 void Dispatcher::threadMain()
 {
-	std::vector<Task*> tmpTaskList;
-	// NOTE: second argument defer_lock is to prevent from immediate locking
-	std::unique_lock<std::mutex> taskLockUnique(taskLock, std::defer_lock);
-
 	while (getState() != THREAD_STATE_TERMINATED) {
-		// check if there are tasks waiting
-		taskLockUnique.lock();
-		if (taskList.empty()) {
-			// if the list is empty wait for signal
-			taskSignal.wait(taskLockUnique);
+		// only run the tasks queued when the cycle started, tasks added by them go to the next cycle
+		uint32_t pendingTasks = taskQueueSize.load(std::memory_order_acquire);
+		if (pendingTasks == 0) {
+			// announce we are going to sleep, then check again so a concurrent addTask can't be missed
+			sleeping.exchange(true);
+			if (taskQueueSize.load(std::memory_order_acquire) == 0) {
+				sleeping.wait(true);
+			}
+			sleeping.store(false, std::memory_order_relaxed);
+			continue;
 		}
-		tmpTaskList.swap(taskList);
-		taskLockUnique.unlock();
 
-		for (Task* task : tmpTaskList) {
-			if (!task->hasExpired()) {
+		// a single clock read for the whole batch
+		const auto cycleStart = std::chrono::system_clock::now();
+		while (pendingTasks > 0) {
+			Task* task = pop();
+			if (!task) {
+				// a producer is halfway through pushing, pick it up on the next cycle
+				break;
+			}
+			--pendingTasks;
+
+			if (!task->hasExpired(cycleStart)) {
 				++dispatcherCycle;
 				// execute it
 				(*task)();
 			}
 			delete task;
 		}
-		tmpTaskList.clear();
+
+		const uint64_t cycleTime =
+		    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - cycleStart)
+		        .count();
+		lastCycleTime.store(cycleTime, std::memory_order_relaxed);
+		if (cycleTime > maxCycleTime.load(std::memory_order_relaxed)) {
+			maxCycleTime.store(cycleTime, std::memory_order_relaxed);
+		}
+	}
+
+	// tasks still queued on shutdown are never executed
+	while (Task* task = pop()) {
+		delete task;
 	}
 }
 
 void Dispatcher::addTask(Task* task)
 {
-	bool do_signal = false;
+	if (getState() != THREAD_STATE_RUNNING) {
+		delete task;
+		return;
+	}
 
-	taskLock.lock();
+	push(task);
 
-	if (getState() == THREAD_STATE_RUNNING) {
-		do_signal = taskList.empty();
-		taskList.push_back(task);
-	} else {
-		delete task;
+	// wake up the dispatcher if it's waiting for tasks
+	if (sleeping.exchange(false)) {
+		sleeping.notify_one();
+	}
+}
+
+void Dispatcher::addTasks(std::vector<Task*>& tasks)
+{
+	if (getState() != THREAD_STATE_RUNNING) {
+		for (Task* task : tasks) {
+			delete task;
+		}
+		tasks.clear();
+		return;
 	}
 
-	taskLock.unlock();
+	for (Task* task : tasks) {
+		push(task);
+	}
+	tasks.clear();
 
-	// send a signal if the list was empty
-	if (do_signal) {
-		taskSignal.notify_one();
+	if (sleeping.exchange(false)) {
+		sleeping.notify_one();
 	}
 }
 
 void Dispatcher::shutdown()
 {
-	Task* task = createTask([this]() {
-		setState(THREAD_STATE_TERMINATED);
-		taskSignal.notify_one();
-	});
+	Task* task = createTask([this]() { setState(THREAD_STATE_TERMINATED); });
+
+	push(task);
+
+	if (sleeping.exchange(false)) {
+		sleeping.notify_one();
+	}
+}
+
+void Dispatcher::push(Task* task)
+{
+	task->next.store(nullptr, std::memory_order_relaxed);
+	taskQueueSize.fetch_add(1, std::memory_order_release);
+	Task* prev = head.exchange(task, std::memory_order_acq_rel);
+	prev->next.store(task, std::memory_order_release);
+}
+
+Task* Dispatcher::pop()
+{
+	Task* first = tail;
+	Task* next = first->next.load(std::memory_order_acquire);
+	if (first == &stub) {
+		if (!next) {
+			return nullptr;
+		}
 
-	std::lock_guard<std::mutex> lockClass(taskLock);
-	taskList.push_back(task);
+		tail = next;
+		first = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+
+	if (!next) {
+		if (first != head.load(std::memory_order_acquire)) {
+			// a producer swapped the head but hasn't linked its task yet
+			return nullptr;
+		}
+
+		// re-insert the stub so the last task can be detached
+		push(&stub);
+		taskQueueSize.fetch_sub(1, std::memory_order_relaxed);
+		next = first->next.load(std::memory_order_acquire);
+		if (!next) {
+			return nullptr;
+		}
+	}
 
-	taskSignal.notify_one();
+	tail = next;
+	taskQueueSize.fetch_sub(1, std::memory_order_relaxed);
+	return first;
 }
@@ -6,7 +6,100 @@
 
 #include "thread_holder_base.h"
 
-using TaskFunc = std::function<void(void)>;
+/**
+ * Move-only void() callable. Callables up to INLINE_SIZE bytes are stored
+ * in place, which covers the captures of nearly every task in the server,
+ * so wrapping a lambda doesn't allocate.
+ */
+class TaskFunc
+{
+public:
+	static constexpr size_t INLINE_SIZE = 64;
+
+	TaskFunc() = default;
+
+	template <typename F>
+	    requires(!std::same_as<std::decay_t<F>, TaskFunc> && std::invocable<std::decay_t<F>&>)
+	TaskFunc(F&& f)
+	{
+		using Func = std::decay_t<F>;
+		if constexpr (sizeof(Func) <= INLINE_SIZE && alignof(Func) <= alignof(std::max_align_t) &&
+		              std::is_nothrow_move_constructible_v<Func>) {
+			new (storage) Func(std::forward<F>(f));
+			ops = &inlineOps<Func>;
+		} else {
+			*reinterpret_cast<Func**>(storage) = new Func(std::forward<F>(f));
+			ops = &heapOps<Func>;
+		}
+	}
+
+	TaskFunc(TaskFunc&& other) noexcept : ops(other.ops)
+	{
+		if (ops) {
+			ops->move(storage, other.storage);
+			other.ops = nullptr;
+		}
+	}
+
+	TaskFunc& operator=(TaskFunc&& other) noexcept
+	{
+		if (this != &other) {
+			reset();
+			if (other.ops) {
+				ops = other.ops;
+				ops->move(storage, other.storage);
+				other.ops = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	// non-copyable
+	TaskFunc(const TaskFunc&) = delete;
+	TaskFunc& operator=(const TaskFunc&) = delete;
+
+	~TaskFunc() { reset(); }
+
+	void operator()() { ops->invoke(storage); }
+	explicit operator bool() const { return ops != nullptr; }
+
+private:
+	struct Ops
+	{
+		void (*invoke)(void*);
+		void (*move)(void*, void*); // move-constructs into the first buffer and destroys the second
+		void (*destroy)(void*);
+	};
+
+	template <typename Func>
+	static constexpr Ops inlineOps = {
+	    [](void* p) { (*static_cast<Func*>(p))(); },
+	    [](void* dst, void* src) {
+		    new (dst) Func(std::move(*static_cast<Func*>(src)));
+		    static_cast<Func*>(src)->~Func();
+	    },
+	    [](void* p) { static_cast<Func*>(p)->~Func(); },
+	};
+
+	template <typename Func>
+	static constexpr Ops heapOps = {
+	    [](void* p) { (**static_cast<Func**>(p))(); },
+	    [](void* dst, void* src) { *static_cast<Func**>(dst) = *static_cast<Func**>(src); },
+	    [](void* p) { delete *static_cast<Func**>(p); },
+	};
+
+	void reset()
+	{
+		if (ops) {
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) std::byte storage[INLINE_SIZE];
+	const Ops* ops = nullptr;
+};
+
 const int DISPATCHER_TASK_EXPIRATION = 2000;
 const auto SYSTEM_TIME_ZERO = std::chrono::system_clock::time_point(std::chrono::milliseconds(0));
 
@@ -22,14 +115,18 @@ public:
 	virtual ~Task() = default;
 	void operator()() { func(); }
 
+	// tasks are recycled through a lock-free free list instead of going back to the heap
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size);
+
 	void setDontExpire() { expiration = SYSTEM_TIME_ZERO; }
 
-	bool hasExpired() const
+	bool hasExpired(std::chrono::system_clock::time_point now) const
 	{
 		if (expiration == SYSTEM_TIME_ZERO) {
 			return false;
 		}
-		return expiration < std::chrono::system_clock::now();
+		return expiration < now;
 	}
 
 protected:
@@ -39,6 +136,11 @@ private:
 	// Expiration has another meaning for scheduler tasks, then it is the time the task should be added to the
 	// dispatcher
 	TaskFunc func;
+
+	// intrusive link of the dispatcher queue
+	std::atomic<Task*> next{nullptr};
+
+	friend class Dispatcher;
 };
 
 Task* createTask(TaskFunc&& f);
@@ -48,6 +150,8 @@ class Dispatcher : public ThreadHolder<Dispatcher>
 {
 public:
 	void addTask(Task* task);
+	// takes ownership of every task and leaves the vector empty
+	void addTasks(std::vector<Task*>& tasks);
 
 	void addTask(TaskFunc&& f) { addTask(new Task(std::move(f))); }
 
@@ -56,15 +160,28 @@ public:
 	void shutdown();
 
 	uint64_t getDispatcherCycle() const { return dispatcherCycle; }
+	uint32_t getTaskQueueSize() const { return taskQueueSize.load(std::memory_order_relaxed); }
+	// time spent running the last batch of tasks, in microseconds
+	uint64_t getLastCycleTime() const { return lastCycleTime.load(std::memory_order_relaxed); }
+	uint64_t getMaxCycleTime() const { return maxCycleTime.load(std::memory_order_relaxed); }
 
 	void threadMain();
 
 private:
-	std::mutex taskLock;
-	std::condition_variable taskSignal;
+	// intrusive multi-producer single-consumer queue (Vyukov), only the dispatcher thread pops
+	void push(Task* task);
+	Task* pop();
+
+	Task stub{TaskFunc{}};
+	std::atomic<Task*> head{&stub};
+	Task* tail = &stub;
+
+	std::atomic<uint32_t> taskQueueSize{0};
+	std::atomic<bool> sleeping{false};
 
-	std::vector<Task*> taskList;
 	uint64_t dispatcherCycle = 0;
+	std::atomic<uint64_t> lastCycleTime{0};
+	std::atomic<uint64_t> maxCycleTime{0};
 };
 
 extern Dispatcher g_dispatcher;
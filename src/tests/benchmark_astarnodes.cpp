@@ -0,0 +1,163 @@
+#define BOOST_TEST_MODULE benchmark_astarnodes
+
+#include "../otpch.h"
+
+#include "../configmanager.h"
+#include "../creature.h"
+#include "../map.h"
+#include "../tile.h"
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <random>
+
+namespace {
+
+struct PathQuery
+{
+	uint16_t startX, startY;
+	uint16_t targetX, targetY;
+};
+
+constexpr uint16_t areaX = 1000;
+constexpr uint16_t areaY = 1000;
+constexpr int32_t areaSize = 96;
+
+// a raid area: pillars, a few walls with gaps and the area borders
+bool isBlocked(int32_t x, int32_t y)
+{
+	int32_t ax = x - areaX, ay = y - areaY;
+	if (ax < 0 || ay < 0 || ax >= areaSize || ay >= areaSize) {
+		return true;
+	}
+	if (ax % 12 == 6 && ay % 12 == 6) {
+		return true;
+	}
+	return (ax % 24 == 12 && ay % 16 > 3) || (ay % 32 == 16 && ax % 20 > 2);
+}
+
+// "startX startY targetX targetY" per line, e.g. the getPathMatching calls of a server log moved onto the area
+std::vector<PathQuery> loadQueries(const char* fileName)
+{
+	std::vector<PathQuery> queries;
+	std::ifstream in(fileName);
+	PathQuery query;
+	while (in >> query.startX >> query.startY >> query.targetX >> query.targetY) {
+		queries.push_back(query);
+	}
+	return queries;
+}
+
+// monsters of a raid closing in on players from every side, as recorded by default
+std::vector<PathQuery> makeQueries(size_t count)
+{
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int32_t> coord(0, areaSize - 1);
+	std::uniform_int_distribution<int32_t> offset(-10, 10);
+
+	std::vector<PathQuery> queries;
+	while (queries.size() < count) {
+		int32_t targetX = areaX + coord(rng), targetY = areaY + coord(rng);
+		int32_t startX = targetX + offset(rng), startY = targetY + offset(rng);
+		if (isBlocked(targetX, targetY) || isBlocked(startX, startY)) {
+			continue;
+		}
+		queries.push_back({static_cast<uint16_t>(startX), static_cast<uint16_t>(startY),
+		                   static_cast<uint16_t>(targetX), static_cast<uint16_t>(targetY)});
+	}
+	return queries;
+}
+
+// a walkable tile without items, as the area has no item types loaded
+class GroundTile final : public DynamicTile
+{
+public:
+	using DynamicTile::DynamicTile;
+
+	ReturnValue queryAdd(int32_t, const Thing&, uint32_t, uint32_t, Creature* = nullptr) const override
+	{
+		return RETURNVALUE_NOERROR;
+	}
+};
+
+// a creature chasing its target, the way Creature::getPathTo asks for it
+class ChasingCreature final : public Creature
+{
+public:
+	const std::string& getName() const override { return name; }
+	const std::string& getNameDescription() const override { return name; }
+	std::string getDescription(int32_t) const override { return name; }
+	CreatureType_t getType() const override { return CREATURETYPE_MONSTER; }
+
+	void setID() override {}
+	void addList() override {}
+	void removeList() override {}
+
+private:
+	std::string name = "chaser";
+};
+
+struct RaidArea
+{
+	RaidArea()
+	{
+		for (int32_t x = areaX; x < areaX + areaSize; ++x) {
+			for (int32_t y = areaY; y < areaY + areaSize; ++y) {
+				if (!isBlocked(x, y)) {
+					map.setTile(x, y, 7, new GroundTile(x, y, 7));
+				}
+			}
+		}
+	}
+
+	size_t findPath(const PathQuery& query)
+	{
+		creature.setParent(map.getTile(query.startX, query.startY, 7));
+
+		FindPathParams fpp;
+		fpp.clearSight = false;
+		fpp.minTargetDist = 1;
+		fpp.maxTargetDist = 1;
+
+		std::vector<Direction> dirList;
+		if (!map.getPathMatching(creature, dirList, FrozenPathingConditionCall(Position(query.targetX, query.targetY, 7)),
+		                         fpp)) {
+			return 0;
+		}
+		return dirList.size();
+	}
+
+	Map map;
+	ChasingCreature creature;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_pathing_queries)
+{
+	// ASTAR_QUERIES replays a recorded query file instead of the generated raid
+	const char* fileName = std::getenv("ASTAR_QUERIES");
+	const std::vector<PathQuery> queries = fileName ? loadQueries(fileName) : makeQueries(20000);
+	BOOST_TEST_REQUIRE(!queries.empty());
+
+	RaidArea area;
+
+	using namespace std::chrono;
+	for (size_t maxNodes : {512, 4096}) {
+		ConfigManager::setNumber(ConfigManager::PATHFINDING_MAX_NODES, maxNodes);
+
+		size_t found = 0, steps = 0;
+		auto start = steady_clock::now();
+		for (const PathQuery& query : queries) {
+			if (size_t length = area.findPath(query)) {
+				++found;
+				steps += length;
+			}
+		}
+		auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+
+		BOOST_TEST(found > 0u);
+		BOOST_TEST_MESSAGE(queries.size() << " queries with " << maxNodes << " nodes: " << found << " paths, " << steps
+		                                  << " steps in " << elapsed.count() << " us");
+	}
+}
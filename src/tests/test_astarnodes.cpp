@@ -0,0 +1,73 @@
+#define BOOST_TEST_MODULE astarnodes
+
+#include "../otpch.h"
+
+#include "../map.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(test_AStarNodes_best_node)
+{
+	AStarNodes& nodes = AStarNodes::acquire(100, 100, 16);
+	AStarNode* start = nodes.getBestNode();
+	BOOST_TEST_REQUIRE(start);
+	BOOST_TEST(start->x == 100);
+	BOOST_TEST(start->y == 100);
+	nodes.closeNode(start);
+
+	AStarNode* a = nodes.createOpenNode(start, 101, 100, 30);
+	AStarNode* b = nodes.createOpenNode(start, 100, 101, 10);
+	AStarNode* c = nodes.createOpenNode(start, 99, 100, 20);
+	BOOST_TEST(nodes.getBestNode() == b);
+
+	nodes.closeNode(b);
+	BOOST_TEST(nodes.getBestNode() == c);
+	BOOST_TEST(nodes.getClosedNodes() == 2);
+
+	// lowering the cost of an open node moves it to the front
+	a->f = 5;
+	nodes.openNode(a);
+	BOOST_TEST(nodes.getBestNode() == a);
+
+	// reopening a closed node puts it back on the open list
+	b->f = 1;
+	nodes.openNode(b);
+	BOOST_TEST(nodes.getBestNode() == b);
+	BOOST_TEST(nodes.getClosedNodes() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_AStarNodes_ties_prefer_oldest)
+{
+	AStarNodes& nodes = AStarNodes::acquire(100, 100, 16);
+	AStarNode* start = nodes.getBestNode();
+	nodes.closeNode(start);
+
+	AStarNode* a = nodes.createOpenNode(start, 101, 100, 10);
+	AStarNode* b = nodes.createOpenNode(start, 100, 101, 10);
+	BOOST_TEST(nodes.getBestNode() == a);
+
+	nodes.closeNode(a);
+	BOOST_TEST(nodes.getBestNode() == b);
+}
+
+BOOST_AUTO_TEST_CASE(test_AStarNodes_lookup_and_reuse)
+{
+	AStarNodes& nodes = AStarNodes::acquire(100, 100, 4);
+	AStarNode* start = nodes.getBestNode();
+	AStarNode* a = nodes.createOpenNode(start, 101, 100, 10);
+
+	BOOST_TEST(nodes.getNodeByPosition(100, 100) == start);
+	BOOST_TEST(nodes.getNodeByPosition(101, 100) == a);
+	BOOST_TEST(!nodes.getNodeByPosition(102, 100));
+
+	BOOST_TEST(nodes.createOpenNode(start, 102, 100, 10));
+	BOOST_TEST(nodes.createOpenNode(start, 103, 100, 10));
+	BOOST_TEST(!nodes.createOpenNode(start, 104, 100, 10));
+
+	// a new search starts from an empty arena
+	AStarNodes& next = AStarNodes::acquire(200, 200, 4);
+	BOOST_TEST(&next == &nodes);
+	BOOST_TEST(!next.getNodeByPosition(101, 100));
+	BOOST_TEST(next.getNodeByPosition(200, 200) == next.getBestNode());
+	BOOST_TEST(next.getClosedNodes() == 0);
+}
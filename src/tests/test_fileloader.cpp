@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE fileloader
+
+#include "../otpch.h"
+
+#include "../fileloader.h"
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+namespace {
+
+constexpr char START = static_cast<char>(OTB::Node::START);
+constexpr char END = static_cast<char>(OTB::Node::END);
+constexpr char ESCAPE = static_cast<char>(OTB::Node::ESCAPE);
+
+// root(1) { area(4) { tile(5) { item(6) } tile(5) } towns(12) }, with escaped bytes in the props
+const std::string tree = std::string{"TEST"} + START + '\x01' + 'r' + START + '\x04' + 'a' + ESCAPE + START + START +
+                         '\x05' + "t1" + START + '\x06' + ESCAPE + END + END + END + START + '\x05' + "t2" + END +
+                         END + START + '\x0C' + ESCAPE + ESCAPE + END + END;
+
+std::string writeTree()
+{
+	auto path = (std::filesystem::temp_directory_path() / "test_fileloader.otb").string();
+	std::ofstream{path, std::ios::binary} << tree;
+	return path;
+}
+
+std::string getProps(OTB::Loader& loader, const OTB::Node& node)
+{
+	PropStream props;
+	if (!loader.getProps(node, props)) {
+		return {};
+	}
+
+	std::string value(props.size(), '\0');
+	for (char& c : value) {
+		props.read(c);
+	}
+	return value;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_ChildCursor_matches_parseTree)
+{
+	OTB::Loader loader{writeTree(), OTB::Identifier{{'T', 'E', 'S', 'T'}}};
+
+	const OTB::Node& root = loader.parseRoot();
+	BOOST_TEST(root.type == 1);
+	BOOST_TEST(getProps(loader, root) == "r");
+
+	OTB::ChildCursor cursor{loader, root};
+	OTB::Node area, towns, none;
+	BOOST_TEST_REQUIRE(cursor.next(area));
+	BOOST_TEST(area.type == 4);
+	BOOST_TEST(area.children.empty());
+	BOOST_TEST(getProps(loader, area) == (std::string{'a', START}));
+
+	// the area subtree is skipped, escaped END bytes included
+	BOOST_TEST_REQUIRE(cursor.next(towns));
+	BOOST_TEST(towns.type == 12);
+	BOOST_TEST(getProps(loader, towns) == std::string{ESCAPE});
+	BOOST_TEST(!cursor.next(none));
+
+	loader.parseChildren(area);
+	BOOST_TEST_REQUIRE(area.children.size() == 2);
+	BOOST_TEST(getProps(loader, area.children[0]) == "t1");
+	BOOST_TEST_REQUIRE(area.children[0].children.size() == 1);
+	BOOST_TEST(getProps(loader, area.children[0].children[0]) == std::string{END});
+	BOOST_TEST(getProps(loader, area.children[1]) == "t2");
+
+	// same nodes as the full tree
+	OTB::Loader fullLoader{writeTree(), OTB::Identifier{{'T', 'E', 'S', 'T'}}};
+	const OTB::Node& fullRoot = fullLoader.parseTree();
+	BOOST_TEST_REQUIRE(fullRoot.children.size() == 2);
+	BOOST_TEST(fullRoot.children[0].children.size() == area.children.size());
+	BOOST_TEST(getProps(fullLoader, fullRoot.children[0].children[1]) == "t2");
+}
+
+BOOST_AUTO_TEST_CASE(test_ChildCursor_truncated)
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "test_fileloader_truncated.otb").string();
+	std::ofstream{path, std::ios::binary} << tree.substr(0, tree.size() - 6);
+
+	OTB::Loader loader{path, OTB::Identifier{{'T', 'E', 'S', 'T'}}};
+	OTB::ChildCursor cursor{loader, loader.parseRoot()};
+	OTB::Node area, towns;
+	BOOST_TEST_REQUIRE(cursor.next(area));
+	BOOST_CHECK_THROW(cursor.next(towns), OTB::InvalidOTBFormat);
+}
@@ -0,0 +1,60 @@
+#define BOOST_TEST_MODULE flowfield
+
+#include "../otpch.h"
+
+#include "../map.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(test_FlowField_open_ground)
+{
+	FlowField field;
+	field.build(Position(100, 100, 7), 3, [](uint16_t, uint16_t) { return 0; });
+
+	BOOST_TEST(field.isValidFor(Position(100, 100, 7)));
+	BOOST_TEST(field.getCost(Position(100, 100, 7)) == 0);
+	BOOST_TEST(field.getCost(Position(101, 100, 7)) == MAP_NORMALWALKCOST);
+	// a diagonal step costs more than two straight ones, same as in getPathMatching
+	BOOST_TEST(field.getCost(Position(101, 101, 7)) == MAP_NORMALWALKCOST * 2);
+	BOOST_TEST(field.getCost(Position(102, 101, 7)) == MAP_NORMALWALKCOST * 3);
+	BOOST_TEST(field.getCost(Position(103, 100, 7)) == MAP_NORMALWALKCOST * 3);
+
+	// outside the radius or on another floor
+	BOOST_TEST(field.getCost(Position(104, 100, 7)) == FlowField::UNREACHABLE);
+	BOOST_TEST(field.getCost(Position(100, 100, 6)) == FlowField::UNREACHABLE);
+}
+
+BOOST_AUTO_TEST_CASE(test_FlowField_walls_and_fields)
+{
+	// a wall at x = 101 with a single gap at y = 103, and a field at (102, 100)
+	FlowField field;
+	field.build(Position(100, 100, 7), 4, [](uint16_t x, uint16_t y) {
+		if (x == 101 && y != 103) {
+			return -1;
+		}
+		return x == 102 && y == 100 ? MAP_NORMALWALKCOST * 18 : 0;
+	});
+
+	BOOST_TEST(field.getCost(Position(101, 100, 7)) == FlowField::UNREACHABLE);
+	BOOST_TEST(field.getCost(Position(101, 103, 7)) == MAP_NORMALWALKCOST * 4);
+	BOOST_TEST(field.getCost(Position(102, 103, 7)) == MAP_NORMALWALKCOST * 5);
+
+	// standing on the field is free, walking across it is not
+	BOOST_TEST(field.getCost(Position(102, 100, 7)) == MAP_NORMALWALKCOST * 8);
+	BOOST_TEST(field.getCost(Position(103, 100, 7)) == MAP_NORMALWALKCOST * 9);
+}
+
+BOOST_AUTO_TEST_CASE(test_FlowField_invalidate)
+{
+	FlowField field;
+	BOOST_TEST(!field.isValid());
+
+	field.build(Position(100, 100, 7), 2, [](uint16_t, uint16_t) { return 0; });
+	BOOST_TEST(field.isValidFor(Position(100, 100, 7)));
+	BOOST_TEST(!field.isValidFor(Position(101, 100, 7)));
+	BOOST_TEST(field.covers(Position(102, 98, 7)));
+	BOOST_TEST(!field.covers(Position(103, 100, 7)));
+
+	field.invalidate();
+	BOOST_TEST(!field.isValidFor(Position(100, 100, 7)));
+}
@@ -0,0 +1,114 @@
+#define BOOST_TEST_MODULE map
+
+#include "../otpch.h"
+
+#include "../map.h"
+#include "../tile.h"
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+constexpr int32_t viewportWidth = Map::maxClientViewportX * 2 + 2;
+constexpr int32_t viewportHeight = Map::maxClientViewportY * 2 + 2;
+
+struct MapFixture
+{
+	MapFixture()
+	{
+		// a few floors of a 128x128 area with holes, plus tiles at the corners of the map
+		for (uint16_t x = 1000; x < 1128; ++x) {
+			for (uint16_t y = 1000; y < 1128; ++y) {
+				for (uint8_t z = 5; z <= 8; ++z) {
+					if ((x * 7 + y * 3 + z) % 5 != 0) {
+						map.setTile(x, y, z, new StaticTile(x, y, z));
+					}
+				}
+			}
+		}
+
+		map.setTile(0, 0, 7, new StaticTile(0, 0, 7));
+		map.setTile(0xFFFF, 0xFFFF, 7, new StaticTile(0xFFFF, 0xFFFF, 7));
+	}
+
+	void checkArea(int32_t x, int32_t y, uint8_t z, int32_t width, int32_t height) const
+	{
+		std::vector<Tile*> tiles(width * height, reinterpret_cast<Tile*>(1));
+		map.getFloorTiles(x, y, z, width, height, tiles.data());
+
+		for (int32_t nx = 0; nx < width; ++nx) {
+			for (int32_t ny = 0; ny < height; ++ny) {
+				int32_t tx = x + nx, ty = y + ny;
+				Tile* expected = tx >= 0 && ty >= 0 && tx <= 0xFFFF && ty <= 0xFFFF ? map.getTile(tx, ty, z) : nullptr;
+				BOOST_TEST(tiles[nx * height + ny] == expected);
+			}
+		}
+	}
+
+	Map map;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(test_getFloorTiles_matches_getTile, MapFixture)
+{
+	// aligned and unaligned to the 8x8 blocks, across the edges of the filled area
+	checkArea(1000, 1000, 7, viewportWidth, viewportHeight);
+	checkArea(1003, 1005, 7, viewportWidth, viewportHeight);
+	checkArea(995, 990, 6, viewportWidth, viewportHeight);
+	checkArea(1120, 1122, 8, viewportWidth, viewportHeight);
+	checkArea(1050, 1050, 5, viewportWidth, 1);
+	checkArea(1050, 1050, 5, 1, viewportHeight);
+
+	// floors without tiles and past the last one
+	checkArea(1000, 1000, 0, viewportWidth, viewportHeight);
+	checkArea(1000, 1000, MAP_MAX_LAYERS, viewportWidth, viewportHeight);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_getFloorTiles_map_edges, MapFixture)
+{
+	checkArea(-9, -7, 7, viewportWidth, viewportHeight);
+	checkArea(0xFFFF - 8, 0xFFFF - 6, 7, viewportWidth, viewportHeight);
+	checkArea(-100, -100, 7, viewportWidth, viewportHeight);
+}
+
+BOOST_FIXTURE_TEST_CASE(benchmark_map_description, MapFixture)
+{
+	// the tiles read for full map descriptions of the surface floors, one per tile and one per block
+	constexpr int iterations = 20000;
+	using namespace std::chrono;
+
+	size_t perTile = 0;
+	auto start = steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		int32_t x = 1000 + i % 100, y = 1000 + (i / 100) % 100;
+		for (int32_t z = 7; z >= 0; --z) {
+			int32_t offset = 7 - z;
+			for (int32_t nx = 0; nx < viewportWidth; ++nx) {
+				for (int32_t ny = 0; ny < viewportHeight; ++ny) {
+					perTile += map.getTile(x + nx + offset, y + ny + offset, z) != nullptr;
+				}
+			}
+		}
+	}
+	auto perTileTime = duration_cast<microseconds>(steady_clock::now() - start);
+
+	size_t perBlock = 0;
+	std::array<Tile*, viewportWidth * viewportHeight> tiles;
+	start = steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		int32_t x = 1000 + i % 100, y = 1000 + (i / 100) % 100;
+		for (int32_t z = 7; z >= 0; --z) {
+			int32_t offset = 7 - z;
+			map.getFloorTiles(x + offset, y + offset, z, viewportWidth, viewportHeight, tiles.data());
+			for (Tile* tile : tiles) {
+				perBlock += tile != nullptr;
+			}
+		}
+	}
+	auto perBlockTime = duration_cast<microseconds>(steady_clock::now() - start);
+
+	BOOST_TEST(perTile == perBlock);
+	BOOST_TEST_MESSAGE(iterations << " map descriptions: getTile " << perTileTime.count() << " us, getFloorTiles "
+	                               << perBlockTime.count() << " us");
+}
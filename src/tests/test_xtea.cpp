@@ -42,3 +42,94 @@ BOOST_AUTO_TEST_CASE(test_xtea_decrypt)
 
 	BOOST_TEST(data == expected);
 }
+
+namespace {
+
+// one block at a time, as the protocol did before the blocks were processed in parallel
+void reference_encrypt(uint8_t* data, size_t length, const xtea::round_keys& k)
+{
+	for (auto it = data, last = data + length; it < last; it += 8) {
+		uint32_t left = it[0] | it[1] << 8 | it[2] << 16 | it[3] << 24;
+		uint32_t right = it[4] | it[5] << 8 | it[6] << 16 | it[7] << 24;
+		for (auto i = 0u; i < k.size(); i += 2) {
+			left += ((right << 4 ^ right >> 5) + right) ^ k[i];
+			right += ((left << 4 ^ left >> 5) + left) ^ k[i + 1];
+		}
+
+		for (int j = 0; j < 4; ++j) {
+			it[j] = static_cast<uint8_t>(left >> (j * 8));
+			it[j + 4] = static_cast<uint8_t>(right >> (j * 8));
+		}
+	}
+}
+
+std::vector<uint8_t> random_bytes(std::mt19937& gen, size_t length)
+{
+	std::uniform_int_distribution<uint32_t> dist(0, 0xFF);
+	std::vector<uint8_t> data(length);
+	std::generate(data.begin(), data.end(), [&]() { return static_cast<uint8_t>(dist(gen)); });
+	return data;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_xtea_matches_reference)
+{
+	std::mt19937 gen(7);
+	auto k = xtea::expand_key({static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen())});
+
+	// every split between the 8 and 4 block paths and the single blocks left over
+	for (size_t blocks = 0; blocks <= 40; ++blocks) {
+		auto plain = random_bytes(gen, blocks * 8);
+
+		auto expected = plain;
+		reference_encrypt(expected.data(), expected.size(), k);
+
+		auto data = plain;
+		xtea::encrypt(data.data(), data.size(), k);
+		BOOST_TEST(data == expected, "encrypt " << blocks << " blocks");
+
+		xtea::decrypt(data.data(), data.size(), k);
+		BOOST_TEST(data == plain, "decrypt " << blocks << " blocks");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_xtea_unaligned)
+{
+	std::mt19937 gen(11);
+	auto k = xtea::expand_key({static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen())});
+
+	auto buffer = random_bytes(gen, 8 * 19 + 3);
+	auto expected = buffer;
+	reference_encrypt(expected.data() + 3, 8 * 19, k);
+
+	xtea::encrypt(buffer.data() + 3, 8 * 19, k);
+	BOOST_TEST(buffer == expected);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_xtea_throughput)
+{
+	using namespace std::chrono;
+
+	std::mt19937 gen(13);
+	auto k = xtea::expand_key({static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen())});
+	// the size of a full network message
+	auto data = random_bytes(gen, 24576);
+	constexpr int iterations = 2000;
+
+	auto start = steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		xtea::encrypt(data.data(), data.size(), k);
+	}
+	auto encryptTime = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+	start = steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		xtea::decrypt(data.data(), data.size(), k);
+	}
+	auto decryptTime = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+	auto megabytes = static_cast<double>(data.size()) * iterations / (1024 * 1024);
+	BOOST_TEST_MESSAGE("xtea encrypt " << megabytes * 1e6 / std::max<int64_t>(encryptTime, 1) << " MB/s, decrypt "
+	                                   << megabytes * 1e6 / std::max<int64_t>(decryptTime, 1) << " MB/s");
+}
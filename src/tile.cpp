@@ -20,6 +20,8 @@
 extern Game g_game;
 extern MoveEvents* g_moveEvents;
 
+std::atomic<uint32_t> Tile::lastVersion{0};
+
 StaticTile real_nullptr_tile(0xFFFF, 0xFFFF, 0xFF);
 Tile& Tile::nullptr_tile = real_nullptr_tile;
 
@@ -349,6 +351,8 @@ Thing* Tile::getTopVisibleThing(const Creature* creature)
 
 void Tile::onAddTileItem(Item* item)
 {
+	updateVersion();
+
 	if (item->hasProperty(CONST_PROP_MOVEABLE) || item->getContainer()) {
 		auto it = g_game.browseFields.find(this);
 		if (it != g_game.browseFields.end()) {
@@ -386,6 +390,8 @@ void Tile::onAddTileItem(Item* item)
 
 void Tile::onUpdateTileItem(Item* oldItem, const ItemType& oldType, Item* newItem, const ItemType& newType)
 {
+	updateVersion();
+
 	if (newItem->hasProperty(CONST_PROP_MOVEABLE) || newItem->getContainer()) {
 		auto it = g_game.browseFields.find(this);
 		if (it != g_game.browseFields.end()) {
@@ -424,6 +430,8 @@ void Tile::onUpdateTileItem(Item* oldItem, const ItemType& oldType, Item* newIte
 
 void Tile::onRemoveTileItem(const SpectatorVec& spectators, const std::vector<int32_t>& oldStackPosVector, Item* item)
 {
+	updateVersion();
+
 	if (item->hasProperty(CONST_PROP_MOVEABLE) || item->getContainer()) {
 		auto it = g_game.browseFields.find(this);
 		if (it != g_game.browseFields.end()) {
@@ -472,6 +480,8 @@ void Tile::onRemoveTileItem(const SpectatorVec& spectators, const std::vector<in
 
 void Tile::onUpdateTile(const SpectatorVec& spectators)
 {
+	updateVersion();
+
 	const Position& cylinderMapPos = getPosition();
 
 	// send to clients
@@ -841,9 +851,9 @@ void Tile::addThing(int32_t, Thing* thing)
 {
 	Creature* creature = thing->getCreature();
 	if (creature) {
-		g_game.map.clearSpectatorCache();
+		g_game.map.clearSpectatorCache(tilePos);
 		if (creature->getPlayer()) {
-			g_game.map.clearPlayersSpectatorCache();
+			g_game.map.clearPlayersSpectatorCache(tilePos);
 		}
 
 		creature->setParent(this);
@@ -1052,9 +1062,9 @@ void Tile::removeThing(Thing* thing, uint32_t count)
 		if (creatures) {
 			auto it = std::find(creatures->begin(), creatures->end(), thing);
 			if (it != creatures->end()) {
-				g_game.map.clearSpectatorCache();
+				g_game.map.clearSpectatorCache(tilePos);
 				if (creature->getPlayer()) {
-					g_game.map.clearPlayersSpectatorCache();
+					g_game.map.clearPlayersSpectatorCache(tilePos);
 				}
 
 				creatures->erase(it);
@@ -1426,9 +1436,9 @@ void Tile::internalAddThing(uint32_t, Thing* thing)
 
 	Creature* creature = thing->getCreature();
 	if (creature) {
-		g_game.map.clearSpectatorCache();
+		g_game.map.clearSpectatorCache(tilePos);
 		if (creature->getPlayer()) {
-			g_game.map.clearPlayersSpectatorCache();
+			g_game.map.clearPlayersSpectatorCache(tilePos);
 		}
 
 		CreatureVector* creatures = makeCreatures();
@@ -1439,6 +1449,8 @@ void Tile::internalAddThing(uint32_t, Thing* thing)
 			return;
 		}
 
+		updateVersion();
+
 		const ItemType& itemType = Item::items[item->getID()];
 		if (itemType.isGroundTile()) {
 			if (!ground) {
@@ -1477,6 +1489,8 @@ void Tile::internalAddThing(uint32_t, Thing* thing)
 
 void Tile::setTileFlags(const Item* item)
 {
+	const uint32_t oldFlags = flags;
+
 	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
 		const ItemType& it = Item::items[item->getID()];
 		if (it.floorChange != 0) {
@@ -1532,10 +1546,16 @@ void Tile::setTileFlags(const Item* item)
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if ((oldFlags ^ flags) & TILESTATE_FLOWFIELD) {
+		g_game.map.clearFlowFields(tilePos);
+	}
 }
 
 void Tile::resetTileFlags(const Item* item)
 {
+	const uint32_t oldFlags = flags;
+
 	const ItemType& it = Item::items[item->getID()];
 	if (it.floorChange != 0) {
 		resetFlag(TILESTATE_FLOORCHANGE);
@@ -1594,6 +1614,10 @@ void Tile::resetTileFlags(const Item* item)
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if ((oldFlags ^ flags) & TILESTATE_FLOWFIELD) {
+		g_game.map.clearFlowFields(tilePos);
+	}
 }
 
 bool Tile::isMoveableBlocking() const { return !ground || hasFlag(TILESTATE_BLOCKSOLID); }
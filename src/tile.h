@@ -51,6 +51,11 @@ enum tileflags_t : uint32_t
 	TILESTATE_FLOORCHANGE = TILESTATE_FLOORCHANGE_DOWN | TILESTATE_FLOORCHANGE_NORTH | TILESTATE_FLOORCHANGE_SOUTH |
 	                        TILESTATE_FLOORCHANGE_EAST | TILESTATE_FLOORCHANGE_WEST | TILESTATE_FLOORCHANGE_SOUTH_ALT |
 	                        TILESTATE_FLOORCHANGE_EAST_ALT,
+
+	// flags the monster flow fields are built from
+	TILESTATE_FLOWFIELD = TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_MAGICFIELD | TILESTATE_BLOCKSOLID |
+	                      TILESTATE_IMMOVABLEBLOCKSOLID | TILESTATE_IMMOVABLENOFIELDBLOCKPATH |
+	                      TILESTATE_NOFIELDBLOCKPATH,
 };
 
 enum ZoneType_t
@@ -234,9 +239,19 @@ public:
 	Item* getUseItem(int32_t index) const;
 
 	Item* getGround() const { return ground; }
-	void setGround(Item* item) { ground = item; }
+	void setGround(Item* item)
+	{
+		ground = item;
+		updateVersion();
+	}
+
+	// changes whenever the items of the tile do, and is never the same for two tiles
+	uint32_t getVersion() const { return version; }
 
 private:
+	// called by the notifications of item changes, before the change is sent to the spectators
+	void updateVersion() { version = lastVersion.fetch_add(1, std::memory_order_relaxed) + 1; }
+
 	void onAddTileItem(Item* item);
 	void onUpdateTileItem(Item* oldItem, const ItemType& oldType, Item* newItem, const ItemType& newType);
 	void onRemoveTileItem(const SpectatorVec& spectators, const std::vector<int32_t>& oldStackPosVector, Item* item);
@@ -245,9 +260,13 @@ private:
 	void setTileFlags(const Item* item);
 	void resetTileFlags(const Item* item);
 
+	// tiles are also created by the map loader threads
+	static std::atomic<uint32_t> lastVersion;
+
 	Item* ground = nullptr;
 	Position tilePos;
 	uint32_t flags = 0;
+	uint32_t version = lastVersion.fetch_add(1, std::memory_order_relaxed) + 1;
 };
 
 // Used for walkable tiles, where there is high likeliness of
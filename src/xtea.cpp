@@ -7,8 +7,176 @@
 
 #include <cstring>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define XTEA_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// compiled for AVX2 regardless of the target flags, used only when the CPU has it
+#define XTEA_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
 namespace xtea {
 
+namespace {
+
+constexpr size_t block_size = 8;
+
+void encrypt_blocks(uint8_t* data, size_t blocks, const round_keys& k)
+{
+	for (auto it = data, last = data + blocks * block_size; it < last; it += block_size) {
+		uint32_t left, right;
+		std::memcpy(&left, it, 4);
+		std::memcpy(&right, it + 4, 4);
+
+		for (auto i = 0u; i < k.size(); i += 2) {
+			left += ((right << 4 ^ right >> 5) + right) ^ k[i];
+			right += ((left << 4 ^ left >> 5) + left) ^ k[i + 1];
+		}
+
+		std::memcpy(it, &left, 4);
+		std::memcpy(it + 4, &right, 4);
+	}
+}
+
+void decrypt_blocks(uint8_t* data, size_t blocks, const round_keys& k)
+{
+	for (auto it = data, last = data + blocks * block_size; it < last; it += block_size) {
+		uint32_t left, right;
+		std::memcpy(&left, it, 4);
+		std::memcpy(&right, it + 4, 4);
+
+		for (auto i = k.size(); i > 0; i -= 2) {
+			right -= ((left << 4 ^ left >> 5) + left) ^ k[i - 1];
+			left -= ((right << 4 ^ right >> 5) + right) ^ k[i - 2];
+		}
+
+		std::memcpy(it, &left, 4);
+		std::memcpy(it + 4, &right, 4);
+	}
+}
+
+#ifdef XTEA_SSE2
+// 4 blocks at a time, the left and right halves of each block in separate lanes
+
+inline __m128i mix(__m128i v) { return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v); }
+
+inline void load_sse2(const uint8_t* it, __m128i& left, __m128i& right)
+{
+	__m128 a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it)));
+	__m128 b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it + 16)));
+	left = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+	right = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+inline void store_sse2(uint8_t* it, __m128i left, __m128i right)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(it), _mm_unpacklo_epi32(left, right));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(it + 16), _mm_unpackhi_epi32(left, right));
+}
+
+size_t encrypt_sse2(uint8_t* data, size_t blocks, const round_keys& k)
+{
+	size_t done = 0;
+	for (; done + 4 <= blocks; done += 4) {
+		uint8_t* it = data + done * block_size;
+		__m128i left, right;
+		load_sse2(it, left, right);
+
+		for (auto i = 0u; i < k.size(); i += 2) {
+			left = _mm_add_epi32(left, _mm_xor_si128(mix(right), _mm_set1_epi32(k[i])));
+			right = _mm_add_epi32(right, _mm_xor_si128(mix(left), _mm_set1_epi32(k[i + 1])));
+		}
+
+		store_sse2(it, left, right);
+	}
+	return done;
+}
+
+size_t decrypt_sse2(uint8_t* data, size_t blocks, const round_keys& k)
+{
+	size_t done = 0;
+	for (; done + 4 <= blocks; done += 4) {
+		uint8_t* it = data + done * block_size;
+		__m128i left, right;
+		load_sse2(it, left, right);
+
+		for (auto i = k.size(); i > 0; i -= 2) {
+			right = _mm_sub_epi32(right, _mm_xor_si128(mix(left), _mm_set1_epi32(k[i - 1])));
+			left = _mm_sub_epi32(left, _mm_xor_si128(mix(right), _mm_set1_epi32(k[i - 2])));
+		}
+
+		store_sse2(it, left, right);
+	}
+	return done;
+}
+#endif
+
+#ifdef XTEA_AVX2
+// 8 blocks at a time, the halves are split within each 128-bit lane and joined back the same way
+
+__attribute__((target("avx2"))) inline __m256i mix(__m256i v)
+{
+	return _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v, 4), _mm256_srli_epi32(v, 5)), v);
+}
+
+__attribute__((target("avx2"))) inline void load_avx2(const uint8_t* it, __m256i& left, __m256i& right)
+{
+	__m256 a = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(it)));
+	__m256 b = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(it + 32)));
+	left = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+	right = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+__attribute__((target("avx2"))) inline void store_avx2(uint8_t* it, __m256i left, __m256i right)
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(it), _mm256_unpacklo_epi32(left, right));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(it + 32), _mm256_unpackhi_epi32(left, right));
+}
+
+__attribute__((target("avx2"))) size_t encrypt_avx2(uint8_t* data, size_t blocks, const round_keys& k)
+{
+	size_t done = 0;
+	for (; done + 8 <= blocks; done += 8) {
+		uint8_t* it = data + done * block_size;
+		__m256i left, right;
+		load_avx2(it, left, right);
+
+		for (auto i = 0u; i < k.size(); i += 2) {
+			left = _mm256_add_epi32(left, _mm256_xor_si256(mix(right), _mm256_set1_epi32(k[i])));
+			right = _mm256_add_epi32(right, _mm256_xor_si256(mix(left), _mm256_set1_epi32(k[i + 1])));
+		}
+
+		store_avx2(it, left, right);
+	}
+	return done;
+}
+
+__attribute__((target("avx2"))) size_t decrypt_avx2(uint8_t* data, size_t blocks, const round_keys& k)
+{
+	size_t done = 0;
+	for (; done + 8 <= blocks; done += 8) {
+		uint8_t* it = data + done * block_size;
+		__m256i left, right;
+		load_avx2(it, left, right);
+
+		for (auto i = k.size(); i > 0; i -= 2) {
+			right = _mm256_sub_epi32(right, _mm256_xor_si256(mix(left), _mm256_set1_epi32(k[i - 1])));
+			left = _mm256_sub_epi32(left, _mm256_xor_si256(mix(right), _mm256_set1_epi32(k[i - 2])));
+		}
+
+		store_avx2(it, left, right);
+	}
+	return done;
+}
+
+// checked during static initialization, which may run before the runtime fills in the CPU features itself
+const bool has_avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+#endif
+
+} // namespace
+
 round_keys expand_key(const key& k)
 {
 	constexpr uint32_t delta = 0x9E3779B9;
@@ -25,36 +193,33 @@ round_keys expand_key(const key& k)
 
 void encrypt(uint8_t* data, size_t length, const round_keys& k)
 {
-	for (auto i = 0u; i < k.size(); i += 2) {
-		for (auto it = data, last = data + length; it < last; it += 8) {
-			uint32_t left, right;
-			std::memcpy(&left, it, 4);
-			std::memcpy(&right, it + 4, 4);
-
-			left += ((right << 4 ^ right >> 5) + right) ^ k[i];
-			right += ((left << 4 ^ left >> 5) + left) ^ k[i + 1];
-
-			std::memcpy(it, &left, 4);
-			std::memcpy(it + 4, &right, 4);
-		}
+	// blocks are independent, the widest implementation takes as many as it can and leaves the rest to the next
+	size_t blocks = length / block_size;
+	size_t done = 0;
+#ifdef XTEA_AVX2
+	if (has_avx2) {
+		done = encrypt_avx2(data, blocks, k);
 	}
+#endif
+#ifdef XTEA_SSE2
+	done += encrypt_sse2(data + done * block_size, blocks - done, k);
+#endif
+	encrypt_blocks(data + done * block_size, blocks - done, k);
 }
 
 void decrypt(uint8_t* data, size_t length, const round_keys& k)
 {
-	for (auto i = k.size(); i > 0; i -= 2) {
-		for (auto it = data, last = data + length; it < last; it += 8) {
-			uint32_t left, right;
-			std::memcpy(&left, it, 4);
-			std::memcpy(&right, it + 4, 4);
-
-			right -= ((left << 4 ^ left >> 5) + left) ^ k[i - 1];
-			left -= ((right << 4 ^ right >> 5) + right) ^ k[i - 2];
-
-			std::memcpy(it, &left, 4);
-			std::memcpy(it + 4, &right, 4);
-		}
+	size_t blocks = length / block_size;
+	size_t done = 0;
+#ifdef XTEA_AVX2
+	if (has_avx2) {
+		done = decrypt_avx2(data, blocks, k);
 	}
+#endif
+#ifdef XTEA_SSE2
+	done += decrypt_sse2(data + done * block_size, blocks - done, k);
+#endif
+	decrypt_blocks(data + done * block_size, blocks - done, k);
 }
 
 } // namespace xtea